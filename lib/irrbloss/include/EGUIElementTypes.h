@@ -68,6 +68,9 @@ enum EGUI_ELEMENT_TYPE {
 	//! The root of the GUI
 	EGUIET_ROOT,
 
+	//! A list box which reads its rows from a source (IGUIVirtualList)
+	EGUIET_VIRTUAL_LIST,
+
 	//! Not an element, amount of elements in there
 	EGUIET_COUNT,
 
@@ -20,6 +20,9 @@ namespace io
 		//! CMemoryReadFile
 		ERFT_MEMORY_READ_FILE = MAKE_IRR_ID('r','m','e','m'),
 
+		//! CMappedReadFile, which is also an IMemoryReadFile
+		ERFT_MAPPED_READ_FILE = MAKE_IRR_ID('r','m','a','p'),
+
 		//! Unknown type
 		EFIT_UNKNOWN        = MAKE_IRR_ID('u','n','k','n')
 	};
@@ -38,6 +38,8 @@ class IGUIScrollBar;
 class IGUIImage;
 class IGUICheckBox;
 class IGUIListBox;
+class IGUIVirtualList;
+class IGUIVirtualListSource;
 class IGUIImageList;
 class IGUIStaticText;
 class IGUIEditBox;
@@ -327,6 +329,20 @@ public:
 	virtual IGUIListBox* addListBox(const core::rect<s32>& rectangle,
 		IGUIElement* parent=0, s32 id=-1, bool drawBackground=false) = 0;
 
+	//! Adds a virtual list element.
+	/** \param rectangle Rectangle specifying the borders of the list.
+	\param source Where the rows come from. Not owned by the list, see
+	IGUIVirtualList::setSource().
+	\param parent Parent gui element of the list.
+	\param id Id to identify the gui element.
+	\param drawBackground Flag whether the background should be drawn.
+	\return Pointer to the created list. Returns 0 if an error occurred.
+	This pointer should not be dropped. See IReferenceCounted::drop() for
+	more information. */
+	virtual IGUIVirtualList* addVirtualList(const core::rect<s32>& rectangle,
+		IGUIVirtualListSource* source=0, IGUIElement* parent=0, s32 id=-1,
+		bool drawBackground=false) = 0;
+
 	//! Adds a static text.
 	/** \param text Text to be displayed. Can be altered after creation by SetText().
 	\param rectangle Rectangle specifying the borders of the static text
@@ -0,0 +1,95 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_GUI_VIRTUAL_LIST_H_INCLUDED__
+#define __I_GUI_VIRTUAL_LIST_H_INCLUDED__
+
+#include "IGUIElement.h"
+#include "irrString.h"
+
+namespace irr {
+namespace gui
+{
+	class IGUIScrollBar;
+
+	//! Supplies the rows of a virtual list.
+	/** The list only asks for the rows it is about to draw, so the source
+	can keep its data in whatever form it likes. */
+	class IGUIVirtualListSource
+	{
+	public:
+		virtual ~IGUIVirtualListSource() {}
+
+		//! Returns the number of rows
+		virtual u32 getRowCount() const = 0;
+
+		//! Returns the text of a row, from 0 to getRowCount()-1
+		virtual core::stringw getRowText(u32 row) const = 0;
+	};
+
+
+	//! A list box which does not store its items.
+	/** Rows are read from an IGUIVirtualListSource when they scroll into
+	view, and only the visible rows are drawn, so a list of many thousands
+	of rows costs no more to draw or refresh than a short one. The list
+	keeps the text of the rows it has shown until refresh() or updateRow()
+	is called.
+
+	\par This element can create the following events of type EGUI_EVENT_TYPE:
+	\li EGET_LISTBOX_CHANGED
+	\li EGET_LISTBOX_SELECTED_AGAIN
+	*/
+	class IGUIVirtualList : public IGUIElement
+	{
+	public:
+		//! constructor
+		IGUIVirtualList(IGUIEnvironment* environment, IGUIElement* parent, s32 id, core::rect<s32> rectangle)
+			: IGUIElement(EGUIET_VIRTUAL_LIST, environment, parent, id, rectangle) {}
+
+		//! Sets where the rows come from.
+		/** The source is not owned by the list, and must outlive it or be
+		replaced first. Set to 0 for an empty list. */
+		virtual void setSource(IGUIVirtualListSource* source) = 0;
+
+		//! Returns the source of the rows
+		virtual IGUIVirtualListSource* getSource() const = 0;
+
+		//! Reads the number of rows again, and forgets the text of every row.
+		/** Call after rows were added, removed or reordered. */
+		virtual void refresh() = 0;
+
+		//! Forgets the text of one row, so it is read again when drawn
+		virtual void updateRow(u32 row) = 0;
+
+		//! Returns the number of rows, as of the last refresh
+		virtual u32 getRowCount() const = 0;
+
+		//! get the the row at the given absolute coordinates
+		/** \return The row or -1 when no row is at those coordinates */
+		virtual s32 getRowAt(s32 xpos, s32 ypos) const = 0;
+
+		//! returns the selected row. returns -1 if no row is selected.
+		virtual s32 getSelected() const = 0;
+
+		//! sets the selected row. Set this to -1 if no row should be selected
+		virtual void setSelected(s32 row) = 0;
+
+		//! set whether the list should scroll to newly selected rows
+		virtual void setAutoScrollEnabled(bool scroll) = 0;
+
+		//! set the height of every row
+		virtual void setItemHeight(s32 height) = 0;
+
+		//! Sets whether to draw the background
+		virtual void setDrawBackground(bool draw) = 0;
+
+		//! Access the vertical scrollbar
+		virtual IGUIScrollBar* getVerticalScrollBar() const = 0;
+	};
+
+
+} // end namespace gui
+} // end namespace irr
+
+#endif
@@ -23,6 +23,14 @@ namespace io
 		*/
 		virtual const void *getBuffer() const = 0;
 	};
+
+	//! Opens a file on disk through a read only memory mapping
+	/** getBuffer() then gives the whole file in place, without reading it
+	first.
+	\param fileName Name of the file to map.
+	\return The file, or 0 if it can't be mapped, which includes empty
+	files. Drop it when done. */
+	IRRLICHT_API IMemoryReadFile* IRRCALLCONV createMappedReadFile(const path& fileName);
 } // end namespace io
 } // end namespace irr
 
@@ -55,6 +55,24 @@ namespace scene {
 		virtual bool getCollisionPoint(SCollisionHit& hitResult, const core::line3d<f32>& ray,
 				ITriangleSelector* selector) = 0;
 
+		//! Finds the nearest collision point of each of several lines with lots of triangles.
+		/** Cheaper than calling getCollisionPoint() for each line, as the
+		triangles are gathered once, from a box around all the lines, and
+		each line is tested against several triangles at a time. Works
+		best for lines close to each other, like the rays through
+		neighbouring pixels.
+		\param hitResults: Array of count results. Each is set when its
+		line collides with something, and left alone otherwise.
+		\param outHits: Array of count flags, set to whether each line
+		collides with something.
+		\param rays: Array of count lines with which collisions are tested.
+		\param count: Number of lines.
+		\param selector: TriangleSelector to be used for the collision check.
+		\return Number of lines which collide with something. */
+		virtual u32 getCollisionPoints(SCollisionHit* hitResults, bool* outHits,
+				const core::line3d<f32>* rays, u32 count,
+				ITriangleSelector* selector) = 0;
+
 		//! Finds the nearest collision point of a line and lots of triangles, if there is one.
 		/** \param ray: Line with which collisions are tested.
 		\param selector: TriangleSelector containing the triangles. It
@@ -77,6 +77,7 @@
 #include "IGUISpriteBank.h"
 #include "IGUIStaticText.h"
 #include "IGUIToolbar.h"
+#include "IGUIVirtualList.h"
 #include "IGUIWindow.h"
 #include "IImage.h"
 #include "IImageLoader.h"
@@ -6,6 +6,7 @@
 #define _C_BLIT_H_INCLUDED_
 
 #include "SoftwareDriver2_helper.h"
+#include "CColorConverter.h"
 
 namespace irr {
 
@@ -206,11 +207,7 @@ static void executeBlit_TextureCopy_24_to_16( const SBlitJob * job ) {
 		}
 	} else {
 		for ( u32 dy = 0; dy != h; ++dy ) {
-			const u8* s = src;
-			for ( u32 dx = 0; dx != w; ++dx ) {
-				dst[dx] = video::RGBA16(s[0], s[1], s[2]);
-				s += 3;
-			}
+			video::CColorConverter::convert_R8G8B8toA1R5G5B5(src, w, dst);
 
 			src = src+job->srcPitch;
 			dst = (u16*) ( (u8*) (dst) + job->dstPitch );
@@ -242,9 +239,7 @@ static void executeBlit_TextureCopy_16_to_32( const SBlitJob * job ) {
 		}
 	} else {
 		for ( u32 dy = 0; dy != h; ++dy ) {
-			for ( u32 dx = 0; dx != w; ++dx ) {
-				dst[dx] = video::A1R5G5B5toA8R8G8B8( src[dx] );
-			}
+			video::CColorConverter::convert_A1R5G5B5toA8R8G8B8(src, w, dst);
 
 			src = (u16*) ( (u8*) (src) + job->srcPitch );
 			dst = (u32*) ( (u8*) (dst) + job->dstPitch );
@@ -316,12 +311,7 @@ static void executeBlit_TextureCopy_24_to_32( const SBlitJob * job ) {
 		}
 	} else {
 		for ( u32 dy = 0; dy < job->height; ++dy ) {
-			const u8* s = src;
-
-			for ( u32 dx = 0; dx < job->width; ++dx ) {
-				dst[dx] = 0xFF000000 | s[0] << 16 | s[1] << 8 | s[2];
-				s += 3;
-			}
+			video::CColorConverter::convert_R8G8B8toA8R8G8B8(src, w, dst);
 
 			src = src + job->srcPitch;
 			dst = (u32*) ( (u8*) (dst) + job->dstPitch );
@@ -354,12 +344,7 @@ static void executeBlit_TextureCopy_32_to_24( const SBlitJob * job ) {
 		}
 	} else {
 		for ( u32 dy = 0; dy != h; ++dy ) {
-			for ( u32 dx = 0; dx != w; ++dx ) {
-				u8 * writeTo = &dst[dx * 3];
-				*writeTo++ = (src[dx] >> 16)& 0xFF;
-				*writeTo++ = (src[dx] >> 8) & 0xFF;
-				*writeTo++ = src[dx] & 0xFF;
-			}
+			video::CColorConverter::convert_A8R8G8B8toR8G8B8(src, w, dst);
 
 			src = (u32*) ( (u8*) (src) + job->srcPitch );
 			dst += job->dstPitch;
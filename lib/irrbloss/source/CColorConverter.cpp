@@ -3,6 +3,7 @@
 // For conditions of distribution and use, see copyright notice in irrlicht.h
 
 #include "CColorConverter.h"
+#include "CColorConverterSIMD.h"
 #include "SColor.h"
 #include "os.h"
 #include "irrString.h"
@@ -27,10 +28,11 @@ void CColorConverter::convert_A1R5G5B5toR8G8B8(const void* sP, s32 sN, void* dP)
 
 
 void CColorConverter::convert_A1R5G5B5toA8R8G8B8(const void* sP, s32 sN, void* dP) {
-	u16* sB = (u16*)sP;
-	u32* dB = (u32*)dP;
+	const s32 done = simd::convert_A1R5G5B5toA8R8G8B8(sP, sN, dP);
+	u16* sB = (u16*)sP + done;
+	u32* dB = (u32*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 		*dB++ = A1R5G5B5toA8R8G8B8(*sB++);
 }
 
@@ -47,10 +49,11 @@ void CColorConverter::convert_A1R5G5B5toR5G6B5(const void* sP, s32 sN, void* dP)
 }
 
 void CColorConverter::convert_A8R8G8B8toR8G8B8(const void* sP, s32 sN, void* dP) {
-	u8* sB = (u8*)sP;
-	u8* dB = (u8*)dP;
+	const s32 done = simd::convert_A8R8G8B8toR8G8B8(sP, sN, dP);
+	u8* sB = (u8*)sP + done * 4;
+	u8* dB = (u8*)dP + done * 3;
 
-	for (s32 x = 0; x < sN; ++x) {
+	for (s32 x = done; x < sN; ++x) {
 		// sB[3] is alpha
 		dB[0] = sB[2];
 		dB[1] = sB[1];
@@ -62,10 +65,11 @@ void CColorConverter::convert_A8R8G8B8toR8G8B8(const void* sP, s32 sN, void* dP)
 }
 
 void CColorConverter::convert_A8R8G8B8toB8G8R8(const void* sP, s32 sN, void* dP) {
-	u8* sB = (u8*)sP;
-	u8* dB = (u8*)dP;
+	const s32 done = simd::convert_A8R8G8B8toB8G8R8(sP, sN, dP);
+	u8* sB = (u8*)sP + done * 4;
+	u8* dB = (u8*)dP + done * 3;
 
-	for (s32 x = 0; x < sN; ++x) {
+	for (s32 x = done; x < sN; ++x) {
 		// sB[3] is alpha
 		dB[0] = sB[0];
 		dB[1] = sB[1];
@@ -81,10 +85,11 @@ void CColorConverter::convert_A8R8G8B8toA8R8G8B8(const void* sP, s32 sN, void* d
 }
 
 void CColorConverter::convert_A8R8G8B8toA1R5G5B5(const void* sP, s32 sN, void* dP) {
-	u32* sB = (u32*)sP;
-	u16* dB = (u16*)dP;
+	const s32 done = simd::convert_A8R8G8B8toA1R5G5B5(sP, sN, dP);
+	u32* sB = (u32*)sP + done;
+	u16* dB = (u16*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 		*dB++ = A8R8G8B8toA1R5G5B5(*sB++);
 }
 
@@ -126,10 +131,11 @@ void CColorConverter::convert_R8G8B8toR8G8B8(const void* sP, s32 sN, void* dP) {
 }
 
 void CColorConverter::convert_R8G8B8toA8R8G8B8(const void* sP, s32 sN, void* dP) {
-	u8*  sB = (u8* )sP;
-	u32* dB = (u32*)dP;
+	const s32 done = simd::convert_R8G8B8toA8R8G8B8(sP, sN, dP);
+	u8*  sB = (u8* )sP + done * 3;
+	u32* dB = (u32*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x) {
+	for (s32 x = done; x < sN; ++x) {
 		*dB = 0xff000000 | (sB[0]<<16) | (sB[1]<<8) | sB[2];
 
 		sB += 3;
@@ -138,10 +144,11 @@ void CColorConverter::convert_R8G8B8toA8R8G8B8(const void* sP, s32 sN, void* dP)
 }
 
 void CColorConverter::convert_R8G8B8toA1R5G5B5(const void* sP, s32 sN, void* dP) {
-	u8 * sB = (u8 *)sP;
-	u16* dB = (u16*)dP;
+	const s32 done = simd::convert_R8G8B8toA1R5G5B5(sP, sN, dP);
+	u8 * sB = (u8 *)sP + done * 3;
+	u16* dB = (u16*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x) {
+	for (s32 x = done; x < sN; ++x) {
 		s32 r = sB[0] >> 3;
 		s32 g = sB[1] >> 3;
 		s32 b = sB[2] >> 3;
@@ -154,10 +161,11 @@ void CColorConverter::convert_R8G8B8toA1R5G5B5(const void* sP, s32 sN, void* dP)
 }
 
 void CColorConverter::convert_A8R8G8B8toA8B8G8R8(const void* sP, s32 sN, void* dP) {
-	const u32* sB = (const u32*)sP;
-	u32* dB = (u32*)dP;
+	const s32 done = simd::convert_A8R8G8B8toA8B8G8R8(sP, sN, dP);
+	const u32* sB = (const u32*)sP + done;
+	u32* dB = (u32*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x) {
+	for (s32 x = done; x < sN; ++x) {
 		*dB++ = (*sB&0xff00ff00)|((*sB&0x00ff0000)>>16)|((*sB&0x000000ff)<<16);
 		++sB;
 	}
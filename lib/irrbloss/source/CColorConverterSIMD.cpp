@@ -0,0 +1,526 @@
+// This file is part of Irrbloss, a fork of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CColorConverterSIMD.h"
+#include "SIMDLevel.h"
+
+namespace irr {
+namespace video {
+
+namespace simd {
+
+// Rows shorter than this aren't worth the dispatch
+static const s32 MinPixels = 16;
+
+#ifdef _IRR_SIMD_X86_
+
+// Byte shuffles from three byte pixels to four byte ones and back, four
+// pixels to a register. R8G8B8 is stored R,G,B and A8R8G8B8 as B,G,R,A.
+#define EXPAND_RGB_MASK 2,1,0,-1, 5,4,3,-1, 8,7,6,-1, 11,10,9,-1
+#define SHRINK_RGB_MASK 2,1,0, 6,5,4, 10,9,8, 14,13,12, -1,-1,-1,-1
+#define SHRINK_BGR_MASK 0,1,2, 4,5,6, 8,9,10, 12,13,14, -1,-1,-1,-1
+#define SWAP_RB_MASK 2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15
+
+//
+// SSE2
+//
+
+IRR_TARGET("sse2")
+static inline __m128i to1555_SSE2(__m128i c) {
+	const __m128i a = _mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32((int)0x80000000)), 16);
+	const __m128i r = _mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x00F80000)), 9);
+	const __m128i g = _mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x0000F800)), 6);
+	const __m128i b = _mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x000000F8)), 3);
+	const __m128i v = _mm_or_si128(_mm_or_si128(a, r), _mm_or_si128(g, b));
+	// Sign extend, so that packing with signed saturation keeps all 16 bits
+	return _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+}
+
+IRR_TARGET("sse2")
+static inline __m128i from1555_SSE2(__m128i c) {
+	const __m128i a = _mm_and_si128(_mm_srai_epi32(_mm_slli_epi32(c, 16), 31),
+		_mm_set1_epi32((int)0xFF000000));
+	const __m128i r = _mm_or_si128(
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x7C00)), 9),
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x7000)), 4));
+	const __m128i g = _mm_or_si128(
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x03E0)), 6),
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x0380)), 1));
+	const __m128i b = _mm_or_si128(
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x001F)), 3),
+		_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x001C)), 2));
+	return _mm_or_si128(_mm_or_si128(a, r), _mm_or_si128(g, b));
+}
+
+IRR_TARGET("sse2")
+static s32 A1R5G5B5toA8R8G8B8_SSE2(const void* sP, s32 sN, void* dP) {
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	const __m128i zero = _mm_setzero_si128();
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8) {
+		const __m128i c = _mm_loadu_si128((const __m128i*)(sB + x * 2));
+		_mm_storeu_si128((__m128i*)(dB + x * 4), from1555_SSE2(_mm_unpacklo_epi16(c, zero)));
+		_mm_storeu_si128((__m128i*)(dB + x * 4 + 16), from1555_SSE2(_mm_unpackhi_epi16(c, zero)));
+	}
+	return x;
+}
+
+IRR_TARGET("sse2")
+static s32 A8R8G8B8toA1R5G5B5_SSE2(const void* sP, s32 sN, void* dP) {
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8) {
+		const __m128i lo = to1555_SSE2(_mm_loadu_si128((const __m128i*)(sB + x * 4)));
+		const __m128i hi = to1555_SSE2(_mm_loadu_si128((const __m128i*)(sB + x * 4 + 16)));
+		_mm_storeu_si128((__m128i*)(dB + x * 2), _mm_packs_epi32(lo, hi));
+	}
+	return x;
+}
+
+IRR_TARGET("sse2")
+static s32 A8R8G8B8toA8B8G8R8_SSE2(const void* sP, s32 sN, void* dP) {
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	const __m128i keep = _mm_set1_epi32((int)0xFF00FF00);
+	const __m128i low = _mm_set1_epi32(0xFF);
+	s32 x = 0;
+	for (; x + 4 <= sN; x += 4) {
+		const __m128i c = _mm_loadu_si128((const __m128i*)(sB + x * 4));
+		const __m128i r = _mm_and_si128(_mm_srli_epi32(c, 16), low);
+		const __m128i b = _mm_slli_epi32(_mm_and_si128(c, low), 16);
+		_mm_storeu_si128((__m128i*)(dB + x * 4),
+			_mm_or_si128(_mm_and_si128(c, keep), _mm_or_si128(r, b)));
+	}
+	return x;
+}
+
+//
+// SSSE3
+//
+
+// Expands 16 R8G8B8 pixels at sB into four registers of A8R8G8B8
+IRR_TARGET("ssse3")
+static inline void expandRGB_SSSE3(const u8* sB, __m128i out[4]) {
+	const __m128i mask = _mm_setr_epi8(EXPAND_RGB_MASK);
+	const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+	const __m128i v0 = _mm_loadu_si128((const __m128i*)sB);
+	const __m128i v1 = _mm_loadu_si128((const __m128i*)(sB + 16));
+	const __m128i v2 = _mm_loadu_si128((const __m128i*)(sB + 32));
+	out[0] = _mm_or_si128(_mm_shuffle_epi8(v0, mask), alpha);
+	out[1] = _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(v1, v0, 12), mask), alpha);
+	out[2] = _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(v2, v1, 8), mask), alpha);
+	out[3] = _mm_or_si128(_mm_shuffle_epi8(_mm_srli_si128(v2, 4), mask), alpha);
+}
+
+IRR_TARGET("ssse3")
+static s32 R8G8B8toA8R8G8B8_SSSE3(const void* sP, s32 sN, void* dP) {
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		__m128i c[4];
+		expandRGB_SSSE3(sB + x * 3, c);
+		for (s32 i = 0; i < 4; ++i)
+			_mm_storeu_si128((__m128i*)(dB + x * 4 + i * 16), c[i]);
+	}
+	return x;
+}
+
+IRR_TARGET("ssse3")
+static s32 R8G8B8toA1R5G5B5_SSSE3(const void* sP, s32 sN, void* dP) {
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		__m128i c[4];
+		expandRGB_SSSE3(sB + x * 3, c);
+		_mm_storeu_si128((__m128i*)(dB + x * 2),
+			_mm_packs_epi32(to1555_SSE2(c[0]), to1555_SSE2(c[1])));
+		_mm_storeu_si128((__m128i*)(dB + x * 2 + 16),
+			_mm_packs_epi32(to1555_SSE2(c[2]), to1555_SSE2(c[3])));
+	}
+	return x;
+}
+
+// Drops the alpha of 16 pixels, reordering the rest with mask
+IRR_TARGET("ssse3")
+static s32 shrink_SSSE3(const void* sP, s32 sN, void* dP, __m128i mask) {
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		const u8* s = sB + x * 4;
+		const __m128i a = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)s), mask);
+		const __m128i b = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(s + 16)), mask);
+		const __m128i c = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(s + 32)), mask);
+		const __m128i d = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(s + 48)), mask);
+		u8* t = dB + x * 3;
+		_mm_storeu_si128((__m128i*)t, _mm_or_si128(a, _mm_slli_si128(b, 12)));
+		_mm_storeu_si128((__m128i*)(t + 16), _mm_or_si128(_mm_srli_si128(b, 4), _mm_slli_si128(c, 8)));
+		_mm_storeu_si128((__m128i*)(t + 32), _mm_or_si128(_mm_srli_si128(c, 8), _mm_slli_si128(d, 4)));
+	}
+	return x;
+}
+
+IRR_TARGET("ssse3")
+static s32 A8R8G8B8toR8G8B8_SSSE3(const void* sP, s32 sN, void* dP) {
+	return shrink_SSSE3(sP, sN, dP, _mm_setr_epi8(SHRINK_RGB_MASK));
+}
+
+IRR_TARGET("ssse3")
+static s32 A8R8G8B8toB8G8R8_SSSE3(const void* sP, s32 sN, void* dP) {
+	return shrink_SSSE3(sP, sN, dP, _mm_setr_epi8(SHRINK_BGR_MASK));
+}
+
+IRR_TARGET("ssse3")
+static s32 A8R8G8B8toA8B8G8R8_SSSE3(const void* sP, s32 sN, void* dP) {
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	const __m128i mask = _mm_setr_epi8(SWAP_RB_MASK);
+	s32 x = 0;
+	for (; x + 4 <= sN; x += 4) {
+		const __m128i c = _mm_loadu_si128((const __m128i*)(sB + x * 4));
+		_mm_storeu_si128((__m128i*)(dB + x * 4), _mm_shuffle_epi8(c, mask));
+	}
+	return x;
+}
+
+//
+// AVX2
+//
+
+IRR_TARGET("avx2")
+static inline __m256i to1555_AVX2(__m256i c) {
+	const __m256i a = _mm256_srli_epi32(_mm256_and_si256(c, _mm256_set1_epi32((int)0x80000000)), 16);
+	const __m256i r = _mm256_srli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x00F80000)), 9);
+	const __m256i g = _mm256_srli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x0000F800)), 6);
+	const __m256i b = _mm256_srli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x000000F8)), 3);
+	const __m256i v = _mm256_or_si256(_mm256_or_si256(a, r), _mm256_or_si256(g, b));
+	return _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+}
+
+IRR_TARGET("avx2")
+static s32 A1R5G5B5toA8R8G8B8_AVX2(const void* sP, s32 sN, void* dP) {
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8) {
+		const __m256i c = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(sB + x * 2)));
+		const __m256i a = _mm256_and_si256(_mm256_srai_epi32(_mm256_slli_epi32(c, 16), 31),
+			_mm256_set1_epi32((int)0xFF000000));
+		const __m256i r = _mm256_or_si256(
+			_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x7C00)), 9),
+			_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x7000)), 4));
+		const __m256i g = _mm256_or_si256(
+			_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x03E0)), 6),
+			_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x0380)), 1));
+		const __m256i b = _mm256_or_si256(
+			_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x001F)), 3),
+			_mm256_srli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x001C)), 2));
+		_mm256_storeu_si256((__m256i*)(dB + x * 4),
+			_mm256_or_si256(_mm256_or_si256(a, r), _mm256_or_si256(g, b)));
+	}
+	return x;
+}
+
+IRR_TARGET("avx2")
+static s32 A8R8G8B8toA1R5G5B5_AVX2(const void* sP, s32 sN, void* dP) {
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		const __m256i lo = to1555_AVX2(_mm256_loadu_si256((const __m256i*)(sB + x * 4)));
+		const __m256i hi = to1555_AVX2(_mm256_loadu_si256((const __m256i*)(sB + x * 4 + 32)));
+		// Packing works within each half, which interleaves the pixels
+		const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8);
+		_mm256_storeu_si256((__m256i*)(dB + x * 2), packed);
+	}
+	return x;
+}
+
+IRR_TARGET("avx2")
+static s32 A8R8G8B8toA8B8G8R8_AVX2(const void* sP, s32 sN, void* dP) {
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	const __m256i mask = _mm256_setr_epi8(SWAP_RB_MASK, SWAP_RB_MASK);
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8) {
+		const __m256i c = _mm256_loadu_si256((const __m256i*)(sB + x * 4));
+		_mm256_storeu_si256((__m256i*)(dB + x * 4), _mm256_shuffle_epi8(c, mask));
+	}
+	return x;
+}
+
+// The 24 bit rows below move 24 bytes per step with 32 byte loads or
+// stores, so they stop while at least 11 pixels (33 bytes) are left. The
+// 8 bytes stored past a step are rewritten by the next one or the tail.
+
+IRR_TARGET("avx2")
+static s32 R8G8B8toA8R8G8B8_AVX2(const void* sP, s32 sN, void* dP) {
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	const __m256i mask = _mm256_setr_epi8(EXPAND_RGB_MASK, EXPAND_RGB_MASK);
+	const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+	// Bytes 0-15 to the low half and 12-27 to the high half
+	const __m256i spread = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6);
+	s32 x = 0;
+	for (; x + 11 <= sN; x += 8) {
+		__m256i c = _mm256_loadu_si256((const __m256i*)(sB + x * 3));
+		c = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(c, spread), mask);
+		_mm256_storeu_si256((__m256i*)(dB + x * 4), _mm256_or_si256(c, alpha));
+	}
+	return x;
+}
+
+IRR_TARGET("avx2")
+static s32 shrink_AVX2(const void* sP, s32 sN, void* dP, __m256i mask) {
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	// The 12 bytes of each half together
+	const __m256i gather = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+	s32 x = 0;
+	for (; x + 11 <= sN; x += 8) {
+		__m256i c = _mm256_loadu_si256((const __m256i*)(sB + x * 4));
+		c = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(c, mask), gather);
+		_mm256_storeu_si256((__m256i*)(dB + x * 3), c);
+	}
+	return x;
+}
+
+IRR_TARGET("avx2")
+static s32 A8R8G8B8toR8G8B8_AVX2(const void* sP, s32 sN, void* dP) {
+	return shrink_AVX2(sP, sN, dP, _mm256_setr_epi8(SHRINK_RGB_MASK, SHRINK_RGB_MASK));
+}
+
+IRR_TARGET("avx2")
+static s32 A8R8G8B8toB8G8R8_AVX2(const void* sP, s32 sN, void* dP) {
+	return shrink_AVX2(sP, sN, dP, _mm256_setr_epi8(SHRINK_BGR_MASK, SHRINK_BGR_MASK));
+}
+
+#endif // _IRR_SIMD_X86_
+
+#ifdef _IRR_SIMD_NEON_
+
+static s32 R8G8B8toA8R8G8B8_NEON(const void* sP, s32 sN, void* dP) {
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		const uint8x16x3_t c = vld3q_u8(sB + x * 3);
+		uint8x16x4_t out;
+		out.val[0] = c.val[2];
+		out.val[1] = c.val[1];
+		out.val[2] = c.val[0];
+		out.val[3] = vdupq_n_u8(0xFF);
+		vst4q_u8(dB + x * 4, out);
+	}
+	return x;
+}
+
+static s32 A8R8G8B8toR8G8B8_NEON(const void* sP, s32 sN, void* dP) {
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		const uint8x16x4_t c = vld4q_u8(sB + x * 4);
+		uint8x16x3_t out;
+		out.val[0] = c.val[2];
+		out.val[1] = c.val[1];
+		out.val[2] = c.val[0];
+		vst3q_u8(dB + x * 3, out);
+	}
+	return x;
+}
+
+static s32 A8R8G8B8toB8G8R8_NEON(const void* sP, s32 sN, void* dP) {
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		const uint8x16x4_t c = vld4q_u8(sB + x * 4);
+		uint8x16x3_t out;
+		out.val[0] = c.val[0];
+		out.val[1] = c.val[1];
+		out.val[2] = c.val[2];
+		vst3q_u8(dB + x * 3, out);
+	}
+	return x;
+}
+
+static s32 A8R8G8B8toA8B8G8R8_NEON(const void* sP, s32 sN, void* dP) {
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		uint8x16x4_t c = vld4q_u8(sB + x * 4);
+		const uint8x16_t b = c.val[0];
+		c.val[0] = c.val[2];
+		c.val[2] = b;
+		vst4q_u8(dB + x * 4, c);
+	}
+	return x;
+}
+
+// Packs eight pixels, given as planes of 8 bit channels
+static inline uint16x8_t to1555_NEON(uint8x8_t a, uint8x8_t r, uint8x8_t g, uint8x8_t b) {
+	const uint8x8_t top5 = vdup_n_u8(0xF8);
+	uint16x8_t v = vshll_n_u8(vand_u8(a, vdup_n_u8(0x80)), 8);
+	v = vorrq_u16(v, vshll_n_u8(vand_u8(r, top5), 7));
+	v = vorrq_u16(v, vshll_n_u8(vand_u8(g, top5), 2));
+	return vorrq_u16(v, vmovl_u8(vshr_n_u8(b, 3)));
+}
+
+static s32 A8R8G8B8toA1R5G5B5_NEON(const void* sP, s32 sN, void* dP) {
+	const u8* sB = (const u8*)sP;
+	u16* dB = (u16*)dP;
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		const uint8x16x4_t c = vld4q_u8(sB + x * 4);
+		vst1q_u16(dB + x, to1555_NEON(vget_low_u8(c.val[3]), vget_low_u8(c.val[2]),
+			vget_low_u8(c.val[1]), vget_low_u8(c.val[0])));
+		vst1q_u16(dB + x + 8, to1555_NEON(vget_high_u8(c.val[3]), vget_high_u8(c.val[2]),
+			vget_high_u8(c.val[1]), vget_high_u8(c.val[0])));
+	}
+	return x;
+}
+
+static s32 R8G8B8toA1R5G5B5_NEON(const void* sP, s32 sN, void* dP) {
+	const u8* sB = (const u8*)sP;
+	u16* dB = (u16*)dP;
+	const uint8x8_t a = vdup_n_u8(0xFF);
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16) {
+		const uint8x16x3_t c = vld3q_u8(sB + x * 3);
+		vst1q_u16(dB + x, to1555_NEON(a, vget_low_u8(c.val[0]),
+			vget_low_u8(c.val[1]), vget_low_u8(c.val[2])));
+		vst1q_u16(dB + x + 8, to1555_NEON(a, vget_high_u8(c.val[0]),
+			vget_high_u8(c.val[1]), vget_high_u8(c.val[2])));
+	}
+	return x;
+}
+
+// Widens a 5 bit channel to 8 bits, repeating its top bits at the bottom
+static inline uint8x8_t widen5_NEON(uint8x8_t c) {
+	c = vand_u8(c, vdup_n_u8(0x1F));
+	return vorr_u8(vshl_n_u8(c, 3), vshr_n_u8(c, 2));
+}
+
+static s32 A1R5G5B5toA8R8G8B8_NEON(const void* sP, s32 sN, void* dP) {
+	const u16* sB = (const u16*)sP;
+	u8* dB = (u8*)dP;
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8) {
+		const uint16x8_t c = vld1q_u16(sB + x);
+		uint8x8x4_t out;
+		out.val[0] = widen5_NEON(vmovn_u16(c));
+		out.val[1] = widen5_NEON(vshrn_n_u16(c, 5));
+		out.val[2] = widen5_NEON(vmovn_u16(vshrq_n_u16(c, 10)));
+		// 0 or 1, to 0 or 0xFF
+		out.val[3] = vsub_u8(vdup_n_u8(0), vmovn_u16(vshrq_n_u16(c, 15)));
+		vst4_u8(dB + x * 4, out);
+	}
+	return x;
+}
+
+#endif // _IRR_SIMD_NEON_
+
+#ifdef _IRR_SIMD_X86_
+	#define IRR_CASE_SSE2(f) case ESL_SSE2: return f(sP, sN, dP);
+	#define IRR_CASE_SSSE3(f) case ESL_SSSE3: return f(sP, sN, dP);
+	#define IRR_CASE_AVX2(f) case ESL_AVX2: return f(sP, sN, dP);
+#else
+	#define IRR_CASE_SSE2(f)
+	#define IRR_CASE_SSSE3(f)
+	#define IRR_CASE_AVX2(f)
+#endif
+#ifdef _IRR_SIMD_NEON_
+	#define IRR_CASE_NEON(f) case ESL_NEON: return f(sP, sN, dP);
+#else
+	#define IRR_CASE_NEON(f)
+#endif
+
+s32 convert_A1R5G5B5toA8R8G8B8(const void* sP, s32 sN, void* dP) {
+	if (sN < MinPixels)
+		return 0;
+	switch (getSIMDLevel()) {
+	IRR_CASE_SSE2(A1R5G5B5toA8R8G8B8_SSE2)
+	IRR_CASE_SSSE3(A1R5G5B5toA8R8G8B8_SSE2)
+	IRR_CASE_AVX2(A1R5G5B5toA8R8G8B8_AVX2)
+	IRR_CASE_NEON(A1R5G5B5toA8R8G8B8_NEON)
+	default: return 0;
+	}
+}
+
+s32 convert_A8R8G8B8toR8G8B8(const void* sP, s32 sN, void* dP) {
+	if (sN < MinPixels)
+		return 0;
+	switch (getSIMDLevel()) {
+	IRR_CASE_SSSE3(A8R8G8B8toR8G8B8_SSSE3)
+	IRR_CASE_AVX2(A8R8G8B8toR8G8B8_AVX2)
+	IRR_CASE_NEON(A8R8G8B8toR8G8B8_NEON)
+	default: return 0;
+	}
+}
+
+s32 convert_A8R8G8B8toB8G8R8(const void* sP, s32 sN, void* dP) {
+	if (sN < MinPixels)
+		return 0;
+	switch (getSIMDLevel()) {
+	IRR_CASE_SSSE3(A8R8G8B8toB8G8R8_SSSE3)
+	IRR_CASE_AVX2(A8R8G8B8toB8G8R8_AVX2)
+	IRR_CASE_NEON(A8R8G8B8toB8G8R8_NEON)
+	default: return 0;
+	}
+}
+
+s32 convert_A8R8G8B8toA1R5G5B5(const void* sP, s32 sN, void* dP) {
+	if (sN < MinPixels)
+		return 0;
+	switch (getSIMDLevel()) {
+	IRR_CASE_SSE2(A8R8G8B8toA1R5G5B5_SSE2)
+	IRR_CASE_SSSE3(A8R8G8B8toA1R5G5B5_SSE2)
+	IRR_CASE_AVX2(A8R8G8B8toA1R5G5B5_AVX2)
+	IRR_CASE_NEON(A8R8G8B8toA1R5G5B5_NEON)
+	default: return 0;
+	}
+}
+
+s32 convert_A8R8G8B8toA8B8G8R8(const void* sP, s32 sN, void* dP) {
+	if (sN < MinPixels)
+		return 0;
+	switch (getSIMDLevel()) {
+	IRR_CASE_SSE2(A8R8G8B8toA8B8G8R8_SSE2)
+	IRR_CASE_SSSE3(A8R8G8B8toA8B8G8R8_SSSE3)
+	IRR_CASE_AVX2(A8R8G8B8toA8B8G8R8_AVX2)
+	IRR_CASE_NEON(A8R8G8B8toA8B8G8R8_NEON)
+	default: return 0;
+	}
+}
+
+s32 convert_R8G8B8toA8R8G8B8(const void* sP, s32 sN, void* dP) {
+	if (sN < MinPixels)
+		return 0;
+	switch (getSIMDLevel()) {
+	IRR_CASE_SSSE3(R8G8B8toA8R8G8B8_SSSE3)
+	IRR_CASE_AVX2(R8G8B8toA8R8G8B8_AVX2)
+	IRR_CASE_NEON(R8G8B8toA8R8G8B8_NEON)
+	default: return 0;
+	}
+}
+
+s32 convert_R8G8B8toA1R5G5B5(const void* sP, s32 sN, void* dP) {
+	if (sN < MinPixels)
+		return 0;
+	switch (getSIMDLevel()) {
+	IRR_CASE_SSSE3(R8G8B8toA1R5G5B5_SSSE3)
+	IRR_CASE_AVX2(R8G8B8toA1R5G5B5_SSSE3)
+	IRR_CASE_NEON(R8G8B8toA1R5G5B5_NEON)
+	default: return 0;
+	}
+}
+
+} // end namespace simd
+} // end namespace video
+} // end namespace irr
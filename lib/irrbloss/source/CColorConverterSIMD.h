@@ -0,0 +1,30 @@
+// This file is part of Irrbloss, a fork of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_COLOR_CONVERTER_SIMD_H_INCLUDED__
+#define __C_COLOR_CONVERTER_SIMD_H_INCLUDED__
+
+#include "irrTypes.h"
+
+namespace irr {
+namespace video {
+namespace simd {
+
+//! Vectorized versions of some CColorConverter rows.
+//! Each converts pixels from the start of the row with the best kernel
+//! the selected SIMD level allows, and returns how many it converted.
+//! The caller converts the rest with the scalar loop, so a return of 0
+//! (short rows, or no usable instruction set) is always correct.
+s32 convert_A1R5G5B5toA8R8G8B8(const void* sP, s32 sN, void* dP);
+s32 convert_A8R8G8B8toR8G8B8(const void* sP, s32 sN, void* dP);
+s32 convert_A8R8G8B8toB8G8R8(const void* sP, s32 sN, void* dP);
+s32 convert_A8R8G8B8toA1R5G5B5(const void* sP, s32 sN, void* dP);
+s32 convert_A8R8G8B8toA8B8G8R8(const void* sP, s32 sN, void* dP);
+s32 convert_R8G8B8toA8R8G8B8(const void* sP, s32 sN, void* dP);
+s32 convert_R8G8B8toA1R5G5B5(const void* sP, s32 sN, void* dP);
+
+} // end namespace simd
+} // end namespace video
+} // end namespace irr
+
+#endif
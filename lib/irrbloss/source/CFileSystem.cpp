@@ -78,6 +78,8 @@ IReadFile* CFileSystem::createAndOpenFile(const io::path& filename) {
 
 	// Create the file using an absolute path so that it matches
 	// the scheme used by CNullDriver::getTexture().
+	// Not mapped, as another program may truncate the file while it is
+	// read; use createMappedReadFile() for files the application owns.
 	return CReadFile::createReadFile(getAbsolutePath(filename));
 }
 
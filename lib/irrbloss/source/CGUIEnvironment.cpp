@@ -25,6 +25,7 @@
 #include "CGUIComboBox.h"
 #include "CGUIMenu.h"
 #include "CGUIToolBar.h"
+#include "CGUIVirtualList.h"
 
 #include "IWriteFile.h"
 
@@ -766,6 +767,20 @@ IGUIListBox* CGUIEnvironment::addListBox(const core::rect<s32>& rectangle,
 	return b;
 }
 
+//! adds a virtual list
+IGUIVirtualList* CGUIEnvironment::addVirtualList(const core::rect<s32>& rectangle,
+					IGUIVirtualListSource* source, IGUIElement* parent, s32 id,
+					bool drawBackground) {
+	IGUIVirtualList* b = new CGUIVirtualList(this, parent ? parent : this, id, rectangle,
+		true, drawBackground);
+
+	if (source)
+		b->setSource(source);
+
+	b->drop();
+	return b;
+}
+
 //! adds a static text. The returned pointer must not be dropped.
 IGUIStaticText* CGUIEnvironment::addStaticText(const wchar_t* text,
 				const core::rect<s32>& rectangle,
@@ -115,6 +115,11 @@ public:
 	virtual IGUIListBox* addListBox(const core::rect<s32>& rectangle,
 		IGUIElement* parent=0, s32 id=-1, bool drawBackground=false) _IRR_OVERRIDE_;
 
+	//! adds a virtual list
+	virtual IGUIVirtualList* addVirtualList(const core::rect<s32>& rectangle,
+		IGUIVirtualListSource* source=0, IGUIElement* parent=0, s32 id=-1,
+		bool drawBackground=false) _IRR_OVERRIDE_;
+
 	//! adds a static text. The returned pointer must not be dropped.
 	virtual IGUIStaticText* addStaticText(const wchar_t* text, const core::rect<s32>& rectangle,
 		bool border=false, bool wordWrap=true, IGUIElement* parent=0, s32 id=-1, bool drawBackground = false) _IRR_OVERRIDE_;
@@ -0,0 +1,487 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CGUIVirtualList.h"
+#include "IGUISkin.h"
+#include "IGUIEnvironment.h"
+#include "IVideoDriver.h"
+#include "IGUIFont.h"
+#include "CGUIScrollBar.h"
+#include "os.h"
+
+namespace irr {
+namespace gui
+{
+
+//! constructor
+CGUIVirtualList::CGUIVirtualList(IGUIEnvironment* environment, IGUIElement* parent,
+			s32 id, core::rect<s32> rectangle, bool clip, bool drawBack)
+: IGUIVirtualList(environment, parent, id, rectangle), Source(0), RowCount(0),
+	CacheFirst(0), Selected(-1), ItemHeight(0), ItemHeightOverride(0),
+	TotalItemHeight(0), Font(0), ScrollBar(0), selectTime(0), LastKeyTime(0),
+	Selecting(false), DrawBack(drawBack), AutoScroll(true) {
+	#ifdef _DEBUG
+	setDebugName("CGUIVirtualList");
+	#endif
+
+	ScrollBar = new CGUIScrollBar(false, Environment, this, -1,
+		core::recti(0, 0, 1, 1),
+		!clip);
+	ScrollBar->setSubElement(true);
+	ScrollBar->setTabStop(false);
+	ScrollBar->setAlignment(EGUIA_LOWERRIGHT, EGUIA_LOWERRIGHT, EGUIA_UPPERLEFT, EGUIA_LOWERRIGHT);
+	ScrollBar->setVisible(false);
+	ScrollBar->setPos(0);
+
+	updateScrollBarSize(14);
+
+	setNotClipped(!clip);
+
+	// this element can be tabbed to
+	setTabStop(true);
+	setTabOrder(-1);
+
+	updateAbsolutePosition();
+}
+
+//! destructor
+CGUIVirtualList::~CGUIVirtualList() {
+	if (ScrollBar)
+		ScrollBar->drop();
+
+	if (Font)
+		Font->drop();
+}
+
+void CGUIVirtualList::setSource(IGUIVirtualListSource* source) {
+	Source = source;
+	Selected = -1;
+	ScrollBar->setPos(0);
+	refresh();
+}
+
+IGUIVirtualListSource* CGUIVirtualList::getSource() const {
+	return Source;
+}
+
+void CGUIVirtualList::refresh() {
+	RowCount = Source ? Source->getRowCount() : 0;
+	Cache.clear();
+	CacheFirst = 0;
+
+	if (Selected >= (s32)RowCount)
+		Selected = (s32)RowCount - 1;
+
+	recalculateItemHeight();
+}
+
+void CGUIVirtualList::updateRow(u32 row) {
+	if (row >= CacheFirst && row < CacheFirst + Cache.size())
+		Cache[row - CacheFirst].Valid = false;
+}
+
+u32 CGUIVirtualList::getRowCount() const {
+	return RowCount;
+}
+
+s32 CGUIVirtualList::getRowAt(s32 xpos, s32 ypos) const {
+	if ( 	xpos < AbsoluteRect.UpperLeftCorner.X || xpos >= AbsoluteRect.LowerRightCorner.X
+		||	ypos < AbsoluteRect.UpperLeftCorner.Y || ypos >= AbsoluteRect.LowerRightCorner.Y
+		)
+		return -1;
+
+	if ( ItemHeight == 0 )
+		return -1;
+
+	s32 row = ((ypos - AbsoluteRect.UpperLeftCorner.Y - 1) + ScrollBar->getPos()) / ItemHeight;
+	if ( row < 0 || row >= (s32)RowCount)
+		return -1;
+
+	return row;
+}
+
+void CGUIVirtualList::recalculateItemHeight() {
+	IGUISkin* skin = Environment->getSkin();
+
+	if (Font != skin->getFont()) {
+		if (Font)
+			Font->drop();
+
+		Font = skin->getFont();
+		if ( 0 == ItemHeightOverride )
+			ItemHeight = 0;
+
+		if (Font) {
+			if ( 0 == ItemHeightOverride )
+				ItemHeight = Font->getDimension(L"A").Height + 4;
+
+			Font->grab();
+		}
+	}
+
+	TotalItemHeight = ItemHeight * RowCount;
+	ScrollBar->setMax( core::max_(0, TotalItemHeight - AbsoluteRect.getHeight()) );
+	s32 minItemHeight = ItemHeight > 0 ? ItemHeight : 1;
+	ScrollBar->setSmallStep ( minItemHeight );
+	ScrollBar->setLargeStep ( 2*minItemHeight );
+
+	if ( TotalItemHeight <= AbsoluteRect.getHeight() )
+		ScrollBar->setVisible(false);
+	else
+		ScrollBar->setVisible(true);
+}
+
+//! returns the selected row. returns -1 if no row is selected.
+s32 CGUIVirtualList::getSelected() const {
+	return Selected;
+}
+
+//! sets the selected row. Set this to -1 if no row should be selected
+void CGUIVirtualList::setSelected(s32 row) {
+	if ((u32)row>=RowCount)
+		Selected = -1;
+	else
+		Selected = row;
+
+	selectTime = os::Timer::getTime();
+
+	recalculateScrollPos();
+}
+
+void CGUIVirtualList::sendEvent(EGUI_EVENT_TYPE type) {
+	if (!Parent)
+		return;
+
+	SEvent e;
+	e.EventType = EET_GUI_EVENT;
+	e.GUIEvent.Caller = this;
+	e.GUIEvent.Element = 0;
+	e.GUIEvent.EventType = type;
+	Parent->OnEvent(e);
+}
+
+bool CGUIVirtualList::matchesKeyBuffer(u32 row) const {
+	core::stringw text = Source->getRowText(row);
+	return text.size() >= KeyBuffer.size() &&
+		KeyBuffer.equals_ignore_case(text.subString(0, KeyBuffer.size()));
+}
+
+//! called if an event happened.
+bool CGUIVirtualList::OnEvent(const SEvent& event) {
+	if (isEnabled()) {
+		switch(event.EventType) {
+		case EET_KEY_INPUT_EVENT:
+			if (event.KeyInput.PressedDown &&
+				(event.KeyInput.Key == KEY_DOWN ||
+				event.KeyInput.Key == KEY_UP   ||
+				event.KeyInput.Key == KEY_HOME ||
+				event.KeyInput.Key == KEY_END  ||
+				event.KeyInput.Key == KEY_NEXT ||
+				event.KeyInput.Key == KEY_PRIOR ) ) {
+				s32 oldSelected = Selected;
+				switch (event.KeyInput.Key) {
+					case KEY_DOWN:
+						Selected += 1;
+						break;
+					case KEY_UP:
+						Selected -= 1;
+						break;
+					case KEY_HOME:
+						Selected = 0;
+						break;
+					case KEY_END:
+						Selected = (s32)RowCount-1;
+						break;
+					case KEY_NEXT:
+						Selected += AbsoluteRect.getHeight() / ItemHeight;
+						break;
+					case KEY_PRIOR:
+						Selected -= AbsoluteRect.getHeight() / ItemHeight;
+						break;
+					default:
+						break;
+				}
+				if (Selected<0)
+					Selected = 0;
+				if (Selected >= (s32)RowCount)
+					Selected = (s32)RowCount - 1;	// will set Selected to -1 for empty lists which is correct
+
+				recalculateScrollPos();
+
+				// post the news
+				if (oldSelected != Selected && !Selecting)
+					sendEvent(EGET_LISTBOX_CHANGED);
+
+				return true;
+			}
+			else
+			if (!event.KeyInput.PressedDown && ( event.KeyInput.Key == KEY_RETURN || event.KeyInput.Key == KEY_SPACE ) ) {
+				sendEvent(EGET_LISTBOX_SELECTED_AGAIN);
+				return true;
+			}
+			else if (event.KeyInput.Key == KEY_TAB ) {
+				return false;
+			}
+			else if (event.KeyInput.PressedDown && event.KeyInput.Char && Source) {
+				// change selection based on text as it is typed.
+				u32 now = os::Timer::getTime();
+
+				if (now - LastKeyTime < 500) {
+					// add to key buffer if it isn't a key repeat
+					if (!(KeyBuffer.size() == 1 && KeyBuffer[0] == event.KeyInput.Char)) {
+						KeyBuffer += L" ";
+						KeyBuffer[KeyBuffer.size()-1] = event.KeyInput.Char;
+					}
+				} else {
+					KeyBuffer = L" ";
+					KeyBuffer[0] = event.KeyInput.Char;
+				}
+				LastKeyTime = now;
+
+				// dont change selection if the key buffer matches the current row
+				if (Selected > -1 && KeyBuffer.size() > 1 && matchesKeyBuffer(Selected))
+					return true;
+
+				// find the next matching row, starting after the current selection
+				for (u32 i = 1; i <= RowCount; ++i) {
+					s32 current = (s32)((Selected + i) % RowCount);
+					if (matchesKeyBuffer(current)) {
+						bool changed = (Selected != current);
+						setSelected(current);
+						if (changed && !Selecting)
+							sendEvent(EGET_LISTBOX_CHANGED);
+						return true;
+					}
+				}
+
+				return true;
+			}
+			break;
+
+		case EET_GUI_EVENT:
+			switch(event.GUIEvent.EventType) {
+			case gui::EGET_SCROLL_BAR_CHANGED:
+				if (event.GUIEvent.Caller == ScrollBar)
+					return true;
+				break;
+			case gui::EGET_ELEMENT_FOCUS_LOST:
+				{
+					if (event.GUIEvent.Caller == this)
+						Selecting = false;
+				}
+			default:
+			break;
+			}
+			break;
+
+		case EET_MOUSE_INPUT_EVENT:
+			{
+				core::position2d<s32> p(event.MouseInput.X, event.MouseInput.Y);
+
+				switch(event.MouseInput.Event) {
+				case EMIE_MOUSE_WHEEL:
+					ScrollBar->setPos(ScrollBar->getPos() + (event.MouseInput.Wheel < 0 ? -1 : 1)*-ItemHeight/2);
+					return true;
+
+				case EMIE_LMOUSE_PRESSED_DOWN:
+				{
+					Selecting = true;
+					return true;
+				}
+
+				case EMIE_LMOUSE_LEFT_UP:
+				{
+					Selecting = false;
+
+					if (isPointInside(p))
+						selectNew(event.MouseInput.Y);
+
+					return true;
+				}
+
+				case EMIE_MOUSE_MOVED:
+					if (Selecting) {
+						if (isPointInside(p)) {
+							selectNew(event.MouseInput.Y, true);
+							return true;
+						}
+					}
+				default:
+				break;
+				}
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	return IGUIElement::OnEvent(event);
+}
+
+void CGUIVirtualList::selectNew(s32 ypos, bool onlyHover) {
+	u32 now = os::Timer::getTime();
+	s32 oldSelected = Selected;
+
+	Selected = getRowAt(AbsoluteRect.UpperLeftCorner.X, ypos);
+	if (Selected<0 && RowCount > 0)
+		Selected = 0;
+
+	recalculateScrollPos();
+
+	gui::EGUI_EVENT_TYPE eventType = (Selected == oldSelected && now < selectTime + 500) ? EGET_LISTBOX_SELECTED_AGAIN : EGET_LISTBOX_CHANGED;
+	selectTime = now;
+	// post the news
+	if (!onlyHover)
+		sendEvent(eventType);
+}
+
+//! Update the position and size of the list, and update the scrollbar
+void CGUIVirtualList::updateAbsolutePosition() {
+	IGUIElement::updateAbsolutePosition();
+
+	recalculateItemHeight();
+}
+
+void CGUIVirtualList::moveCache(u32 first, u32 count) {
+	if (first == CacheFirst && count == Cache.size())
+		return;
+
+	core::array< CachedRow > moved;
+	moved.reallocate(count);
+	for (u32 i = 0; i < count; ++i) {
+		u32 row = first + i;
+		if (row >= CacheFirst && row < CacheFirst + Cache.size())
+			moved.push_back(Cache[row - CacheFirst]);
+		else
+			moved.push_back(CachedRow());
+	}
+	Cache.swap(moved);
+	CacheFirst = first;
+}
+
+const core::stringw& CGUIVirtualList::getRowText(u32 row) {
+	if (row < CacheFirst || row >= CacheFirst + Cache.size()) {
+		Uncached = Source->getRowText(row);
+		return Uncached;
+	}
+
+	CachedRow& cached = Cache[row - CacheFirst];
+	if (!cached.Valid) {
+		cached.Text = Source->getRowText(row);
+		cached.Valid = true;
+	}
+	return cached.Text;
+}
+
+//! draws the element and its children
+void CGUIVirtualList::draw() {
+	if (!IsVisible)
+		return;
+
+	recalculateItemHeight(); // if the font changed
+
+	IGUISkin* skin = Environment->getSkin();
+	updateScrollBarSize(14);
+
+	core::rect<s32> frameRect(AbsoluteRect);
+
+	core::rect<s32> clientClip(AbsoluteRect);
+	clientClip.UpperLeftCorner.Y += 1;
+	clientClip.UpperLeftCorner.X += 1;
+	if (ScrollBar->isVisible())
+		clientClip.LowerRightCorner.X -= ScrollBar->getRelativePosition().getWidth();
+	clientClip.LowerRightCorner.Y -= 1;
+	clientClip.clipAgainst(AbsoluteClippingRect);
+
+	skin->draw3DSunkenPane(this, skin->getColor(EGDC_3D_HIGH_LIGHT), true,
+		DrawBack, frameRect, &AbsoluteClippingRect);
+
+	if (!Source || !Font || ItemHeight <= 0 || RowCount == 0) {
+		IGUIElement::draw();
+		return;
+	}
+
+	// only the rows which overlap the client area are read and drawn
+	const s32 scroll = ScrollBar->getPos();
+	u32 first = (u32)core::max_(0, (scroll - 1) / ItemHeight);
+	u32 last = (u32)core::max_(0, (scroll + AbsoluteRect.getHeight()) / ItemHeight);
+	if (last >= RowCount)
+		last = RowCount - 1;
+	if (first > last)
+		first = last;
+	moveCache(first, last - first + 1);
+
+	frameRect = AbsoluteRect;
+	frameRect.UpperLeftCorner.X += 1;
+	if (ScrollBar->isVisible())
+		frameRect.LowerRightCorner.X -= ScrollBar->getRelativePosition().getWidth();
+
+	frameRect.UpperLeftCorner.Y = AbsoluteRect.UpperLeftCorner.Y + first * ItemHeight - scroll;
+	frameRect.LowerRightCorner.Y = frameRect.UpperLeftCorner.Y + ItemHeight;
+
+	for (u32 i = first; i <= last; ++i) {
+		const bool selected = ((s32)i == Selected);
+		if (selected)
+			skin->draw2DRectangle(this, skin->getColor(EGDC_HIGH_LIGHT), frameRect, &clientClip);
+
+		core::rect<s32> textRect = frameRect;
+		textRect.UpperLeftCorner.X += 6;
+
+		Font->draw(getRowText(i).c_str(), textRect,
+			skin->getColor(selected ? EGDC_HIGH_LIGHT_TEXT : EGDC_BUTTON_TEXT),
+			false, true, &clientClip);
+
+		frameRect.UpperLeftCorner.Y += ItemHeight;
+		frameRect.LowerRightCorner.Y += ItemHeight;
+	}
+
+	IGUIElement::draw();
+}
+
+void CGUIVirtualList::recalculateScrollPos() {
+	if (!AutoScroll)
+		return;
+
+	const s32 selPos = (Selected == -1 ? TotalItemHeight : Selected * ItemHeight) - ScrollBar->getPos();
+
+	if (selPos < 0) {
+		ScrollBar->setPos(ScrollBar->getPos() + selPos);
+	}
+	else
+	if (selPos > AbsoluteRect.getHeight() - ItemHeight) {
+		ScrollBar->setPos(ScrollBar->getPos() + selPos - AbsoluteRect.getHeight() + ItemHeight);
+	}
+}
+
+void CGUIVirtualList::updateScrollBarSize(s32 size) {
+	if ( size != ScrollBar->getRelativePosition().getWidth() ) {
+		core::recti r(RelativeRect.getWidth() - size, 0, RelativeRect.getWidth(), RelativeRect.getHeight());
+		ScrollBar->setRelativePosition(r);
+	}
+}
+
+void CGUIVirtualList::setAutoScrollEnabled(bool scroll) {
+	AutoScroll = scroll;
+}
+
+//! set global itemHeight
+void CGUIVirtualList::setItemHeight( s32 height ) {
+	ItemHeight = height;
+	ItemHeightOverride = 1;
+	recalculateItemHeight();
+}
+
+//! Sets whether to draw the background
+void CGUIVirtualList::setDrawBackground(bool draw) {
+	DrawBack = draw;
+}
+
+//! Access the vertical scrollbar
+IGUIScrollBar* CGUIVirtualList::getVerticalScrollBar() const {
+	return ScrollBar;
+}
+
+} // end namespace gui
+} // end namespace irr
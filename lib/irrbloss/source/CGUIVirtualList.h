@@ -0,0 +1,123 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_GUI_VIRTUAL_LIST_H_INCLUDED__
+#define __C_GUI_VIRTUAL_LIST_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+#include "IGUIVirtualList.h"
+#include "irrArray.h"
+
+namespace irr {
+namespace gui
+{
+
+	class IGUIFont;
+	class IGUIScrollBar;
+
+	class CGUIVirtualList : public IGUIVirtualList
+	{
+	public:
+		//! constructor
+		CGUIVirtualList(IGUIEnvironment* environment, IGUIElement* parent,
+			s32 id, core::rect<s32> rectangle, bool clip=true,
+			bool drawBack=false);
+
+		//! destructor
+		virtual ~CGUIVirtualList();
+
+		//! sets where the rows come from
+		virtual void setSource(IGUIVirtualListSource* source) _IRR_OVERRIDE_;
+
+		//! returns the source of the rows
+		virtual IGUIVirtualListSource* getSource() const _IRR_OVERRIDE_;
+
+		//! reads the row count again and forgets every row's text
+		virtual void refresh() _IRR_OVERRIDE_;
+
+		//! forgets the text of one row
+		virtual void updateRow(u32 row) _IRR_OVERRIDE_;
+
+		//! returns the number of rows
+		virtual u32 getRowCount() const _IRR_OVERRIDE_;
+
+		//! get the row at the given absolute coordinates
+		virtual s32 getRowAt(s32 xpos, s32 ypos) const _IRR_OVERRIDE_;
+
+		//! returns the selected row. returns -1 if no row is selected.
+		virtual s32 getSelected() const _IRR_OVERRIDE_;
+
+		//! sets the selected row. Set this to -1 if no row should be selected
+		virtual void setSelected(s32 row) _IRR_OVERRIDE_;
+
+		//! set whether the list should scroll to newly selected rows
+		virtual void setAutoScrollEnabled(bool scroll) _IRR_OVERRIDE_;
+
+		//! set the height of every row
+		virtual void setItemHeight(s32 height) _IRR_OVERRIDE_;
+
+		//! Sets whether to draw the background
+		virtual void setDrawBackground(bool draw) _IRR_OVERRIDE_;
+
+		//! Access the vertical scrollbar
+		virtual IGUIScrollBar* getVerticalScrollBar() const _IRR_OVERRIDE_;
+
+		//! called if an event happened.
+		virtual bool OnEvent(const SEvent& event) _IRR_OVERRIDE_;
+
+		//! draws the element and its children
+		virtual void draw() _IRR_OVERRIDE_;
+
+		//! Update the position and size of the list, and update the scrollbar
+		virtual void updateAbsolutePosition() _IRR_OVERRIDE_;
+
+	private:
+
+		struct CachedRow
+		{
+			CachedRow() : Valid(false) {}
+
+			core::stringw Text;
+			bool Valid;
+		};
+
+		void recalculateItemHeight();
+		void selectNew(s32 ypos, bool onlyHover=false);
+		void recalculateScrollPos();
+		void updateScrollBarSize(s32 size);
+		void sendEvent(EGUI_EVENT_TYPE type);
+
+		// Moves the cache to start at first and hold count rows, keeping
+		// the text of the rows that were already there
+		void moveCache(u32 first, u32 count);
+
+		// Text of a row, from the cache when it is there
+		const core::stringw& getRowText(u32 row);
+
+		bool matchesKeyBuffer(u32 row) const;
+
+		IGUIVirtualListSource* Source;
+		u32 RowCount;
+		core::array< CachedRow > Cache;
+		u32 CacheFirst;
+		core::stringw Uncached;
+		s32 Selected;
+		s32 ItemHeight;
+		s32 ItemHeightOverride;
+		s32 TotalItemHeight;
+		gui::IGUIFont* Font;
+		gui::IGUIScrollBar* ScrollBar;
+		u32 selectTime;
+		u32 LastKeyTime;
+		core::stringw KeyBuffer;
+		bool Selecting;
+		bool DrawBack;
+		bool AutoScroll;
+	};
+
+
+} // end namespace gui
+} // end namespace irr
+
+#endif
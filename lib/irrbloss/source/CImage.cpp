@@ -8,6 +8,7 @@
 #include "CBlit.h"
 #include "os.h"
 #include "SoftwareDriver2_helper.h"
+#include "irrArray.h"
 
 namespace irr {
 namespace video
@@ -137,8 +138,33 @@ void CImage::copyTo(IImage* target, const core::position2d<s32>& pos, const core
 	Blit(BLITTER_TEXTURE, target, clipRect, &pos, this, &sourceRect, 0);
 }
 
+//! Copies count pixels of bpp bytes from the source offsets in columns
+static void gatherRow(const u8* src, const u32* columns, u32 count, u32 bpp, u8* dst) {
+	switch (bpp) {
+	case 4:
+		for (u32 x=0; x<count; ++x)
+			memcpy(dst + x*4, src + columns[x], 4);
+		break;
+	case 3:
+		for (u32 x=0; x<count; ++x) {
+			const u8* s = src + columns[x];
+			dst[x*3] = s[0];
+			dst[x*3+1] = s[1];
+			dst[x*3+2] = s[2];
+		}
+		break;
+	case 2:
+		for (u32 x=0; x<count; ++x)
+			memcpy(dst + x*2, src + columns[x], 2);
+		break;
+	default:
+		for (u32 x=0; x<count; ++x)
+			memcpy(dst + x*bpp, src + columns[x], bpp);
+		break;
+	}
+}
+
 //! copies this surface into another, scaling it to the target image size
-// note: this is very very slow.
 void CImage::copyToScaling(void* target, u32 width, u32 height, ECOLOR_FORMAT format, u32 pitch) {
 	if (IImage::isCompressedFormat(Format)) {
 		os::Printer::log("IImage::copyToScaling method doesn't work with compressed images.", ELL_WARNING);
@@ -173,6 +199,13 @@ void CImage::copyToScaling(void* target, u32 width, u32 height, ECOLOR_FORMAT fo
 		}
 	}
 
+	// Rows are converted whole, so the converters can vectorize them
+	if (Size.Width==width && Size.Height==height) {
+		for (u32 y=0; y<height; ++y)
+			CColorConverter::convert_viaFormat(Data + y*Pitch, Format, width, ((u8*)target) + y*pitch, format);
+		return;
+	}
+
 	// NOTE: Scaling is coded to keep the border pixels intact.
 	// Alternatively we could for example work with first pixel being taken at half step-size.
 	// Then we have one more step here and it would be:
@@ -199,14 +232,35 @@ void CImage::copyToScaling(void* target, u32 width, u32 height, ECOLOR_FORMAT fo
 		sourceYStart = 0.5f;	// for rounding to nearest pixel
 	}
 
-	s32 yval=0, syval=0;
+	// The source bytes of each target column, stepped the same way for every row
+	core::array<u32> columns;
+	columns.reallocate(width);
+	f32 sx = sourceXStart;
+	for (u32 x=0; x<width; ++x) {
+		columns.push_back(((s32)sx)*BytesPerPixel);
+		sx+=sourceXStep;
+	}
+
+	// Rows are gathered in the source format, then converted in one go
+	core::array<u8> row;
+	if (Format!=format)
+		row.set_used(width*BytesPerPixel);
+
+	const u32 rowBytes = width*bpp;
+	s32 yval=0, syval=0, lastsyval=-1;
 	f32 sy = sourceYStart;
 	for (u32 y=0; y<height; ++y) {
-		f32 sx = sourceXStart;
-		for (u32 x=0; x<width; ++x) {
-			CColorConverter::convert_viaFormat(Data+ syval + ((s32)sx)*BytesPerPixel, Format, 1, ((u8*)target)+ yval + (x*bpp), format);
-			sx+=sourceXStep;
+		u8* dst = ((u8*)target) + yval;
+		if (syval==lastsyval) {
+			// Enlarging repeats whole rows
+			memcpy(dst, dst - pitch, rowBytes);
+		} else if (Format==format) {
+			gatherRow(Data + syval, columns.const_pointer(), width, bpp, dst);
+		} else {
+			gatherRow(Data + syval, columns.const_pointer(), width, BytesPerPixel, row.pointer());
+			CColorConverter::convert_viaFormat(row.const_pointer(), Format, width, dst, format);
 		}
+		lastsyval=syval;
 		sy+=sourceYStep;
 		syval=(s32)(sy)*Pitch;
 		yval+=pitch;
@@ -214,7 +268,6 @@ void CImage::copyToScaling(void* target, u32 width, u32 height, ECOLOR_FORMAT fo
 }
 
 //! copies this surface into another, scaling it to the target image size
-// note: this is very very slow.
 void CImage::copyToScaling(IImage* target) {
 	if (IImage::isCompressedFormat(Format)) {
 		os::Printer::log("IImage::copyToScaling method doesn't work with compressed images.", ELL_WARNING);
@@ -160,8 +160,18 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const {
 			png_set_gamma(png_ptr, screen_gamma, 0.45455);
 	}
 
-	// Update the changes in between, as we need to get the new color type
-	// for proper processing of the RGBA type
+	// Decode straight into A8R8G8B8, which textures are made of anyway,
+	// instead of into R8G8B8 that would be converted when uploading. The
+	// filler is only added to images without alpha.
+#ifdef __BIG_ENDIAN__
+	png_set_swap_alpha(png_ptr);
+	png_set_filler(png_ptr, 0xFF, PNG_FILLER_BEFORE);
+#else
+	png_set_bgr(png_ptr);
+	png_set_filler(png_ptr, 0xFF, PNG_FILLER_AFTER);
+#endif
+
+	// Update the changes in between, as libpng sizes its rows for them
 	png_read_update_info(png_ptr, info_ptr);
 	{
 		// Use temporary variables to avoid passing cast pointers
@@ -174,21 +184,14 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const {
 		Height=h;
 	}
 
-	// Convert RGBA to BGRA
-	if (ColorType==PNG_COLOR_TYPE_RGB_ALPHA) {
-#ifdef __BIG_ENDIAN__
-		png_set_swap_alpha(png_ptr);
-#else
-		png_set_bgr(png_ptr);
-#endif
+	if (png_get_channels(png_ptr, info_ptr) != 4 || BitDepth != 8) {
+		os::Printer::log("LOAD PNG: unsupported pixel layout\n", file->getFileName(), ELL_ERROR);
+		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+		return 0;
 	}
 
 	// Create the image structure to be filled by png data
-	video::IImage* image = 0;
-	if (ColorType==PNG_COLOR_TYPE_RGB_ALPHA)
-		image = new CImage(ECF_A8R8G8B8, core::dimension2d<u32>(Width, Height));
-	else
-		image = new CImage(ECF_R8G8B8, core::dimension2d<u32>(Width, Height));
+	video::IImage* image = new CImage(ECF_A8R8G8B8, core::dimension2d<u32>(Width, Height));
 	if (!image) {
 		os::Printer::log("LOAD PNG: Internal PNG create image struct failure\n", file->getFileName(), ELL_ERROR);
 		png_destroy_read_struct(&png_ptr, NULL, NULL);
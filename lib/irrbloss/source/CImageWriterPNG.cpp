@@ -80,6 +80,10 @@ bool CImageWriterPNG::writeImage(io::IWriteFile* file, IImage* image,u32 param)
 
 	png_set_write_fn(png_ptr, file, user_write_data_fcn, NULL);
 
+	// param is the zlib compression level from 1 to 9, 0 uses the default
+	if (param > 0)
+		png_set_compression_level(png_ptr, core::min_(param, (u32)9));
+
 	// Set info
 	switch(image->getColorFormat()) {
 		case ECF_A8R8G8B8:
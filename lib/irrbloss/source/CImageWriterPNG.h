@@ -22,6 +22,7 @@ public:
 	virtual bool isAWriteableFileExtension(const io::path& filename) const _IRR_OVERRIDE_;
 
 	//! write image to file
+	/** \param param zlib compression level from 1 to 9, or 0 for the default. */
 	virtual bool writeImage(io::IWriteFile *file, IImage *image, u32 param) const _IRR_OVERRIDE_;
 };
 
@@ -0,0 +1,137 @@
+// This file is part of Irrbloss, a fork of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CMappedReadFile.h"
+#include <string.h>
+
+#if defined(_IRR_WINDOWS_API_)
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace irr {
+namespace io
+{
+
+CMappedReadFile::CMappedReadFile(const void* buffer, long len, const io::path& fileName)
+: Buffer(buffer), Len(len), Pos(0), Filename(fileName) {
+	#ifdef _DEBUG
+	setDebugName("CMappedReadFile");
+	#endif
+}
+
+CMappedReadFile::~CMappedReadFile() {
+#if defined(_IRR_WINDOWS_API_)
+	UnmapViewOfFile(Buffer);
+#else
+	munmap((void*)Buffer, Len);
+#endif
+}
+
+//! returns how much was read
+size_t CMappedReadFile::read(void* buffer, size_t sizeToRead) {
+	long amount = static_cast<long>(sizeToRead);
+	if (Pos + amount > Len)
+		amount -= Pos + amount - Len;
+
+	if (amount <= 0)
+		return 0;
+
+	memcpy(buffer, (const c8*)Buffer + Pos, amount);
+	Pos += amount;
+
+	return static_cast<size_t>(amount);
+}
+
+//! changes position in file, returns true if successful
+//! if relativeMovement==true, the pos is changed relative to current pos,
+//! otherwise from begin of file
+bool CMappedReadFile::seek(long finalPos, bool relativeMovement) {
+	if (relativeMovement)
+		finalPos += Pos;
+
+	if (finalPos < 0 || finalPos > Len)
+		return false;
+
+	Pos = finalPos;
+	return true;
+}
+
+//! returns size of file
+long CMappedReadFile::getSize() const {
+	return Len;
+}
+
+//! returns where in the file we are.
+long CMappedReadFile::getPos() const {
+	return Pos;
+}
+
+//! returns name of file
+const io::path& CMappedReadFile::getFileName() const {
+	return Filename;
+}
+
+IMemoryReadFile* CMappedReadFile::createMappedReadFile(const io::path& fileName) {
+	if (fileName.size() == 0)
+		return 0;
+
+	const void* buffer = 0;
+	long len = 0;
+
+#if defined(_IRR_WINDOWS_API_)
+	HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+		NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return 0;
+
+	LARGE_INTEGER size;
+	if (GetFileSizeEx(file, &size) && size.QuadPart > 0 && size.QuadPart <= 0x7fffffff) {
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping) {
+			buffer = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			if (buffer)
+				len = (long)size.QuadPart;
+			// The view keeps the mapping alive
+			CloseHandle(mapping);
+		}
+	}
+	CloseHandle(file);
+#else
+	int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return 0;
+
+	// Only regular files; pipes and devices can't be mapped whole
+	struct stat info;
+	if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0 &&
+			(unsigned long long)info.st_size <= 0x7fffffffULL) {
+		void* map = mmap(0, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map != MAP_FAILED) {
+			buffer = map;
+			len = (long)info.st_size;
+			// Loaders read files front to back
+			madvise(map, (size_t)info.st_size, MADV_SEQUENTIAL);
+		}
+	}
+	close(fd);
+#endif
+
+	if (!buffer)
+		return 0;
+
+	return new CMappedReadFile(buffer, len, fileName);
+}
+
+IMemoryReadFile* IRRCALLCONV createMappedReadFile(const io::path& fileName) {
+	return CMappedReadFile::createMappedReadFile(fileName);
+}
+
+} // end namespace io
+} // end namespace irr
+
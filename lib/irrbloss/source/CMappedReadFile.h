@@ -0,0 +1,70 @@
+// This file is part of Irrbloss, a fork of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_MAPPED_READ_FILE_H_INCLUDED__
+#define __C_MAPPED_READ_FILE_H_INCLUDED__
+
+#include "IMemoryReadFile.h"
+#include "irrString.h"
+
+namespace irr {
+
+namespace io {
+
+	/*!
+		Class for reading a real file from disk through a read only memory
+		mapping. Reads are copies out of the page cache without a system
+		call each, and getBuffer() gives loaders the whole file in place.
+	*/
+	class CMappedReadFile : public IMemoryReadFile
+	{
+	public:
+
+		virtual ~CMappedReadFile();
+
+		//! returns how much was read
+		virtual size_t read(void* buffer, size_t sizeToRead) _IRR_OVERRIDE_;
+
+		//! changes position in file, returns true if successful
+		virtual bool seek(long finalPos, bool relativeMovement = false) _IRR_OVERRIDE_;
+
+		//! returns size of file
+		virtual long getSize() const _IRR_OVERRIDE_;
+
+		//! returns where in the file we are.
+		virtual long getPos() const _IRR_OVERRIDE_;
+
+		//! returns name of file
+		virtual const io::path& getFileName() const _IRR_OVERRIDE_;
+
+		//! Get the type of the class implementing this interface
+		virtual EREAD_FILE_TYPE getType() const _IRR_OVERRIDE_
+		{
+			return ERFT_MAPPED_READ_FILE;
+		}
+
+		//! Get direct access to the mapped file
+		virtual const void *getBuffer() const _IRR_OVERRIDE_
+		{
+			return Buffer;
+		}
+
+		//! Maps a file on disk. Returns 0 if it can't be mapped, which
+		//! includes empty files, so that the caller can use CReadFile.
+		static IMemoryReadFile* createMappedReadFile(const io::path& fileName);
+
+	private:
+
+		CMappedReadFile(const void* buffer, long len, const io::path& fileName);
+
+		const void* Buffer;
+		long Len;
+		long Pos;
+		io::path Filename;
+	};
+
+} // end namespace io
+} // end namespace irr
+
+#endif
+
@@ -185,6 +185,18 @@ void CNullDriver::removeTexture(ITexture* texture) {
 	if (!texture)
 		return;
 
+	// many textures may share a name, so search the range with this name
+	SSurface s;
+	s.Surface = texture;
+	Textures.sort();
+	for (u32 i=lowerBoundTexture(s); i<Textures.size() && !(s < Textures[i]); ++i) {
+		if (Textures[i].Surface == texture) {
+			texture->drop();
+			Textures.erase(i);
+			return;
+		}
+	}
+
 	for (u32 i=0; i<Textures.size(); ++i) {
 		if (Textures[i].Surface == texture) {
 			texture->drop();
@@ -387,15 +399,40 @@ void CNullDriver::addTexture(video::ITexture* texture) {
 		s.Surface = texture;
 		texture->grab();
 
-		Textures.push_back(s);
+		// insert after the textures with the same name, to keep the array sorted
+		// without sorting it again for every new texture
+		Textures.sort();
+		Textures.insert(s, upperBoundTexture(s));
+		Textures.set_sorted(true);
+	}
+}
 
-		// the new texture is now at the end of the texture list. when searching for
-		// the next new texture, the texture array will be sorted and the index of this texture
-		// will be changed. to let the order be more consistent to the user, sort
-		// the textures now already although this isn't necessary:
+//! returns the index of the first texture which isn't ordered before s
+u32 CNullDriver::lowerBoundTexture(const SSurface& s) const {
+	u32 left = 0;
+	u32 right = Textures.size();
+	while (left < right) {
+		u32 middle = left + (right - left) / 2;
+		if (Textures[middle] < s)
+			left = middle + 1;
+		else
+			right = middle;
+	}
+	return left;
+}
 
-		Textures.sort();
+//! returns the index of the first texture which is ordered after s
+u32 CNullDriver::upperBoundTexture(const SSurface& s) const {
+	u32 left = 0;
+	u32 right = Textures.size();
+	while (left < right) {
+		u32 middle = left + (right - left) / 2;
+		if (s < Textures[middle])
+			right = middle;
+		else
+			left = middle + 1;
 	}
+	return left;
 }
 
 //! looks if the image is already loaded
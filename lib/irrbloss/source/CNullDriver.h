@@ -618,6 +618,9 @@ namespace video {
 			}
 		};
 
+		u32 lowerBoundTexture(const SSurface& s) const;
+		u32 upperBoundTexture(const SSurface& s) const;
+
 		struct SMaterialRenderer
 		{
 			core::stringc Name;
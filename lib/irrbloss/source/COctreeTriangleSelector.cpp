@@ -14,7 +14,7 @@ namespace scene {
 COctreeTriangleSelector::COctreeTriangleSelector(const IMesh* mesh,
 		ISceneNode* node, s32 minimalPolysPerNode)
 	: CTriangleSelector(mesh, node, false)
-	, Root(0), NodeCount(0)
+	, NodeCount(0)
 	, MinimalPolysPerNode(minimalPolysPerNode) {
 	#ifdef _DEBUG
 	setDebugName("COctreeTriangleSelector");
@@ -24,9 +24,7 @@ COctreeTriangleSelector::COctreeTriangleSelector(const IMesh* mesh,
 		//const u32 start = os::Timer::getRealTime();
 
 		// create the triangle octree
-		Root = new SOctreeNode();
-		Root->Triangles = Triangles;
-		constructOctree(Root);
+		buildOctree();
 
 		//c8 tmp[256];
 		//sprintf(tmp, "Needed %ums to create OctreeTriangleSelector.(%d nodes, %u polys)",
@@ -37,7 +35,7 @@ COctreeTriangleSelector::COctreeTriangleSelector(const IMesh* mesh,
 
 COctreeTriangleSelector::COctreeTriangleSelector(const IMeshBuffer* meshBuffer, irr::u32 materialIndex, ISceneNode* node, s32 minimalPolysPerNode)
 	: CTriangleSelector(meshBuffer, materialIndex, node)
-	, Root(0), NodeCount(0)
+	, NodeCount(0)
 	, MinimalPolysPerNode(minimalPolysPerNode) {
 	#ifdef _DEBUG
 	setDebugName("COctreeTriangleSelector");
@@ -47,9 +45,7 @@ COctreeTriangleSelector::COctreeTriangleSelector(const IMeshBuffer* meshBuffer,
 		const u32 start = os::Timer::getRealTime();
 
 		// create the triangle octree
-		Root = new SOctreeNode();
-		Root->Triangles = Triangles;
-		constructOctree(Root);
+		buildOctree();
 
 		c8 tmp[256];
 		sprintf(tmp, "Needed %ums to create OctreeTriangleSelector.(%d nodes, %u polys)",
@@ -60,7 +56,39 @@ COctreeTriangleSelector::COctreeTriangleSelector(const IMeshBuffer* meshBuffer,
 
 //! destructor
 COctreeTriangleSelector::~COctreeTriangleSelector() {
-	delete Root;
+}
+
+void COctreeTriangleSelector::buildOctree() {
+	SOctreeNode* root = new SOctreeNode();
+	root->Triangles = Triangles;
+	constructOctree(root);
+
+	// Queries walk an array instead of chasing child pointers, and read
+	// the triangles of consecutive nodes from one block of memory
+	Nodes.reallocate(NodeCount);
+	NodeTriangles.reallocate(Triangles.size());
+	flattenOctree(root);
+	delete root;
+}
+
+void COctreeTriangleSelector::flattenOctree(const SOctreeNode* node) {
+	const u32 index = Nodes.size();
+
+	SFlatNode flat;
+	flat.Box = node->Box;
+	flat.FirstTriangle = NodeTriangles.size();
+	flat.TriangleCount = node->Triangles.size();
+	flat.Skip = 0;
+	Nodes.push_back(flat);
+
+	for (u32 i=0; i<node->Triangles.size(); ++i)
+		NodeTriangles.push_back(node->Triangles[i]);
+
+	for (u32 i=0; i<8; ++i)
+		if (node->Child[i])
+			flattenOctree(node->Child[i]);
+
+	Nodes[index].Skip = Nodes.size();
 }
 
 void COctreeTriangleSelector::constructOctree(SOctreeNode* node) {
@@ -151,9 +179,7 @@ void COctreeTriangleSelector::getTriangles(core::triangle3df* triangles,
 
 	s32 trianglesWritten = 0;
 
-	if (Root)
-		getTrianglesFromOctree(Root, trianglesWritten,
-			arraySize, invbox, &mat, triangles);
+	getTrianglesFromOctree(trianglesWritten, arraySize, invbox, &mat, triangles);
 
 	if ( outTriangleInfo ) {
 		SCollisionTriangleRange triRange;
@@ -168,37 +194,36 @@ void COctreeTriangleSelector::getTriangles(core::triangle3df* triangles,
 	outTriangleCount = trianglesWritten;
 }
 
-void COctreeTriangleSelector::getTrianglesFromOctree(
-		SOctreeNode* node, s32& trianglesWritten,
+void COctreeTriangleSelector::getTrianglesFromOctree(s32& trianglesWritten,
 		s32 maximumSize, const core::aabbox3d<f32>& box,
 		const core::matrix4* mat, core::triangle3df* triangles) const {
-	if (!box.intersectsWithBox(node->Box))
-		return;
-
-	const u32 cnt = node->Triangles.size();
-
-	for (u32 i=0; i<cnt; ++i) {
-		const core::triangle3df& srcTri = node->Triangles[i];
-		// This isn't an accurate test, but it's fast, and the
-		// API contract doesn't guarantee complete accuracy.
-		if (srcTri.isTotalOutsideBox(box))
+	for (u32 n=0; n<Nodes.size();) {
+		const SFlatNode& node = Nodes[n];
+		if (!box.intersectsWithBox(node.Box)) {
+			n = node.Skip;
 			continue;
+		}
 
-		core::triangle3df& dstTri = triangles[trianglesWritten];
-		mat->transformVect(dstTri.pointA, srcTri.pointA );
-		mat->transformVect(dstTri.pointB, srcTri.pointB );
-		mat->transformVect(dstTri.pointC, srcTri.pointC );
-		++trianglesWritten;
+		const core::triangle3df* srcTris = NodeTriangles.const_pointer() + node.FirstTriangle;
+		for (u32 i=0; i<node.TriangleCount; ++i) {
+			const core::triangle3df& srcTri = srcTris[i];
+			// This isn't an accurate test, but it's fast, and the
+			// API contract doesn't guarantee complete accuracy.
+			if (srcTri.isTotalOutsideBox(box))
+				continue;
+
+			core::triangle3df& dstTri = triangles[trianglesWritten];
+			mat->transformVect(dstTri.pointA, srcTri.pointA );
+			mat->transformVect(dstTri.pointB, srcTri.pointB );
+			mat->transformVect(dstTri.pointC, srcTri.pointC );
+			++trianglesWritten;
 
-		// Halt when the out array is full.
-		if (trianglesWritten == maximumSize)
-			return;
+			// Halt when the out array is full.
+			if (trianglesWritten == maximumSize)
+				return;
+		}
+		++n;
 	}
-
-	for (u32 i=0; i<8; ++i)
-		if (node->Child[i])
-			getTrianglesFromOctree(node->Child[i], trianglesWritten,
-			maximumSize, box, mat, triangles);
 }
 
 //! Gets all triangles which have or may have contact with a 3d line.
@@ -237,8 +262,7 @@ void COctreeTriangleSelector::getTriangles(core::triangle3df* triangles, s32 arr
 
 	s32 trianglesWritten = 0;
 
-	if (Root)
-		getTrianglesFromOctree(Root, trianglesWritten, arraySize, invline, &mat, triangles);
+	getTrianglesFromOctree(trianglesWritten, arraySize, invline, &mat, triangles);
 
 	if ( outTriangleInfo ) {
 		SCollisionTriangleRange triRange;
@@ -254,37 +278,41 @@ void COctreeTriangleSelector::getTriangles(core::triangle3df* triangles, s32 arr
 #endif
 }
 
-void COctreeTriangleSelector::getTrianglesFromOctree(SOctreeNode* node,
-		s32& trianglesWritten, s32 maximumSize, const core::line3d<f32>& line,
+void COctreeTriangleSelector::getTrianglesFromOctree(s32& trianglesWritten,
+		s32 maximumSize, const core::line3d<f32>& line,
 		const core::matrix4* transform, core::triangle3df* triangles) const {
-	if (!node->Box.intersectsWithLine(line))
-		return;
+	const bool identity = transform->isIdentity();
 
-	s32 cnt = node->Triangles.size();
-	if (cnt + trianglesWritten > maximumSize)
-		cnt -= cnt + trianglesWritten - maximumSize;
+	for (u32 n=0; n<Nodes.size();) {
+		const SFlatNode& node = Nodes[n];
+		if (!node.Box.intersectsWithLine(line)) {
+			n = node.Skip;
+			continue;
+		}
 
-	s32 i;
+		s32 cnt = node.TriangleCount;
+		if (cnt + trianglesWritten > maximumSize)
+			cnt -= cnt + trianglesWritten - maximumSize;
 
-	if ( transform->isIdentity() ) {
-		for (i=0; i<cnt; ++i) {
-			triangles[trianglesWritten] = node->Triangles[i];
-			++trianglesWritten;
-		}
-	} else {
-		for (i=0; i<cnt; ++i) {
-			triangles[trianglesWritten] = node->Triangles[i];
-			transform->transformVect(triangles[trianglesWritten].pointA);
-			transform->transformVect(triangles[trianglesWritten].pointB);
-			transform->transformVect(triangles[trianglesWritten].pointC);
-			++trianglesWritten;
+		const core::triangle3df* srcTris = NodeTriangles.const_pointer() + node.FirstTriangle;
+		s32 i;
+
+		if (identity) {
+			for (i=0; i<cnt; ++i) {
+				triangles[trianglesWritten] = srcTris[i];
+				++trianglesWritten;
+			}
+		} else {
+			for (i=0; i<cnt; ++i) {
+				triangles[trianglesWritten] = srcTris[i];
+				transform->transformVect(triangles[trianglesWritten].pointA);
+				transform->transformVect(triangles[trianglesWritten].pointB);
+				transform->transformVect(triangles[trianglesWritten].pointC);
+				++trianglesWritten;
+			}
 		}
+		++n;
 	}
-
-	for (i=0; i<8; ++i)
-		if (node->Child[i])
-			getTrianglesFromOctree(node->Child[i], trianglesWritten,
-			maximumSize, line, transform, triangles);
 }
 
 } // end namespace scene
@@ -38,6 +38,7 @@ public:
 
 private:
 
+	//! Only used while building, see SFlatNode
 	struct SOctreeNode
 	{
 		SOctreeNode() {
@@ -56,19 +57,32 @@ private:
 	};
 
 
+	//! A node of the finished octree. Nodes are stored depth first, so a
+	//! node's subtree is the nodes from it up to, not including, Skip, and
+	//! its triangles are TriangleCount of NodeTriangles from FirstTriangle.
+	struct SFlatNode
+	{
+		core::aabbox3d<f32> Box;
+		u32 FirstTriangle;
+		u32 TriangleCount;
+		u32 Skip;
+	};
+
+	void buildOctree();
 	void constructOctree(SOctreeNode* node);
-	void deleteEmptyNodes(SOctreeNode* node);
-	void getTrianglesFromOctree(SOctreeNode* node, s32& trianglesWritten,
+	void flattenOctree(const SOctreeNode* node);
+	void getTrianglesFromOctree(s32& trianglesWritten,
 			s32 maximumSize, const core::aabbox3d<f32>& box,
 			const core::matrix4* transform,
 			core::triangle3df* triangles) const;
 
-	void getTrianglesFromOctree(SOctreeNode* node, s32& trianglesWritten,
+	void getTrianglesFromOctree(s32& trianglesWritten,
 			s32 maximumSize, const core::line3d<f32>& line,
 			const core::matrix4* transform,
 			core::triangle3df* triangles) const;
 
-	SOctreeNode* Root;
+	core::array<SFlatNode> Nodes;
+	core::array<core::triangle3df> NodeTriangles;
 	s32 NodeCount;
 	s32 MinimalPolysPerNode;
 };
@@ -0,0 +1,319 @@
+// This file is part of Irrbloss, a fork of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CRayTriangleTester.h"
+#include "SIMDLevel.h"
+
+// NEON only divides on AArch64, 32 bit ARM uses the scalar loop
+#if defined(_IRR_SIMD_NEON_) && (defined(__aarch64__) || defined(_M_ARM64))
+	#define _IRR_RAY_NEON_
+#endif
+
+namespace irr {
+namespace scene {
+
+// Layout of a block of eight triangles: corner A and the edges from it
+// to B and C, each coordinate of all eight triangles next to each other
+static const u32 BlockWidth = 8;
+static const u32 V0X = 0, V0Y = 8, V0Z = 16;
+static const u32 E1X = 24, E1Y = 32, E1Z = 40;
+static const u32 E2X = 48, E2Y = 56, E2Z = 64;
+static const u32 BlockSize = 72;
+
+void CRayTriangleTester::setTriangles(const core::triangle3df* triangles, u32 count) {
+	Count = count;
+	const u32 blockCount = (count + BlockWidth - 1) / BlockWidth;
+	Blocks.set_used(blockCount * BlockSize);
+	if (blockCount == 0)
+		return;
+
+	// Unused lanes of the last block are flat triangles, which no line hits
+	f32* last = Blocks.pointer() + (blockCount - 1) * BlockSize;
+	for (u32 i=0; i<BlockSize; ++i)
+		last[i] = 0.f;
+
+	for (u32 i=0; i<count; ++i) {
+		const core::triangle3df& tri = triangles[i];
+		f32* p = Blocks.pointer() + (i / BlockWidth) * BlockSize + i % BlockWidth;
+		p[V0X] = tri.pointA.X;
+		p[V0Y] = tri.pointA.Y;
+		p[V0Z] = tri.pointA.Z;
+		p[E1X] = tri.pointB.X - tri.pointA.X;
+		p[E1Y] = tri.pointB.Y - tri.pointA.Y;
+		p[E1Z] = tri.pointB.Z - tri.pointA.Z;
+		p[E2X] = tri.pointC.X - tri.pointA.X;
+		p[E2Y] = tri.pointC.Y - tri.pointA.Y;
+		p[E2Z] = tri.pointC.Z - tri.pointA.Z;
+	}
+}
+
+//! Line start and the vector to its end
+struct SRayData {
+	f32 OX, OY, OZ;
+	f32 DX, DY, DZ;
+};
+
+//! Picks the nearest of the hits each lane found. Equal distances go to
+//! the lower index, which is the one the scalar loop finds first.
+static s32 nearestOfLanes(const f32* t, const s32* found, u32 lanes, f32& outT) {
+	f32 best = 1.f;
+	s32 index = -1;
+	for (u32 i=0; i<lanes; ++i) {
+		if (found[i] < 0)
+			continue;
+		if (t[i] < best || (t[i] == best && found[i] < index)) {
+			best = t[i];
+			index = found[i];
+		}
+	}
+	outT = best;
+	return index;
+}
+
+static s32 nearest_Scalar(const f32* blocks, u32 blockCount, const SRayData& ray, f32& outT) {
+	f32 best = 1.f;
+	s32 index = -1;
+
+	for (u32 b=0; b<blockCount; ++b) {
+		const f32* block = blocks + b * BlockSize;
+		for (u32 lane=0; lane<BlockWidth; ++lane) {
+			const f32* p = block + lane;
+			const f32 e1x = p[E1X], e1y = p[E1Y], e1z = p[E1Z];
+			const f32 e2x = p[E2X], e2y = p[E2Y], e2z = p[E2Z];
+
+			const f32 px = ray.DY * e2z - ray.DZ * e2y;
+			const f32 py = ray.DZ * e2x - ray.DX * e2z;
+			const f32 pz = ray.DX * e2y - ray.DY * e2x;
+			const f32 det = e1x * px + e1y * py + e1z * pz;
+			const f32 inv = 1.f / det;
+
+			const f32 tx = ray.OX - p[V0X];
+			const f32 ty = ray.OY - p[V0Y];
+			const f32 tz = ray.OZ - p[V0Z];
+			const f32 u = (tx * px + ty * py + tz * pz) * inv;
+
+			const f32 qx = ty * e1z - tz * e1y;
+			const f32 qy = tz * e1x - tx * e1z;
+			const f32 qz = tx * e1y - ty * e1x;
+			const f32 v = (ray.DX * qx + ray.DY * qy + ray.DZ * qz) * inv;
+			const f32 t = (e2x * qx + e2y * qy + e2z * qz) * inv;
+
+			if (det != 0.f && u >= 0.f && v >= 0.f && u + v <= 1.f &&
+					t > 0.f && t < best) {
+				best = t;
+				index = b * BlockWidth + lane;
+			}
+		}
+	}
+
+	outT = best;
+	return index;
+}
+
+#ifdef _IRR_SIMD_X86_
+
+IRR_TARGET("sse2")
+static s32 nearest_SSE2(const f32* blocks, u32 blockCount, const SRayData& ray, f32& outT) {
+	const __m128 ox = _mm_set1_ps(ray.OX), oy = _mm_set1_ps(ray.OY), oz = _mm_set1_ps(ray.OZ);
+	const __m128 dx = _mm_set1_ps(ray.DX), dy = _mm_set1_ps(ray.DY), dz = _mm_set1_ps(ray.DZ);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.f);
+
+	// A block is two registers wide, each half keeps its own nearest hits
+	__m128 best[2] = { one, one };
+	__m128i found[2] = { _mm_set1_epi32(-1), _mm_set1_epi32(-1) };
+	__m128i index = _mm_setr_epi32(0, 1, 2, 3);
+	const __m128i step = _mm_set1_epi32(4);
+
+	for (u32 b=0; b<blockCount; ++b) {
+		for (u32 h=0; h<2; ++h) {
+			const f32* p = blocks + b * BlockSize + h * 4;
+			const __m128 e1x = _mm_loadu_ps(p + E1X), e1y = _mm_loadu_ps(p + E1Y), e1z = _mm_loadu_ps(p + E1Z);
+			const __m128 e2x = _mm_loadu_ps(p + E2X), e2y = _mm_loadu_ps(p + E2Y), e2z = _mm_loadu_ps(p + E2Z);
+
+			const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+			const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+			const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+			const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+			const __m128 inv = _mm_div_ps(one, det);
+
+			const __m128 tx = _mm_sub_ps(ox, _mm_loadu_ps(p + V0X));
+			const __m128 ty = _mm_sub_ps(oy, _mm_loadu_ps(p + V0Y));
+			const __m128 tz = _mm_sub_ps(oz, _mm_loadu_ps(p + V0Z));
+			const __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), inv);
+
+			const __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+			const __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+			const __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+			const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inv);
+			const __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inv);
+
+			__m128 hit = _mm_and_ps(_mm_cmpneq_ps(det, zero), _mm_cmpge_ps(u, zero));
+			hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+			hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), one));
+			hit = _mm_and_ps(hit, _mm_cmpgt_ps(t, zero));
+			hit = _mm_and_ps(hit, _mm_cmplt_ps(t, best[h]));
+
+			best[h] = _mm_or_ps(_mm_and_ps(hit, t), _mm_andnot_ps(hit, best[h]));
+			const __m128i mask = _mm_castps_si128(hit);
+			found[h] = _mm_or_si128(_mm_and_si128(mask, index), _mm_andnot_si128(mask, found[h]));
+			index = _mm_add_epi32(index, step);
+		}
+	}
+
+	f32 laneT[8];
+	s32 laneFound[8];
+	_mm_storeu_ps(laneT, best[0]);
+	_mm_storeu_ps(laneT + 4, best[1]);
+	_mm_storeu_si128((__m128i*)laneFound, found[0]);
+	_mm_storeu_si128((__m128i*)(laneFound + 4), found[1]);
+	return nearestOfLanes(laneT, laneFound, 8, outT);
+}
+
+IRR_TARGET("avx2")
+static s32 nearest_AVX2(const f32* blocks, u32 blockCount, const SRayData& ray, f32& outT) {
+	const __m256 ox = _mm256_set1_ps(ray.OX), oy = _mm256_set1_ps(ray.OY), oz = _mm256_set1_ps(ray.OZ);
+	const __m256 dx = _mm256_set1_ps(ray.DX), dy = _mm256_set1_ps(ray.DY), dz = _mm256_set1_ps(ray.DZ);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.f);
+
+	__m256 best = one;
+	__m256i found = _mm256_set1_epi32(-1);
+	__m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256i step = _mm256_set1_epi32(8);
+
+	for (u32 b=0; b<blockCount; ++b) {
+		const f32* p = blocks + b * BlockSize;
+		const __m256 e1x = _mm256_loadu_ps(p + E1X), e1y = _mm256_loadu_ps(p + E1Y), e1z = _mm256_loadu_ps(p + E1Z);
+		const __m256 e2x = _mm256_loadu_ps(p + E2X), e2y = _mm256_loadu_ps(p + E2Y), e2z = _mm256_loadu_ps(p + E2Z);
+
+		const __m256 px = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+		const __m256 py = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+		const __m256 pz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+		const __m256 det = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, px), _mm256_mul_ps(e1y, py)), _mm256_mul_ps(e1z, pz));
+		const __m256 inv = _mm256_div_ps(one, det);
+
+		const __m256 tx = _mm256_sub_ps(ox, _mm256_loadu_ps(p + V0X));
+		const __m256 ty = _mm256_sub_ps(oy, _mm256_loadu_ps(p + V0Y));
+		const __m256 tz = _mm256_sub_ps(oz, _mm256_loadu_ps(p + V0Z));
+		const __m256 u = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(tx, px), _mm256_mul_ps(ty, py)), _mm256_mul_ps(tz, pz)), inv);
+
+		const __m256 qx = _mm256_sub_ps(_mm256_mul_ps(ty, e1z), _mm256_mul_ps(tz, e1y));
+		const __m256 qy = _mm256_sub_ps(_mm256_mul_ps(tz, e1x), _mm256_mul_ps(tx, e1z));
+		const __m256 qz = _mm256_sub_ps(_mm256_mul_ps(tx, e1y), _mm256_mul_ps(ty, e1x));
+		const __m256 v = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)), _mm256_mul_ps(dz, qz)), inv);
+		const __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)), _mm256_mul_ps(e2z, qz)), inv);
+
+		__m256 hit = _mm256_and_ps(_mm256_cmp_ps(det, zero, _CMP_NEQ_UQ), _mm256_cmp_ps(u, zero, _CMP_GE_OQ));
+		hit = _mm256_and_ps(hit, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+		hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ));
+		hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, zero, _CMP_GT_OQ));
+		hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, best, _CMP_LT_OQ));
+
+		best = _mm256_blendv_ps(best, t, hit);
+		found = _mm256_blendv_epi8(found, index, _mm256_castps_si256(hit));
+		index = _mm256_add_epi32(index, step);
+	}
+
+	f32 laneT[8];
+	s32 laneFound[8];
+	_mm256_storeu_ps(laneT, best);
+	_mm256_storeu_si256((__m256i*)laneFound, found);
+	return nearestOfLanes(laneT, laneFound, 8, outT);
+}
+
+#endif // _IRR_SIMD_X86_
+
+#ifdef _IRR_RAY_NEON_
+
+static s32 nearest_NEON(const f32* blocks, u32 blockCount, const SRayData& ray, f32& outT) {
+	const float32x4_t ox = vdupq_n_f32(ray.OX), oy = vdupq_n_f32(ray.OY), oz = vdupq_n_f32(ray.OZ);
+	const float32x4_t dx = vdupq_n_f32(ray.DX), dy = vdupq_n_f32(ray.DY), dz = vdupq_n_f32(ray.DZ);
+	const float32x4_t zero = vdupq_n_f32(0.f);
+	const float32x4_t one = vdupq_n_f32(1.f);
+
+	float32x4_t best[2] = { one, one };
+	int32x4_t found[2] = { vdupq_n_s32(-1), vdupq_n_s32(-1) };
+	static const s32 firstIndex[4] = { 0, 1, 2, 3 };
+	int32x4_t index = vld1q_s32(firstIndex);
+	const int32x4_t step = vdupq_n_s32(4);
+
+	for (u32 b=0; b<blockCount; ++b) {
+		for (u32 h=0; h<2; ++h) {
+			const f32* p = blocks + b * BlockSize + h * 4;
+			const float32x4_t e1x = vld1q_f32(p + E1X), e1y = vld1q_f32(p + E1Y), e1z = vld1q_f32(p + E1Z);
+			const float32x4_t e2x = vld1q_f32(p + E2X), e2y = vld1q_f32(p + E2Y), e2z = vld1q_f32(p + E2Z);
+
+			const float32x4_t px = vsubq_f32(vmulq_f32(dy, e2z), vmulq_f32(dz, e2y));
+			const float32x4_t py = vsubq_f32(vmulq_f32(dz, e2x), vmulq_f32(dx, e2z));
+			const float32x4_t pz = vsubq_f32(vmulq_f32(dx, e2y), vmulq_f32(dy, e2x));
+			const float32x4_t det = vaddq_f32(vaddq_f32(vmulq_f32(e1x, px), vmulq_f32(e1y, py)), vmulq_f32(e1z, pz));
+			const float32x4_t inv = vdivq_f32(one, det);
+
+			const float32x4_t tx = vsubq_f32(ox, vld1q_f32(p + V0X));
+			const float32x4_t ty = vsubq_f32(oy, vld1q_f32(p + V0Y));
+			const float32x4_t tz = vsubq_f32(oz, vld1q_f32(p + V0Z));
+			const float32x4_t u = vmulq_f32(vaddq_f32(vaddq_f32(vmulq_f32(tx, px), vmulq_f32(ty, py)), vmulq_f32(tz, pz)), inv);
+
+			const float32x4_t qx = vsubq_f32(vmulq_f32(ty, e1z), vmulq_f32(tz, e1y));
+			const float32x4_t qy = vsubq_f32(vmulq_f32(tz, e1x), vmulq_f32(tx, e1z));
+			const float32x4_t qz = vsubq_f32(vmulq_f32(tx, e1y), vmulq_f32(ty, e1x));
+			const float32x4_t v = vmulq_f32(vaddq_f32(vaddq_f32(vmulq_f32(dx, qx), vmulq_f32(dy, qy)), vmulq_f32(dz, qz)), inv);
+			const float32x4_t t = vmulq_f32(vaddq_f32(vaddq_f32(vmulq_f32(e2x, qx), vmulq_f32(e2y, qy)), vmulq_f32(e2z, qz)), inv);
+
+			uint32x4_t hit = vandq_u32(vmvnq_u32(vceqq_f32(det, zero)), vcgeq_f32(u, zero));
+			hit = vandq_u32(hit, vcgeq_f32(v, zero));
+			hit = vandq_u32(hit, vcleq_f32(vaddq_f32(u, v), one));
+			hit = vandq_u32(hit, vcgtq_f32(t, zero));
+			hit = vandq_u32(hit, vcltq_f32(t, best[h]));
+
+			best[h] = vbslq_f32(hit, t, best[h]);
+			found[h] = vbslq_s32(hit, index, found[h]);
+			index = vaddq_s32(index, step);
+		}
+	}
+
+	f32 laneT[8];
+	s32 laneFound[8];
+	vst1q_f32(laneT, best[0]);
+	vst1q_f32(laneT + 4, best[1]);
+	vst1q_s32(laneFound, found[0]);
+	vst1q_s32(laneFound + 4, found[1]);
+	return nearestOfLanes(laneT, laneFound, 8, outT);
+}
+
+#endif // _IRR_RAY_NEON_
+
+s32 CRayTriangleTester::getNearest(const core::line3d<f32>& line, f32& outT) const {
+	const u32 blockCount = (Count + BlockWidth - 1) / BlockWidth;
+	if (blockCount == 0)
+		return -1;
+
+	SRayData ray;
+	ray.OX = line.start.X;
+	ray.OY = line.start.Y;
+	ray.OZ = line.start.Z;
+	ray.DX = line.end.X - line.start.X;
+	ray.DY = line.end.Y - line.start.Y;
+	ray.DZ = line.end.Z - line.start.Z;
+
+	const f32* blocks = Blocks.const_pointer();
+	switch (getSIMDLevel()) {
+#ifdef _IRR_SIMD_X86_
+	case ESL_SSE2:
+	case ESL_SSSE3:
+		return nearest_SSE2(blocks, blockCount, ray, outT);
+	case ESL_AVX2:
+		return nearest_AVX2(blocks, blockCount, ray, outT);
+#endif
+#ifdef _IRR_RAY_NEON_
+	case ESL_NEON:
+		return nearest_NEON(blocks, blockCount, ray, outT);
+#endif
+	default:
+		return nearest_Scalar(blocks, blockCount, ray, outT);
+	}
+}
+
+} // end namespace scene
+} // end namespace irr
@@ -0,0 +1,47 @@
+// This file is part of Irrbloss, a fork of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_RAY_TRIANGLE_TESTER_H_INCLUDED__
+#define __C_RAY_TRIANGLE_TESTER_H_INCLUDED__
+
+#include "irrArray.h"
+#include "line3d.h"
+#include "triangle3d.h"
+
+namespace irr {
+namespace scene
+{
+
+//! Tests lines against a set of triangles, several triangles at a time.
+/** The triangles are stored as one corner and two edges, each coordinate
+of eight triangles next to each other, so that the kernel for the
+selected SIMD level loads them straight into registers. Every level
+computes the same Moeller-Trumbore test, in the same order as the
+scalar loop, which is the reference the kernels are checked against. */
+class CRayTriangleTester {
+public:
+
+	CRayTriangleTester() : Count(0) {}
+
+	//! Prepares triangles for testing. Memory is kept between calls.
+	void setTriangles(const core::triangle3df* triangles, u32 count);
+
+	//! Finds the triangle which line crosses nearest to line.start.
+	/** Triangles are hit from both sides. Lines which only touch a
+	triangle at line.start or line.end don't hit it.
+	\param line: Line to test.
+	\param outT: If a triangle is hit, the fraction of the way from
+	line.start to line.end where it is hit.
+	\return Index of the triangle, or -1 if no triangle is hit. */
+	s32 getNearest(const core::line3d<f32>& line, f32& outT) const;
+
+private:
+
+	core::array<f32> Blocks;
+	u32 Count;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
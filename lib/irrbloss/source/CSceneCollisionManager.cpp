@@ -308,79 +308,70 @@ ISceneNode* CSceneCollisionManager::getSceneNodeFromCameraBB(
 }
 
 bool CSceneCollisionManager::getCollisionPoint(SCollisionHit& hitResult, const core::line3d<f32>& ray, ITriangleSelector* selector) {
-	if (!selector) {
-		return false;
+	bool hit = false;
+	getCollisionPoints(&hitResult, &hit, &ray, 1, selector);
+	return hit;
+}
+
+u32 CSceneCollisionManager::getCollisionPoints(SCollisionHit* hitResults, bool* outHits,
+		const core::line3d<f32>* rays, u32 count, ITriangleSelector* selector) {
+	for (u32 i=0; i<count; ++i)
+		outHits[i] = false;
+
+	if (!selector || count == 0) {
+		return 0;
 	}
 
 	s32 totalcnt = selector->getTriangleCount();
 	if ( totalcnt <= 0 )
-		return false;
+		return 0;
 
 	Triangles.set_used(totalcnt);
+	TriangleInfo.set_used(0);
 
+	// A single line can use the selector's line query, which returns
+	// fewer triangles than a box around the line would
 	s32 cnt = 0;
-	irr::core::array<SCollisionTriangleRange> outTriangleInfo;
-	selector->getTriangles(Triangles.pointer(), totalcnt, cnt, ray, 0, true, &outTriangleInfo);
-
-	const core::vector3df linevect = ray.getVector().normalize();
-	core::vector3df intersection;
-	f32 nearest = FLT_MAX;
-	irr::s32 foundIndex = -1;
-	const f32 raylength = ray.getLengthSQ();
-
-	const f32 minX = core::min_(ray.start.X, ray.end.X);
-	const f32 maxX = core::max_(ray.start.X, ray.end.X);
-	const f32 minY = core::min_(ray.start.Y, ray.end.Y);
-	const f32 maxY = core::max_(ray.start.Y, ray.end.Y);
-	const f32 minZ = core::min_(ray.start.Z, ray.end.Z);
-	const f32 maxZ = core::max_(ray.start.Z, ray.end.Z);
+	if (count == 1) {
+		selector->getTriangles(Triangles.pointer(), totalcnt, cnt, rays[0], 0, true, &TriangleInfo);
+	} else {
+		core::aabbox3d<f32> box(rays[0].start);
+		for (u32 i=0; i<count; ++i) {
+			box.addInternalPoint(rays[i].start);
+			box.addInternalPoint(rays[i].end);
+		}
+		selector->getTriangles(Triangles.pointer(), totalcnt, cnt, box, 0, true, &TriangleInfo);
+	}
 
-	for (s32 i=0; i<cnt; ++i) {
-		const core::triangle3df & triangle = Triangles[i];
+	RayTester.setTriangles(Triangles.const_pointer(), cnt);
 
-		if(minX > triangle.pointA.X && minX > triangle.pointB.X && minX > triangle.pointC.X)
-			continue;
-		if(maxX < triangle.pointA.X && maxX < triangle.pointB.X && maxX < triangle.pointC.X)
-			continue;
-		if(minY > triangle.pointA.Y && minY > triangle.pointB.Y && minY > triangle.pointC.Y)
-			continue;
-		if(maxY < triangle.pointA.Y && maxY < triangle.pointB.Y && maxY < triangle.pointC.Y)
-			continue;
-		if(minZ > triangle.pointA.Z && minZ > triangle.pointB.Z && minZ > triangle.pointC.Z)
-			continue;
-		if(maxZ < triangle.pointA.Z && maxZ < triangle.pointB.Z && maxZ < triangle.pointC.Z)
+	u32 hits = 0;
+	for (u32 i=0; i<count; ++i) {
+		f32 t;
+		const s32 foundIndex = RayTester.getNearest(rays[i], t);
+		if ( foundIndex < 0 )
 			continue;
 
-		if (triangle.getIntersectionWithLine(ray.start, linevect, intersection)) {
-			const f32 tmp = intersection.getDistanceFromSQ(ray.start);
-			const f32 tmp2 = intersection.getDistanceFromSQ(ray.end);
+		SCollisionHit& hitResult = hitResults[i];
+		hitResult.Triangle = Triangles[foundIndex];
+		hitResult.Intersection = rays[i].start + rays[i].getVector() * t;
 
-			if (tmp < raylength && tmp2 < raylength && tmp < nearest) {
-				nearest = tmp;
-
-				hitResult.Triangle = triangle;
-				hitResult.Intersection = intersection;
-				foundIndex = i;
-			}
-		}
-	}
-
-	if ( foundIndex >= 0 ) {
-		for ( irr::u32 t=0; t<outTriangleInfo.size(); ++t ) {
-			if ( outTriangleInfo[t].isIndexInRange(foundIndex) ) {
-				hitResult.Node = outTriangleInfo[t].SceneNode;
-				hitResult.MeshBuffer = outTriangleInfo[t].MeshBuffer;
-				hitResult.MaterialIndex = outTriangleInfo[t].MaterialIndex;
-				hitResult.TriangleSelector = outTriangleInfo[t].Selector;
+		for ( irr::u32 r=0; r<TriangleInfo.size(); ++r ) {
+			if ( TriangleInfo[r].isIndexInRange(foundIndex) ) {
+				hitResult.Node = TriangleInfo[r].SceneNode;
+				hitResult.MeshBuffer = TriangleInfo[r].MeshBuffer;
+				hitResult.MaterialIndex = TriangleInfo[r].MaterialIndex;
+				hitResult.TriangleSelector = TriangleInfo[r].Selector;
 
 				break;
 			}
 		}
 
-		return true;
+		outHits[i] = true;
+		++hits;
 	}
 
-	return false;
+	return hits;
 }
 
 //! Collides a moving ellipsoid with a 3d world with gravity and returns
@@ -8,6 +8,8 @@
 #include "ISceneCollisionManager.h"
 #include "ISceneManager.h"
 #include "IVideoDriver.h"
+#include "ITriangleSelector.h"
+#include "CRayTriangleTester.h"
 
 namespace irr {
 namespace scene
@@ -44,6 +46,11 @@ namespace scene
 		virtual bool getCollisionPoint(SCollisionHit& hitResult, const core::line3d<f32>& ray,
 				ITriangleSelector* selector)  _IRR_OVERRIDE_;
 
+		//! Finds the nearest collision point of each of several lines with lots of triangles.
+		virtual u32 getCollisionPoints(SCollisionHit* hitResults, bool* outHits,
+				const core::line3d<f32>* rays, u32 count,
+				ITriangleSelector* selector) _IRR_OVERRIDE_;
+
 		//! Collides a moving ellipsoid with a 3d world with gravity and returns
 		//! the resulting new position of the ellipsoid.
 		virtual core::vector3df getCollisionResultPosition(
@@ -142,6 +149,8 @@ namespace scene
 		ISceneManager* SceneManager;
 		video::IVideoDriver* Driver;
 		core::array<core::triangle3df> Triangles; // triangle buffer
+		core::array<SCollisionTriangleRange> TriangleInfo; // which selector Triangles came from
+		CRayTriangleTester RayTester;
 	};
 
 
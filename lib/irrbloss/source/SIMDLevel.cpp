@@ -0,0 +1,69 @@
+// This file is part of Irrbloss, a fork of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "SIMDLevel.h"
+#include <stdlib.h>
+#include <string.h>
+
+namespace irr {
+
+static E_SIMD_LEVEL detectSIMDLevel() {
+	E_SIMD_LEVEL level = ESL_NONE;
+
+#if defined(_IRR_SIMD_X86_) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	const int maxLeaf = info[0];
+	__cpuid(info, 1);
+	if (info[3] & (1 << 26))
+		level = ESL_SSE2;
+	if ((info[2] & (1 << 9)) && level == ESL_SSE2)
+		level = ESL_SSSE3;
+	// AVX2 also needs the OS to save the upper halves of the registers
+	const bool osSavesAVX = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) &&
+		(_xgetbv(0) & 6) == 6;
+	if (maxLeaf >= 7 && osSavesAVX && level == ESL_SSSE3) {
+		__cpuidex(info, 7, 0);
+		if (info[1] & (1 << 5))
+			level = ESL_AVX2;
+	}
+#elif defined(_IRR_SIMD_X86_)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2"))
+		level = ESL_SSE2;
+	if (__builtin_cpu_supports("ssse3") && level == ESL_SSE2)
+		level = ESL_SSSE3;
+	if (__builtin_cpu_supports("avx2") && level == ESL_SSSE3)
+		level = ESL_AVX2;
+#elif defined(_IRR_SIMD_NEON_)
+	level = ESL_NEON;
+#endif
+
+	// IRRBLOSS_SIMD=none|sse2|ssse3|avx2 lowers the level, to compare
+	// against the scalar loops or find a faulty kernel
+	const char* env = getenv("IRRBLOSS_SIMD");
+	if (env) {
+		static const char* const names[] = { "none", "sse2", "ssse3", "avx2", "neon" };
+		for (s32 i = 0; i < 5; ++i) {
+			if (strcmp(env, names[i]) == 0 && i < (s32)level)
+				level = (E_SIMD_LEVEL)i;
+		}
+	}
+	return level;
+}
+
+static E_SIMD_LEVEL& selectedLevel() {
+	static E_SIMD_LEVEL level = detectSIMDLevel();
+	return level;
+}
+
+E_SIMD_LEVEL getSIMDLevel() {
+	return selectedLevel();
+}
+
+void setSIMDLevel(E_SIMD_LEVEL level) {
+	const E_SIMD_LEVEL supported = detectSIMDLevel();
+	selectedLevel() = level < supported ? level : supported;
+}
+
+} // end namespace irr
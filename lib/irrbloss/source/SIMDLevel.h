@@ -0,0 +1,46 @@
+// This file is part of Irrbloss, a fork of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __IRR_SIMD_LEVEL_H_INCLUDED__
+#define __IRR_SIMD_LEVEL_H_INCLUDED__
+
+#include "irrTypes.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define _IRR_SIMD_X86_
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define IRR_TARGET(isa)
+	#else
+		// Kernels are built for their instruction set whatever the compiler
+		// flags are, and only called once the CPU is known to have it
+		#define IRR_TARGET(isa) __attribute__((target(isa)))
+	#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define _IRR_SIMD_NEON_
+	#include <arm_neon.h>
+#endif
+
+namespace irr {
+
+//! Instruction sets the vectorized code paths can use.
+//! The best one the CPU has is used, unless the IRRBLOSS_SIMD
+//! environment variable (none, sse2, ssse3 or avx2) asks for less.
+enum E_SIMD_LEVEL {
+	ESL_NONE = 0,
+	ESL_SSE2,
+	ESL_SSSE3,
+	ESL_AVX2,
+	ESL_NEON
+};
+
+E_SIMD_LEVEL getSIMDLevel();
+
+//! Uses level, or the best the CPU has if that is lower. ESL_NONE
+//! leaves only the scalar loops, to check the kernels against.
+void setSIMDLevel(E_SIMD_LEVEL level);
+
+} // end namespace irr
+
+#endif
@@ -14,6 +14,7 @@ public:
 	const std::string & get(const std::string & key) const;
 	bool getBool(const std::string & key) const;
 	int getInt(const std::string & key) const;
+	const std::map<std::string, std::string> & getAll() const { return settings; }
 
 	// Setters
 	void set(const std::string & key, const std::string & value);
@@ -4,9 +4,12 @@
 #include "modes/TextureEditor.hpp"
 #include "modes/NodeEditor.hpp"
 #include "util/string.hpp"
+#include "minetest.hpp"
+#include "project/texturewatcher.hpp"
 #include <ctime>
 #include <time.h>
 #include <math.h>
+#include <algorithm>
 
 Editor::Editor() :
 	state(NULL),
@@ -17,13 +20,28 @@ Editor::Editor() :
 	viewport_contextmenu(VIEW_NONE),
 	viewport_drag(VIEW_NONE),
 	click_handled(true),
-	middle_click_handled(true)
+	middle_click_handled(true),
+	recorder(NULL),
+	player(NULL),
+	frame(0)
 {
 	for (int i = 0; i < 4; i++) {
 		camera[i] = NULL;
 	}
 }
 
+Editor::~Editor()
+{
+	if (device)
+		device->setEventReceiver(NULL);
+	if (state) {
+		if (state->Mode())
+			state->Mode()->unload();
+		delete state->project;
+		delete state;
+	}
+}
+
 #ifdef _DEBUG
 #include <sstream>
 void debugRenderINT(int id, IrrlichtDevice *device, std::string name, int content)
@@ -87,12 +105,24 @@ bool Editor::run(IrrlichtDevice* irr_device, Configuration* conf,
 #endif
 
 	bool dosleep = state->settings->getBool("use_sleep");
+	size_t memory_budget = (size_t)std::max(0, state->settings->getInt("memory_budget")) * 1024 * 1024;
+	u32 last_budget_check = device->getTimer()->getRealTime();
+	u32 media_release_time = (u32)std::max(0, state->settings->getInt("media_release_time")) * 1000;
+	u32 last_media_release = last_budget_check;
+	TextureWatcher *texture_watcher = NULL;
+	if (state->settings->getBool("watch_textures"))
+		texture_watcher = new TextureWatcher(state);
 	u32 last = std::clock();
 	double dtime = 0;
+	frame = 0;
 	while (device->run()) {
 		if (state->NeedsClose()) {
 			device->closeDevice();
-			return true;
+			break;
+		}
+		if (player && !player->beginFrame(frame, device)) {
+			device->closeDevice();
+			break;
 		}
 
 		driver->beginScene(true, true, irr::video::SColor(255, 150, 150, 150));
@@ -180,6 +210,27 @@ bool Editor::run(IrrlichtDevice* irr_device, Configuration* conf,
 			state->Mode()->update(dtime);
 		}
 
+		// Notice when Minetest exits
+		if (state->minetest)
+			state->minetest->poll();
+
+		// Reload images saved by other programs
+		if (texture_watcher)
+			texture_watcher->update();
+
+		// Keep memory usage under budget
+		if (device->getTimer()->getRealTime() - last_budget_check > 1000) {
+			last_budget_check = device->getTimer()->getRealTime();
+			if (state->project)
+				state->project->enforceMemoryBudget(device, memory_budget);
+		}
+		if (media_release_time > 0 &&
+				device->getTimer()->getRealTime() - last_media_release > media_release_time) {
+			last_media_release = device->getTimer()->getRealTime();
+			if (state->project)
+				state->project->media.releaseIdle(device);
+		}
+
 		// Do perspective camera rotate
 		IGUIElement *el = state->device->getGUIEnvironment()->getFocus();
 		if (!el || el->getType() != EGUIET_EDIT_BOX) {
@@ -222,8 +273,15 @@ bool Editor::run(IrrlichtDevice* irr_device, Configuration* conf,
 
 		click_handled = true;
 		middle_click_handled = true;
+
+		if (player)
+			player->endFrame();
+		frame++;
 	}
 
+	delete texture_watcher;
+	if (recorder)
+		recorder->finish(frame);
 	return true;
 }
 
@@ -252,6 +310,17 @@ EViewport Editor::getViewportAt(vector2di pos)
 
 bool Editor::OnEvent(const SEvent& event)
 {
+	// Irrlicht's messages are written with the editor's
+	if (event.EventType == irr::EET_LOG_TEXT_EVENT) {
+		// ELL_NONE is for messages which are never filtered
+		static const ELogLevel levels[] = {ELV_VERBOSE, ELV_INFO, ELV_WARNING, ELV_ERROR, ELV_ERROR};
+		NBE_LOG(levels[event.LogEvent.Level], ELC_IRRLICHT, event.LogEvent.Text);
+		return true;
+	}
+
+	if (recorder)
+		recorder->record(frame, device->getTimer()->getTime(), event);
+
 	// Store mouse state in EditorState
 	if (event.EventType == irr::EET_MOUSE_INPUT_EVENT) {
 		if (event.MouseInput.Event == EMIE_LMOUSE_LEFT_UP) {
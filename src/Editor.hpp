@@ -3,14 +3,24 @@
 
 #include "common.hpp"
 #include "EditorState.hpp"
+#include "EventRecording.hpp"
 #include "project/project.hpp"
 
 class Editor : public IEventReceiver
 {
 public:
 	Editor();
+
+	// Deletes the project and the state. Call before dropping the device.
+	~Editor();
 	bool run(IrrlichtDevice *irr_device, Configuration *conf, bool editor_is_installed);
 	virtual bool OnEvent(const SEvent &event);
+
+	// Call before run(). The recorder is given every mouse and key event,
+	// and the player's events are fed in as if they came from the user,
+	// closing the editor once they run out.
+	void setRecorder(EventRecorder *rec) { recorder = rec; }
+	void setPlayer(EventPlayer *pl) { player = pl; }
 private:
 	void recreateCameras();
 	void applyCameraOffsets(EViewport i);
@@ -34,6 +44,10 @@ private:
 	EViewport viewport_contextmenu;
 	bool click_handled;
 	bool middle_click_handled;
+
+	EventRecorder *recorder;
+	EventPlayer *player;
+	u32 frame;
 };
 
 #endif
@@ -1,4 +1,5 @@
 #include "EditorState.hpp"
+#include "minetest.hpp"
 
 EditorState::EditorState(irr::IrrlichtDevice* dev, Project* proj, Configuration* settings) :
 	device(dev),
@@ -9,7 +10,9 @@ EditorState::EditorState(irr::IrrlichtDevice* dev, Project* proj, Configuration*
 	settings(settings),
 	close_requested(false),
 	modeCount(0),
-	menu(NULL)
+	menu(NULL),
+	threads(new ThreadPool()),
+	minetest(NULL)
 {
 	for (int i = 0; i < 5; i++) {
 		modes[i] = NULL;
@@ -20,6 +23,13 @@ EditorState::EditorState(irr::IrrlichtDevice* dev, Project* proj, Configuration*
 	}
 }
 
+EditorState::~EditorState()
+{
+	delete minetest;
+	// Joins the workers
+	delete threads;
+}
+
 void EditorState::AddMode(EditorMode* value)
 {
 	modes[modeCount] = value;
@@ -4,6 +4,8 @@
 #include "Configuration.hpp"
 #include "project/project.hpp"
 #include "MenuState.hpp"
+#include "util/ThreadPool.hpp"
+#include "util/Log.hpp"
 
 #define NUMBER_OF_KEYS 252
 enum EKeyState
@@ -15,10 +17,12 @@ enum EKeyState
 class Project;
 class EditorMode;
 class MenuState;
+class Minetest;
 class EditorState
 {
 public:
 	EditorState(irr::IrrlichtDevice* dev, Project* proj, Configuration* settings);
+	~EditorState();
 
 	// Irrlicht
 	ITriangleSelector* plane_tri;
@@ -38,7 +42,7 @@ public:
 	EditorMode* Mode() const
 	{
 		if (!Mode(currentmode))
-			std::cerr << "Warning! Null mode returned..." << std::endl;
+			NBE_LOG(ELV_WARNING, ELC_GENERAL, "Warning! Null mode returned...");
 		return Mode(currentmode);
 	}
 
@@ -55,6 +59,10 @@ public:
 
 	Configuration *settings;
 	MenuState *menu;
+	ThreadPool *threads;
+
+	// The game started by "Run in Minetest", or NULL
+	Minetest *minetest;
 
 	EViewportType getEViewportType(EViewport id);
 
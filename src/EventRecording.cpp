@@ -0,0 +1,299 @@
+#include "EventRecording.hpp"
+#include <string.h>
+#include "Configuration.hpp"
+#include "project/nodebox.hpp"
+#include "util/Log.hpp"
+
+#define RECORDING_END 0xFFFFFFFF
+
+// Flags for the modifier keys, and whether a key was pressed
+#define RECORDED_SHIFT   1
+#define RECORDED_CONTROL 2
+#define RECORDED_PRESSED 4
+
+static void writeValue(std::ofstream &file, const void *value, size_t size)
+{
+	file.write(static_cast<const char*>(value), size);
+}
+
+static void writeU8(std::ofstream &file, u8 value) { writeValue(file, &value, 1); }
+static void writeU16(std::ofstream &file, u16 value) { writeValue(file, &value, 2); }
+static void writeU32(std::ofstream &file, u32 value) { writeValue(file, &value, 4); }
+
+static void writeString(std::ofstream &file, const std::string &str)
+{
+	writeU16(file, str.size());
+	file.write(str.data(), str.size());
+}
+
+bool EventRecorder::start(const std::string &filename, const Configuration *settings,
+		dimension2du screen)
+{
+	file.open(filename.c_str(), std::ios::binary | std::ios::trunc);
+	if (!file) {
+		NBE_LOG(ELV_ERROR, ELC_FILES, "Unable to record events to " << filename);
+		return false;
+	}
+
+	file.write("NBER", 4);
+	writeU8(file, EVENT_RECORDING_VERSION);
+	writeU16(file, screen.Width);
+	writeU16(file, screen.Height);
+
+	const std::map<std::string, std::string> &all = settings->getAll();
+	writeU16(file, all.size());
+	for (std::map<std::string, std::string>::const_iterator it = all.begin();
+			it != all.end();
+			++it) {
+		writeString(file, it->first);
+		writeString(file, it->second);
+	}
+
+	NBE_LOG(ELV_INFO, ELC_FILES, "Recording events to " << filename);
+	return true;
+}
+
+void EventRecorder::record(u32 frame, u32 time, const SEvent &event)
+{
+	if (!file.is_open())
+		return;
+	if (event.EventType != EET_MOUSE_INPUT_EVENT &&
+			event.EventType != EET_KEY_INPUT_EVENT)
+		return;
+
+	if (frame != pending_frame)
+		flush();
+	if (pending.empty()) {
+		pending_frame = frame;
+		pending_time = time;
+	}
+	pending.push_back(event);
+}
+
+void EventRecorder::flush()
+{
+	if (pending.empty())
+		return;
+
+	writeU32(file, pending_frame);
+	writeU32(file, pending_time);
+	writeU16(file, pending.size());
+	for (std::vector<SEvent>::const_iterator it = pending.begin();
+			it != pending.end();
+			++it) {
+		if (it->EventType == EET_MOUSE_INPUT_EVENT) {
+			const SEvent::SMouseInput &mouse = it->MouseInput;
+			writeU8(file, EET_MOUSE_INPUT_EVENT);
+			writeU8(file, mouse.Event);
+			writeU16(file, (s16)mouse.X);
+			writeU16(file, (s16)mouse.Y);
+			writeValue(file, &mouse.Wheel, 4);
+			writeU8(file, mouse.ButtonStates);
+			writeU8(file, (mouse.Shift ? RECORDED_SHIFT : 0) |
+					(mouse.Control ? RECORDED_CONTROL : 0));
+		} else {
+			const SEvent::SKeyInput &key = it->KeyInput;
+			writeU8(file, EET_KEY_INPUT_EVENT);
+			writeU16(file, key.Key);
+			writeU32(file, key.Char);
+			writeU8(file, (key.Shift ? RECORDED_SHIFT : 0) |
+					(key.Control ? RECORDED_CONTROL : 0) |
+					(key.PressedDown ? RECORDED_PRESSED : 0));
+		}
+	}
+	pending.clear();
+}
+
+bool EventRecorder::finish(u32 frames)
+{
+	if (!file.is_open())
+		return false;
+
+	flush();
+	writeU32(file, RECORDING_END);
+	writeU32(file, frames);
+	file.close();
+	return !file.fail();
+}
+
+
+//
+// Replay
+//
+
+// Reads values from a loaded recording, failing once it runs out
+class RecordingReader
+{
+public:
+	RecordingReader(const std::vector<char> &data) : data(data), pos(0), ok(true) {}
+
+	void read(void *value, size_t size)
+	{
+		if (pos + size > data.size()) {
+			ok = false;
+			memset(value, 0, size);
+			return;
+		}
+		memcpy(value, &data[pos], size);
+		pos += size;
+	}
+
+	u8 readU8() { u8 value; read(&value, 1); return value; }
+	u16 readU16() { u16 value; read(&value, 2); return value; }
+	u32 readU32() { u32 value; read(&value, 4); return value; }
+
+	std::string readString()
+	{
+		u16 size = readU16();
+		if (pos + size > data.size()) {
+			ok = false;
+			return "";
+		}
+		std::string res(&data[pos], size);
+		pos += size;
+		return res;
+	}
+
+	bool atEnd() const { return pos >= data.size(); }
+
+	const std::vector<char> &data;
+	size_t pos;
+	bool ok;
+};
+
+bool EventPlayer::load(const std::string &filename)
+{
+	std::ifstream file(filename.c_str(), std::ios::binary);
+	if (!file) {
+		NBE_LOG(ELV_ERROR, ELC_FILES, "Unable to open recording " << filename);
+		return false;
+	}
+	std::vector<char> data((std::istreambuf_iterator<char>(file)),
+			std::istreambuf_iterator<char>());
+
+	RecordingReader reader(data);
+	char magic[4];
+	reader.read(magic, 4);
+	if (!reader.ok || memcmp(magic, "NBER", 4) != 0 ||
+			reader.readU8() != EVENT_RECORDING_VERSION) {
+		NBE_LOG(ELV_ERROR, ELC_FILES, filename << " is not a recording this version can play");
+		return false;
+	}
+	screen.Width = reader.readU16();
+	screen.Height = reader.readU16();
+
+	settings.clear();
+	u16 setting_count = reader.readU16();
+	for (u16 i = 0; i < setting_count && reader.ok; i++) {
+		std::string key = reader.readString();
+		std::string value = reader.readString();
+		settings.push_back(std::make_pair(key, value));
+	}
+
+	recorded.clear();
+	events.clear();
+	frames = 0;
+	while (reader.ok && !reader.atEnd()) {
+		RecordedFrame rec;
+		rec.frame = reader.readU32();
+		if (rec.frame == RECORDING_END) {
+			frames = reader.readU32();
+			break;
+		}
+		rec.time = reader.readU32();
+		rec.count = reader.readU16();
+		rec.first = events.size();
+		for (size_t i = 0; i < rec.count; i++) {
+			SEvent event;
+			memset(&event, 0, sizeof(event));
+			event.EventType = (EEVENT_TYPE)reader.readU8();
+			if (event.EventType == EET_MOUSE_INPUT_EVENT) {
+				SEvent::SMouseInput &mouse = event.MouseInput;
+				mouse.Event = (EMOUSE_INPUT_EVENT)reader.readU8();
+				mouse.X = (s16)reader.readU16();
+				mouse.Y = (s16)reader.readU16();
+				reader.read(&mouse.Wheel, 4);
+				mouse.ButtonStates = reader.readU8();
+				u8 flags = reader.readU8();
+				mouse.Shift = (flags & RECORDED_SHIFT) != 0;
+				mouse.Control = (flags & RECORDED_CONTROL) != 0;
+			} else if (event.EventType == EET_KEY_INPUT_EVENT) {
+				SEvent::SKeyInput &key = event.KeyInput;
+				key.Key = (EKEY_CODE)reader.readU16();
+				key.Char = (wchar_t)reader.readU32();
+				u8 flags = reader.readU8();
+				key.Shift = (flags & RECORDED_SHIFT) != 0;
+				key.Control = (flags & RECORDED_CONTROL) != 0;
+				key.PressedDown = (flags & RECORDED_PRESSED) != 0;
+			} else {
+				reader.ok = false;
+			}
+			events.push_back(event);
+		}
+		if (!reader.ok || (!recorded.empty() && rec.frame <= recorded.back().frame)) {
+			NBE_LOG(ELV_ERROR, ELC_FILES, filename << " is damaged");
+			return false;
+		}
+		recorded.push_back(rec);
+	}
+
+	// A session that didn't end cleanly stops after its last event
+	if (frames == 0 && !recorded.empty())
+		frames = recorded.back().frame + 1;
+
+	next = 0;
+	results.clear();
+	return true;
+}
+
+void EventPlayer::applySettings(Configuration *conf) const
+{
+	for (std::vector<std::pair<std::string, std::string> >::const_iterator it = settings.begin();
+			it != settings.end();
+			++it)
+		conf->set(it->first, it->second);
+
+	// Replays run as fast as they can
+	conf->set("use_sleep", "false");
+	conf->set("vsync", "false");
+}
+
+bool EventPlayer::beginFrame(u32 frame, IrrlichtDevice *device)
+{
+	if (frame >= frames)
+		return false;
+
+	ITimer *timer = device->getTimer();
+	if (frame == 0) {
+		if (!timer->isStopped())
+			timer->stop();
+		timer->setTime(recorded.empty() ? 0 : recorded.front().time);
+	}
+
+	current.frame = frame;
+	current.events = 0;
+	cpu_start = std::clock();
+	wall_start = std::chrono::steady_clock::now();
+	meshes_start = NodeBox::getMeshesBuilt();
+	allocs_start = allocation_counter ? allocation_counter() : 0;
+
+	if (next < recorded.size() && recorded[next].frame == frame) {
+		const RecordedFrame &rec = recorded[next];
+		timer->setTime(rec.time);
+		for (size_t i = 0; i < rec.count; i++)
+			device->postEventFromUser(events[rec.first + i]);
+		current.events = rec.count;
+		next++;
+	}
+	return true;
+}
+
+void EventPlayer::endFrame()
+{
+	current.cpu_ms = 1000.0 * (std::clock() - cpu_start) / CLOCKS_PER_SEC;
+	current.wall_ms = std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - wall_start).count();
+	current.meshes = NodeBox::getMeshesBuilt() - meshes_start;
+	current.allocs = allocation_counter ? allocation_counter() - allocs_start : 0;
+	results.push_back(current);
+}
@@ -0,0 +1,112 @@
+#ifndef EVENTRECORDING_HPP_INCLUDED
+#define EVENTRECORDING_HPP_INCLUDED
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "common.hpp"
+
+class Configuration;
+
+// A recording holds the settings and screen size the session started with,
+// followed by the mouse and key events of each frame that had any:
+//
+//     "NBER" version:u8 width:u16 height:u16
+//     settings:u16, then (key length:u16, key, value length:u16, value)...
+//     (frame:u32 time:u32 events:u16, then the events)...
+//     0xFFFFFFFF frames:u32
+//
+// time is the device's virtual time in milliseconds. Numbers are in the
+// machine's byte order, as in NBEBinary.
+#define EVENT_RECORDING_VERSION 1
+
+class EventRecorder
+{
+public:
+	EventRecorder() : pending_frame(0), pending_time(0) {}
+
+	bool start(const std::string &filename, const Configuration *settings,
+			dimension2du screen);
+
+	// Mouse and key events are kept, anything else is ignored
+	void record(u32 frame, u32 time, const SEvent &event);
+
+	// Writes the last frame's events and the frame count, and closes the file
+	bool finish(u32 frames);
+private:
+	void flush();
+
+	std::ofstream file;
+	std::vector<SEvent> pending; // Events of pending_frame
+	u32 pending_frame;
+	u32 pending_time;
+};
+
+// What a replayed frame cost, from before its events were posted until the
+// frame was drawn and updated
+struct ReplayFrame
+{
+	u32 frame;
+	u32 events;
+	double cpu_ms;             // Process CPU time, including worker threads
+	double wall_ms;
+	unsigned int meshes;       // Node boxes remeshed
+	unsigned long long allocs; // 0 unless there is an allocation counter
+};
+
+// Feeds a recording back into the editor, one recorded frame per frame and
+// without sleeping. The virtual timer is stopped and set to the recorded
+// time, so that double clicks and other timed GUI behaviour come out the
+// same, however fast the replay runs.
+class EventPlayer
+{
+public:
+	EventPlayer() : next(0), frames(0), allocation_counter(NULL) {}
+
+	bool load(const std::string &filename);
+
+	// Replaces conf's settings with the recorded ones
+	void applySettings(Configuration *conf) const;
+	dimension2du getScreenSize() const { return screen; }
+	u32 getFrameCount() const { return frames; }
+
+	// Returns the number of allocations made so far, such as from a
+	// replacement operator new
+	void setAllocationCounter(unsigned long long (*counter)()) { allocation_counter = counter; }
+
+	// Posts the events recorded for frame. Returns false once the recording
+	// has ended.
+	bool beginFrame(u32 frame, IrrlichtDevice *device);
+	void endFrame();
+
+	const std::vector<ReplayFrame> &getResults() const { return results; }
+private:
+	struct RecordedFrame
+	{
+		u32 frame;
+		u32 time;
+		size_t first; // Index into events
+		size_t count;
+	};
+
+	std::vector<std::pair<std::string, std::string> > settings;
+	dimension2du screen;
+	std::vector<RecordedFrame> recorded;
+	std::vector<SEvent> events;
+	size_t next; // The next recorded frame to play
+	u32 frames;
+	unsigned long long (*allocation_counter)();
+
+	// Of the frame being played
+	ReplayFrame current;
+	clock_t cpu_start;
+	std::chrono::steady_clock::time_point wall_start;
+	unsigned int meshes_start;
+	unsigned long long allocs_start;
+
+	std::vector<ReplayFrame> results;
+};
+
+#endif
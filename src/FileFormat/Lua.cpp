@@ -1,5 +1,5 @@
 #include <iostream>
-#include <fstream>
+#include <stdio.h>
 #include <string>
 #include <list>
 #include <stdexcept>
@@ -7,81 +7,186 @@
 #include "../project/project.hpp"
 #include "../project/node.hpp"
 #include "Lua.hpp"
-#include <sstream>
 #include "../util/filesys.hpp"
+#include "../util/string.hpp"
 
 bool LuaFileFormat::write(Project * project, const std::string & filename){
-	std::ofstream file(filename.c_str());
+	std::vector<const std::string*> blocks;
+	LuaCache *cache = update(project, blocks);
+
+	// Running in Minetest exports every time, usually with nothing changed
+	Revision revision = project->getRevision();
+	if (cache->filename == filename && cache->written == revision &&
+			FileSize(filename) == cache->written_size)
+		return true;
+
+	// Written block by block, rather than joined into one string first
+	FILE *file = fopen(filename.c_str(), "w");
 	if (!file) {
 		error_code = EFFE_IO_ERROR;
 		return false;
 	}
-	file << getAsString(project);
-	file.close();
+	std::string header = getHeader(project);
+	fwrite(header.data(), 1, header.size(), file);
+	for (std::vector<const std::string*>::const_iterator it = blocks.begin();
+			it != blocks.end();
+			++it)
+		fwrite((*it)->data(), 1, (*it)->size(), file);
+	bool failed = ferror(file) != 0;
+	if (fclose(file) != 0 || failed) {
+		error_code = EFFE_IO_ERROR;
+		cache->filename = "";
+		return false;
+	}
+
+	cache->filename = filename;
+	cache->written = revision;
+	cache->written_size = FileSize(filename);
 	return true;
 }
 
-std::string doTileImage(Node *node, ECUBE_SIDE face)
+static const std::string &doTileImage(Node *node, ECUBE_SIDE face)
 {
+	static const std::string def = "default_wood.png";
 	Media::Image *image = node->getTexture(face);
 	if (!image)
-		return "default_wood.png";
+		return def;
 
 	return image->name;
 }
 
-std::string LuaFileFormat::getAsString(Project *project)
+std::string LuaFileFormat::getHeader(Project *project) const
+{
+	std::string header = "-- GENERATED CODE\n";
+	header += "-- Node Box Editor, version ";
+	header += EDITOR_TEXT_VERSION;
+	header += "\n-- Namespace: " + project->name + "\n\n";
+	return header;
+}
+
+void LuaFileFormat::writeNode(std::string &out, Project *project, Node *node) const
+{
+	out += "minetest.register_node(\"";
+	out += project->name;
+	if (node->name == "")
+		out += ":node_1";
+	else
+		out += ":" + node->name;
+	out += "\", {\n";
+
+	static const ECUBE_SIDE faces[6] = {ECS_TOP, ECS_BOTTOM, ECS_RIGHT,
+			ECS_LEFT, ECS_BACK, ECS_FRONT};
+	out += "\ttiles = {\n";
+	for (int i = 0; i < 6; i++) {
+		out += "\t\t\"";
+		out += doTileImage(node, faces[i]);
+		out += (i < 5) ? "\",\n" : "\"\n";
+	}
+	out += "\t},\n";
+	out += "\tdrawtype = \"nodebox\",\n"
+		"\tparamtype = \"light\",\n"
+		"\tnode_box = {\n"
+		"\t\ttype = \"fixed\",\n"
+		"\t\tfixed = {\n";
+
+	std::vector<NodeBox*> & boxes = node->boxes;
+	for (std::vector<NodeBox*>::const_iterator it = boxes.begin();
+			it != boxes.end();
+			++it) {
+		NodeBox *box = *it;
+		out += "\t\t\t{";
+		append_float(out, box->one.X);
+		out += ", ";
+		append_float(out, box->one.Y);
+		out += ", ";
+		append_float(out, box->one.Z);
+		out += ", ";
+		append_float(out, box->two.X);
+		out += ", ";
+		append_float(out, box->two.Y);
+		out += ", ";
+		append_float(out, box->two.Z);
+		out += "}, -- ";
+		out += box->name;
+		out += "\n";
+	}
+
+	out += "\t\t}\n"
+		"\t}\n"
+		"})\n\n";
+}
+
+LuaCache *LuaFileFormat::update(Project *project, std::vector<const std::string*> &blocks)
 {
-	std::ostringstream file;
-	file << "-- GENERATED CODE\n";
-	file << "-- Node Box Editor, version " << EDITOR_TEXT_VERSION << '\n';
-	file << "-- Namespace: " << project->name << "\n\n";
+	if (!project->lua_cache)
+		project->lua_cache = new LuaCache();
+	LuaCache *cache = project->lua_cache;
+
+	// Every block starts with the project name
+	if (cache->name != project->name) {
+		cache->nodes.clear();
+		cache->name = project->name;
+	}
 
 	std::list<Node*> & nodes = project->nodes;
-	unsigned int i = 0;
+	blocks.reserve(nodes.size());
 	for (std::list<Node*>::const_iterator it = nodes.begin();
 			it != nodes.end();
-			++it, ++i) {
-		Node* node = *it;
-		file << "minetest.register_node(\"";
-		if (node->name == "") {
-			file << project->name << ":node_" << 1;
-		} else {
-			file << project->name << ":" << node->name;
-		}
-		file << "\", {\n";
-		file << "\ttiles = {\n";
-		file << "\t\t\"" << doTileImage(node, ECS_TOP).c_str() << "\",\n";
-		file << "\t\t\"" << doTileImage(node, ECS_BOTTOM).c_str() << "\",\n";
-		file << "\t\t\"" << doTileImage(node, ECS_RIGHT).c_str() << "\",\n";
-		file << "\t\t\"" << doTileImage(node, ECS_LEFT).c_str() << "\",\n";
-		file << "\t\t\"" << doTileImage(node, ECS_BACK).c_str() << "\",\n";
-		file << "\t\t\"" << doTileImage(node, ECS_FRONT).c_str() << "\"\n";
-		file << "\t},\n";
-		file << "\tdrawtype = \"nodebox\",\n"
-			"\tparamtype = \"light\",\n"
-			"\tnode_box = {\n"
-			"\t\ttype = \"fixed\",\n"
-			"\t\tfixed = {\n";
-
-		std::vector<NodeBox*> & boxes = node->boxes;
-		for (std::vector<NodeBox*>::const_iterator it = boxes.begin();
-				it != boxes.end();
-				++it) {
-			file << "\t\t\t{";
-			file << (*it)->one.X << ", " << (*it)->one.Y << ", " << (*it)->one.Z << ", ";
-			file << (*it)->two.X << ", " << (*it)->two.Y << ", " << (*it)->two.Z << "},";
-			file << " -- " << (*it)->name << "\n";
+			++it) {
+		Node *node = *it;
+		Revision revision = node->getRevision();
+		std::map<const Node*, LuaCache::NodeEntry>::iterator entry = cache->nodes.find(node);
+		if (entry == cache->nodes.end()) {
+			entry = cache->nodes.insert(std::make_pair(node, LuaCache::NodeEntry())).first;
+		} else if (entry->second.revision == revision) {
+			blocks.push_back(&entry->second.text);
+			continue;
 		}
 
-		file << "\t\t}\n"
-			"\t}\n"
-			"})\n\n";
+		entry->second.text.clear();
+		writeNode(entry->second.text, project, node);
+		entry->second.revision = revision;
+		blocks.push_back(&entry->second.text);
 	}
 
-	return file.str();
+	// Forget deleted nodes. A new node at the same address has a newer
+	// revision, so a stale entry could never be used, only take up memory.
+	if (cache->nodes.size() > nodes.size()) {
+		std::map<const Node*, LuaCache::NodeEntry> live;
+		size_t i = 0;
+		for (std::list<Node*>::const_iterator it = nodes.begin();
+				it != nodes.end();
+				++it, ++i) {
+			LuaCache::NodeEntry &entry = live[*it];
+			LuaCache::NodeEntry &old = cache->nodes[*it];
+			entry.text.swap(old.text);
+			entry.revision = old.revision;
+			blocks[i] = &entry.text;
+		}
+		cache->nodes.swap(live);
+	}
+
+	return cache;
 }
 
+std::string LuaFileFormat::getAsString(Project *project)
+{
+	std::vector<const std::string*> blocks;
+	update(project, blocks);
+
+	std::string res = getHeader(project);
+	size_t size = res.size();
+	for (std::vector<const std::string*>::const_iterator it = blocks.begin();
+			it != blocks.end();
+			++it)
+		size += (*it)->size();
+	res.reserve(size);
+	for (std::vector<const std::string*>::const_iterator it = blocks.begin();
+			it != blocks.end();
+			++it)
+		res += **it;
+	return res;
+}
 
 Project * LuaFileFormat::read(const std::string & file, Project *project)
 {
@@ -1,8 +1,35 @@
 #ifndef LUAFILEFORMAT_HPP_INCLUDED
 #define LUAFILEFORMAT_HPP_INCLUDED
 
+#include <map>
 #include "FileFormat.hpp"
 
+// Each node's register_node block as last exported, so that exporting
+// again only formats the nodes that have changed since.
+class LuaCache
+{
+public:
+	LuaCache():
+		written(0),
+		written_size(0)
+	{}
+
+	class NodeEntry
+	{
+	public:
+		std::string text;
+		Revision revision; // Node::getRevision() when text was made
+	};
+
+	std::string name; // The project name the blocks were made with
+	std::map<const Node*, NodeEntry> nodes;
+
+	// The last file written, so that an unchanged project isn't written again
+	std::string filename;
+	Revision written;
+	size_t written_size;
+};
+
 class LuaFileFormat : public FileFormat
 {
 public:
@@ -15,6 +42,11 @@ public:
 		return "lua";
 	}
 private:
+	// Brings the project's cache up to date, and lists the blocks in order
+	LuaCache *update(Project *project, std::vector<const std::string*> &blocks);
+	std::string getHeader(Project *project) const;
+	void writeNode(std::string &out, Project *project, Node *node) const;
+
 	EditorState* state;
 };
 
@@ -1,17 +1,20 @@
+#include <algorithm>
 #include <fstream>
+#include <sstream>
 #include <stdlib.h>
+#include <string.h>
+#include <fast_atof.h>
 #include "NBE.hpp"
+#include "NBEJournal.hpp"
+#include "NBEBinary.hpp"
 #include "../util/string.hpp"
 #include "../util/filesys.hpp"
 #include "../util/SimpleFileCombiner.hpp"
+#include "../util/MappedFile.hpp"
+#include "../util/Log.hpp"
 
 Project *NBEFileFormat::read(const std::string &filename, Project *project)
 {
-	std::string tmpdir = getTmpDirectory(state->isInstalled);
-	if (!CreateDir(tmpdir)) {
-		error_code = EFFE_IO_ERROR;
-		return NULL;
-	}
 	if (project) {
 		merging = true;
 	} else {
@@ -20,7 +23,8 @@ Project *NBEFileFormat::read(const std::string &filename, Project *project)
 		project->file = std::string(filename);
 	}
 	SimpleFileCombiner fc;
-	std::list<std::string> files = fc.read(filename.c_str(), tmpdir);
+	// Everything is read from memory, so nothing is extracted
+	std::list<std::string> files = fc.read(filename.c_str(), "");
 	if (files.size() == 0) {
 		if (fc.errcode == SimpleFileCombiner::EERR_WRONG_FILE) {
 			if (!readProjectFile(project, filename)) {
@@ -36,86 +40,465 @@ Project *NBEFileFormat::read(const std::string &filename, Project *project)
 		}
 	}
 
-	for (std::list<std::string>::const_iterator it = files.begin();
-			it != files.end();
+	const std::vector<char> *text = NULL;
+	const std::vector<char> *binary = NULL;
+	for (std::list<SimpleFileCombiner::File>::const_iterator it = fc.files.begin();
+			it != fc.files.end();
 			++it) {
-		std::string name = *it;
-		if (name != "project.txt") {
-			project->media.add(name.c_str(), name.c_str(), state->device->getVideoDriver()->createImageFromFile((tmpdir + name).c_str()));
+		if (it->name == "project.txt") {
+			text = &it->bytes;
+		} else if (it->name == "project.bin") {
+			binary = &it->bytes;
+		} else {
+			project->media.add("", it->name, it->bytes, state->device);
 		}
 	}
-	if (!readProjectFile(project, tmpdir + "project.txt")) {
+	size_t first_node = project->nodes.size();
+	bool loaded = false;
+	if (binary && !binary->empty()) {
+		loaded = NBEBinary::read(&(*binary)[0], binary->size(), project, state, merging);
+		if (!loaded)
+			NBE_LOG(ELV_WARNING, ELC_FILES, "project.bin is damaged or too new, reading project.txt");
+	}
+	if (!loaded && (!text || !readProjectText(project, text->empty() ? "" : &(*text)[0],
+			text->size(), "project.txt"))) {
+		if (!text)
+			error_code = EFFE_IO_ERROR;
 		delete project;
 		return NULL;
 	}
+	readJournal(project, filename, fc.data_end, first_node);
 	return project;
 }
 
 bool NBEFileFormat::write(Project *project, const std::string &filename)
+{
+	if (project->journal)
+		project->journal->waitForCompaction();
+
+	bool journaled = state->settings->getBool("journaled_saves");
+	if (journaled && project->journal && project->journal->filename == filename &&
+			FileSize(filename) == project->journal->file_size)
+		return writeJournal(project, filename);
+
+	SimpleFileCombiner fc;
+	if (!writeContainer(project, fc))
+		return false;
+
+	if (fc.write(filename)) {
+		if (journaled) {
+			resetJournal(project, filename);
+			project->journal->base_size = fc.getSize();
+			project->journal->file_size = fc.getSize();
+		}
+		return true;
+	} else {
+		if (fc.errcode == SimpleFileCombiner::EERR_IO)
+			error_code = EFFE_IO_ERROR;
+		return false;
+	}
+}
+
+bool NBEFileFormat::writeContainer(Project *project, SimpleFileCombiner &fc)
 {
 	std::string tmpdir = getTmpDirectory(state->isInstalled);
 	if (!CreateDir(tmpdir)) {
 		error_code = EFFE_IO_ERROR;
 		return false;
 	}
-	if (writeProjectFile(project, tmpdir + "project.txt")) {
-		SimpleFileCombiner fc;
-		fc.add((tmpdir + "project.txt").c_str(), "project.txt");
-		Media *media = &project->media;
-		std::map<std::string, Media::Image*>& images = media->getList();
-		for (std::map<std::string, Media::Image*>::const_iterator it = images.begin();
-				it != images.end();
-				++it) {
-			Media::Image *image = it->second;
-			if (!image->get()) {
-				std::cerr << "Image->get() is NULL!" << std::endl;
+	if (!writeProjectFile(project, tmpdir + "project.txt")) {
+		error_code = EFFE_IO_ERROR;
+		return false;
+	}
+
+	fc.add((tmpdir + "project.txt").c_str(), "project.txt");
+	if (state->settings->getBool("binary_project")) {
+		std::vector<char> binary;
+		NBEBinary::write(project, binary);
+		fc.add("project.bin", binary);
+	}
+	Media *media = &project->media;
+	u32 level = state->settings->getInt("save_compression");
+	media->encode(state->device->getVideoDriver(), state->threads, level);
+	const std::vector<Media::Image*> &images = media->getList();
+	for (std::vector<Media::Image*>::const_iterator it = images.begin();
+			it != images.end();
+			++it) {
+		Media::Image *image = *it;
+		const std::vector<char> *bytes = image->getEncoded(state->device->getVideoDriver(), level);
+		if (!bytes) {
+			NBE_LOG(ELV_ERROR, ELC_MEDIA, "Unable to encode " << image->name << "!");
+			continue;
+		}
+		fc.add(image->name, *bytes);
+	}
+	return true;
+}
+
+std::string NBEFileFormat::getNodeText(Node *node, unsigned int i)
+{
+	std::ostringstream text;
+	writeNode(text, node, i);
+	return text.str();
+}
+
+void NBEFileFormat::resetJournal(Project *project, const std::string &filename)
+{
+	if (!project->journal)
+		project->journal = new NBEJournal();
+
+	NBEJournal *journal = project->journal;
+	journal->filename = filename;
+	journal->name = project->name;
+	journal->nodes.clear();
+	journal->media.clear();
+
+	unsigned int i = 0;
+	for (std::list<Node*>::const_iterator it = project->nodes.begin();
+			it != project->nodes.end();
+			++it, ++i) {
+		NBEJournal::NodeEntry entry;
+		entry.key = i;
+		entry.text = getNodeText(*it, i);
+		entry.index = i;
+		entry.revision = (*it)->getRevision();
+		journal->nodes[(*it)->NodeId()] = entry;
+	}
+	journal->next_key = i;
+
+	const std::vector<Media::Image*> &images = project->media.getList();
+	for (std::vector<Media::Image*>::const_iterator it = images.begin();
+			it != images.end();
+			++it) {
+		const std::vector<char> *bytes = (*it)->getEncoded(state->device->getVideoDriver());
+		if (bytes) {
+			NBEJournal::MediaEntry entry = NBEJournal::getMediaEntry(*bytes);
+			entry.revision = (*it)->getRevision();
+			journal->media[(*it)->name] = entry;
+		}
+	}
+}
+
+bool NBEFileFormat::writeJournal(Project *project, const std::string &filename)
+{
+	NBEJournal *journal = project->journal;
+	std::vector<char> out;
+
+	if (project->name != journal->name) {
+		NBEJournal::appendRecord(out, NBEJR_PROJECT, "",
+				project->name.c_str(), project->name.size());
+		journal->name = project->name;
+	}
+
+	// Changed images
+	Media *media = &project->media;
+	u32 level = state->settings->getInt("save_compression");
+	media->encode(state->device->getVideoDriver(), state->threads, level);
+	const std::vector<Media::Image*> &images = media->getList();
+	for (std::vector<Media::Image*>::const_iterator it = images.begin();
+			it != images.end();
+			++it) {
+		Media::Image *image = *it;
+
+		std::map<std::string, NBEJournal::MediaEntry>::const_iterator saved =
+				journal->media.find(image->name);
+		if (saved != journal->media.end() && saved->second.revision == image->getRevision())
+			continue;
+
+		const std::vector<char> *bytes = image->getEncoded(state->device->getVideoDriver(), level);
+		if (!bytes || bytes->empty())
+			continue;
+
+		NBEJournal::MediaEntry entry = NBEJournal::getMediaEntry(*bytes);
+		entry.revision = image->getRevision();
+		if (saved != journal->media.end() && saved->second.size == entry.size &&
+				saved->second.hash == entry.hash) {
+			journal->media[image->name] = entry;
+			continue;
+		}
+
+		NBEJournal::appendRecord(out, NBEJR_MEDIA, image->name, &(*bytes)[0], bytes->size());
+		journal->media[image->name] = entry;
+	}
+
+	// Changed and new nodes
+	std::map<unsigned int, NBEJournal::NodeEntry> nodes;
+	unsigned int i = 0;
+	for (std::list<Node*>::const_iterator it = project->nodes.begin();
+			it != project->nodes.end();
+			++it, ++i) {
+		std::map<unsigned int, NBEJournal::NodeEntry>::const_iterator saved =
+				journal->nodes.find((*it)->NodeId());
+		if (saved != journal->nodes.end() && saved->second.index == i &&
+				saved->second.revision == (*it)->getRevision()) {
+			nodes[(*it)->NodeId()] = saved->second;
+			continue;
+		}
+
+		NBEJournal::NodeEntry entry;
+		entry.text = getNodeText(*it, i);
+		entry.index = i;
+		entry.revision = (*it)->getRevision();
+		if (saved != journal->nodes.end()) {
+			entry.key = saved->second.key;
+			if (saved->second.text == entry.text) {
+				nodes[(*it)->NodeId()] = entry;
 				continue;
 			}
-			state->device->getVideoDriver()->writeImageToFile(image->get(), (tmpdir + image->name).c_str());
-			fc.add(trim(tmpdir + image->name).c_str(), image->name);
-		}
-		if (fc.write(filename)) {
-			return true;
 		} else {
-			if (fc.errcode == SimpleFileCombiner::EERR_IO)
-				error_code = EFFE_IO_ERROR;
-			return false;
+			entry.key = journal->next_key++;
+		}
+
+		NBEJournal::appendRecord(out, NBEJR_NODE, num_to_str(entry.key),
+				entry.text.c_str(), entry.text.size());
+		nodes[(*it)->NodeId()] = entry;
+	}
+
+	// Deleted nodes
+	for (std::map<unsigned int, NBEJournal::NodeEntry>::const_iterator it = journal->nodes.begin();
+			it != journal->nodes.end();
+			++it) {
+		if (nodes.find(it->first) == nodes.end())
+			NBEJournal::appendRecord(out, NBEJR_DELETE, num_to_str(it->second.key), "", 0);
+	}
+	journal->nodes.swap(nodes);
+
+	if (out.empty())
+		return true;
+
+	std::ofstream file(filename.c_str(), std::ios::binary|std::ios::out|std::ios::app);
+	if (!file) {
+		error_code = EFFE_IO_ERROR;
+		return false;
+	}
+	file.write(&out[0], out.size());
+	file.close();
+	if (!file) {
+		// Unknown state, so write the whole file next time
+		delete project->journal;
+		project->journal = NULL;
+		error_code = EFFE_IO_ERROR;
+		return false;
+	}
+	journal->file_size += out.size();
+	NBE_LOG(ELV_VERBOSE, ELC_FILES, "Appended " << out.size() << " bytes to " << filename);
+
+	if (journal->needsCompaction()) {
+		SimpleFileCombiner fc;
+		if (writeContainer(project, fc)) {
+			resetJournal(project, filename);
+			journal->compact(fc);
 		}
 	}
 	return true;
 }
 
+void NBEFileFormat::readJournal(Project *project, const std::string &filename,
+		size_t start, size_t first_node)
+{
+	std::ifstream file(filename.c_str(), std::ios::binary|std::ios::ate);
+	if (!file)
+		return;
+
+	size_t size = (size_t)file.tellg();
+	if (size < start)
+		return;
+
+	std::vector<char> in(size - start);
+	file.seekg(start, std::ios::beg);
+	if (!in.empty())
+		file.read(&in[0], in.size());
+
+	// Nodes of the base are given keys in order
+	std::map<unsigned int, Node*> keys;
+	unsigned int next_key = 0;
+	std::list<Node*>::iterator it = project->nodes.begin();
+	std::advance(it, first_node);
+	for (; it != project->nodes.end(); ++it)
+		keys[next_key++] = *it;
+
+	size_t pos = 0;
+	char type;
+	std::string name;
+	std::vector<char> data;
+	while (NBEJournal::readRecord(in, pos, type, name, data)) {
+		switch (type) {
+		case NBEJR_PROJECT:
+			if (!merging)
+				project->name = std::string(data.begin(), data.end());
+			break;
+		case NBEJR_MEDIA:
+			project->media.add("", name, data, state->device, true);
+			break;
+		case NBEJR_NODE:
+		case NBEJR_DELETE: {
+			unsigned int key = atoi(name.c_str());
+			if (key >= next_key)
+				next_key = key + 1;
+
+			// Remove the old version, remembering where it was
+			std::list<Node*>::iterator position = project->nodes.end();
+			std::map<unsigned int, Node*>::iterator old = keys.find(key);
+			if (old != keys.end()) {
+				position = std::find(project->nodes.begin(), project->nodes.end(), old->second);
+				if (position != project->nodes.end()) {
+					delete *position;
+					position = project->nodes.erase(position);
+				}
+				keys.erase(old);
+			}
+			if (type == NBEJR_DELETE)
+				break;
+
+			size_t count = project->nodes.size();
+			stage = READ_STAGE_ROOT;
+			line_number = 0;
+			if (!data.empty())
+				parseText(project, &data[0], data.size(), filename);
+			if (node) {
+				delete node;
+				node = NULL;
+			}
+			if (project->nodes.size() == count)
+				break;
+
+			Node *added = project->nodes.back();
+			project->nodes.pop_back();
+			project->nodes.insert(position, added);
+			keys[key] = added;
+			break;
+		}}
+	}
+
+	if (pos < in.size())
+		NBE_LOG(ELV_WARNING, ELC_FILES, "Ignoring " << (in.size() - pos) << " bytes at the end of the journal");
+	if (merging || !state->settings->getBool("journaled_saves"))
+		return;
+
+	// Remember the file's keys, so the next save can append to it
+	resetJournal(project, filename);
+	NBEJournal *journal = project->journal;
+	for (std::map<unsigned int, Node*>::const_iterator it = keys.begin();
+			it != keys.end();
+			++it) {
+		journal->nodes[it->second->NodeId()].key = it->first;
+	}
+	journal->next_key = next_key;
+	journal->base_size = start;
+	journal->file_size = start + pos;
+}
+
 bool NBEFileFormat::readProjectFile(Project *project, const std::string & filename)
 {
-	// Open file
-	std::string line;
-	std::ifstream file(filename.c_str());
-	if (!file) {
+	// Parsed in place, as readProjectText() doesn't copy the text
+	MappedFile file;
+	if (!file.open(filename)) {
 		error_code = EFFE_IO_ERROR;
 		return false;
 	}
+	return readProjectText(project, file.size() ? file.data() : "", file.size(), filename);
+}
+
+// A piece of the text being parsed, which is neither copied nor terminated
+class TextRange
+{
+public:
+	TextRange(const char *start, const char *end):
+		start(start),
+		end(end)
+	{}
+
+	size_t size() const { return end - start; }
+	bool empty() const { return start == end; }
+	std::string str() const { return std::string(start, end); }
+
+	// Case insensitive, `keyword` must be lower case
+	bool is(const char *keyword) const
+	{
+		const char *c = start;
+		for (; *keyword && c != end; ++c, ++keyword) {
+			if (tolower((unsigned char)*c) != *keyword)
+				return false;
+		}
+		return *keyword == '\0' && c == end;
+	}
+
+	bool operator==(const char *other) const
+	{
+		return strlen(other) == size() && memcmp(start, other, size()) == 0;
+	}
+	bool operator!=(const char *other) const { return !(*this == other); }
+
+	const char *start;
+	const char *end;
+};
+
+static bool isSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Returns the next word, moving pos past it
+static TextRange nextToken(const char *&pos, const char *end)
+{
+	while (pos != end && isSpace(*pos))
+		++pos;
+	const char *start = pos;
+	while (pos != end && !isSpace(*pos))
+		++pos;
+	return TextRange(start, pos);
+}
+
+static TextRange trimRange(const char *start, const char *end)
+{
+	while (start != end && isSpace(*start))
+		++start;
+	while (end != start && isSpace(end[-1]))
+		--end;
+	return TextRange(start, end);
+}
+
+// Parses the whole token as a number, like atof() but quicker. On failure
+// result holds whatever could be parsed from the start of the token.
+static bool parseNumber(const TextRange &token, f32 &result)
+{
+	// fast_atof needs a terminated string, and numbers are short
+	char buffer[64];
+	size_t len = token.size() < sizeof(buffer) - 1 ? token.size() : sizeof(buffer) - 1;
+	memcpy(buffer, token.start, len);
+	buffer[len] = '\0';
+	const char *stop = core::fast_atof_move(buffer, result);
+	return len == token.size() && len > 0 && stop == buffer + len;
+}
+
+bool NBEFileFormat::readProjectText(Project *project, const char *text, size_t size,
+		const std::string &source)
+{
+	const char *end = text + size;
 
 	// Read parser header
-	std::getline(file, line);
-	if (line != "MINETEST NODEBOX EDITOR") {
+	const char *pos = text;
+	const char *eol = std::find(pos, end, '\n');
+	if (trimRange(pos, eol) != "MINETEST NODEBOX EDITOR") {
 		error_code = EFFE_READ_WRONG_TYPE;
 		return false;
 	}
-	std::getline(file, line);
-	if (line != "PARSER 1" && line != "PARSER 2") {
+	pos = (eol == end) ? end : eol + 1;
+	eol = std::find(pos, end, '\n');
+	TextRange version = trimRange(pos, eol);
+	if (version != "PARSER 1" && version != "PARSER 2") {
 		error_code = EFFE_READ_NEW_VERSION;
 		return false;
 	}
+	pos = (eol == end) ? end : eol + 1;
 
 	// Parse file
 	stage = READ_STAGE_ROOT;
-	while (std::getline(file, line)) {
-		parseLine(project, line);
-	}
-	file.close();
+	line_number = 2;
+	parseText(project, pos, end - pos, source);
 
 	if (node) {
-		std::cerr << "Unexpected EOF, expecting END NODE." << std::endl;
+		parseError(end, "Unexpected end of file, expecting END NODE");
 		error_code = EFFE_READ_PARSE_ERROR;
 		return false;
 	}
@@ -123,6 +506,31 @@ bool NBEFileFormat::readProjectFile(Project *project, const std::string & filena
 	return true;
 }
 
+void NBEFileFormat::parseText(Project *project, const char *text, size_t size,
+		const std::string &the_source)
+{
+	source = &the_source;
+	const char *end = text + size;
+	const char *pos = text;
+	while (pos != end) {
+		const char *eol = (const char*)memchr(pos, '\n', end - pos);
+		if (!eol)
+			eol = end;
+		line_number++;
+		line_start = pos;
+		parseLine(project, pos, eol);
+		pos = (eol == end) ? end : eol + 1;
+	}
+}
+
+void NBEFileFormat::parseError(const char *at, const char *message) const
+{
+	NBE_LOG(ELV_WARNING, ELC_FILES,
+			(source ? *source : std::string("project.txt")) << ":"
+			<< line_number << ":" << (at - line_start + 1) << ": "
+			<< message);
+}
+
 const char* getLabelForECUBE_SIDE(ECUBE_SIDE face)
 {
 	switch(face) {
@@ -141,17 +549,17 @@ const char* getLabelForECUBE_SIDE(ECUBE_SIDE face)
 	}
 }
 
-ECUBE_SIDE cubeSideFromString(std::string input)
+static ECUBE_SIDE cubeSideFromString(const TextRange &input)
 {
-	if (input == "left") {
+	if (input.is("left")) {
 		return ECS_LEFT;
-	} else if (input == "right") {
+	} else if (input.is("right")) {
 		return ECS_RIGHT;
-	} else if (input == "top") {
+	} else if (input.is("top")) {
 		return ECS_TOP;
-	} else if (input == "bottom") {
+	} else if (input.is("bottom")) {
 		return ECS_BOTTOM;
-	} else if (input == "front") {
+	} else if (input.is("front")) {
 		return ECS_FRONT;
 	} else { // input == "back"
 		return ECS_BACK;
@@ -173,34 +581,7 @@ bool NBEFileFormat::writeProjectFile(Project *project, const std::string &filena
 	for (std::list<Node*>::const_iterator it = nodes.begin();
 			it != nodes.end();
 			++it, ++i) {
-		Node* node = *it;
-		file << "NODE ";
-		if (node->name == "") {
-			file << "Node" << i;
-		} else {
-			file << node->name;
-		}
-		file << "\n";
-		vector3di pos = node->position;
-		file << "POSITION " << pos.X << ' ' << pos.Y << ' ' << pos.Z << '\n';
-
-		for (int i = 0; i < 6; i++) {
-			Media::Image* image = node->getTexture((ECUBE_SIDE)i);
-			if (image) {
-				file << "TEXTURE " << getLabelForECUBE_SIDE((ECUBE_SIDE)i) << " " << image->name.c_str() << "\n";
-			}
-		}
-
-		for (std::vector<NodeBox*>::const_iterator it = node->boxes.begin();
-				it != node->boxes.end();
-				++it) {
-			NodeBox* box = *it;
-			file << "NODEBOX " << box->name << ' ';
-			file << box->one.X << ' ' << box->one.Y << ' ' << box->one.Z << ' ';
-			file << box->two.X << ' ' << box->two.Y << ' ' << box->two.Z << '\n';
-		}
-
-		file << "END NODE\n\n";
+		writeNode(file, *it, i);
 	}
 
 	file.close();
@@ -208,23 +589,55 @@ bool NBEFileFormat::writeProjectFile(Project *project, const std::string &filena
 	return true;
 }
 
-void NBEFileFormat::parseLine(Project * project, std::string & line)
+void NBEFileFormat::writeNode(std::ostream &file, Node *node, unsigned int i)
 {
-	line = trim(line);
+	file << "NODE ";
+	if (node->name == "") {
+		file << "Node" << i;
+	} else {
+		file << node->name;
+	}
+	file << "\n";
+	vector3di pos = node->position;
+	file << "POSITION " << pos.X << ' ' << pos.Y << ' ' << pos.Z << '\n';
 
-	if (line.empty()) {
-		return;
+	for (int i = 0; i < 6; i++) {
+		Media::Image* image = node->getTexture((ECUBE_SIDE)i);
+		if (image) {
+			file << "TEXTURE " << getLabelForECUBE_SIDE((ECUBE_SIDE)i) << " " << image->name.c_str() << "\n";
+		}
+	}
+
+	for (std::vector<NodeBox*>::const_iterator it = node->boxes.begin();
+			it != node->boxes.end();
+			++it) {
+		NodeBox* box = *it;
+		file << "NODEBOX " << box->name << ' ';
+		file << box->one.X << ' ' << box->one.Y << ' ' << box->one.Z << ' ';
+		file << box->two.X << ' ' << box->two.Y << ' ' << box->two.Z << '\n';
 	}
 
-	std::string lower = str_to_lower(line);
+	file << "END NODE\n\n";
+}
+
+void NBEFileFormat::parseLine(Project *project, const char *start, const char *end)
+{
+	const char *pos = start;
+	TextRange keyword = nextToken(pos, end);
+	if (keyword.empty()) {
+		return;
+	}
+	TextRange rest = trimRange(pos, end);
 
 	if (stage == READ_STAGE_ROOT) {
-		if (lower.find("name ") == 0 && !merging) {
-			project->name = trim(line.substr(4));
-		} else if (lower.find("node ") == 0) {
+		if (keyword.is("name") && !rest.empty()) {
+			if (!merging)
+				project->name = rest.str();
+		} else if (keyword.is("node") && !rest.empty()) {
 			stage = READ_STAGE_NODE;
+			positioned = false;
 			node = new Node(state->device, state, project->GetNodeCount());
-			node->name = trim(line.substr(4));
+			node->name = rest.str();
 			std::list<Node*> & nodes = project->nodes;
 			for (std::list<Node*>::const_iterator it = nodes.begin();
 					it != nodes.end();
@@ -237,25 +650,22 @@ void NBEFileFormat::parseLine(Project * project, std::string & line)
 			}
 		}
 	} else if (stage == READ_STAGE_NODE) {
-		if (lower.find("position ") == 0) {
-			std::string n = trim(line.substr(8));
-			std::string s[3];
-			for (unsigned int i = 0; n != ""; i++){
-				size_t nid = n.find(" ");
-
-				if (nid == std::string::npos){
-					nid = n.size();
-				}
-				if (i >= 3) {
-					std::cerr << "Too many arguments in position tag" << std::endl;
+		if (keyword.is("position") && !rest.empty()) {
+			f32 v[3] = {0, 0, 0};
+			for (int i = 0; i < 3; i++) {
+				TextRange token = nextToken(pos, end);
+				if (token.empty()) {
+					parseError(token.start, "Expected 3 numbers in position tag");
 					break;
 				}
-				s[i] = trim(n.substr(0, nid));
-				n = trim(n.substr(nid));
+				if (!parseNumber(token, v[i]))
+					parseError(token.start, "Invalid number");
 			}
-			vector3di newpos((int)atof(s[0].c_str()),
-					(int)atof(s[1].c_str()),
-					(int)atof(s[2].c_str()));
+			TextRange extra = nextToken(pos, end);
+			if (!extra.empty())
+				parseError(extra.start, "Too many arguments in position tag");
+
+			vector3di newpos((int)v[0], (int)v[1], (int)v[2]);
 			if (merging) {
 				std::list<Node*> & nodes = project->nodes;
 				for (std::list<Node*>::const_iterator it = nodes.begin();
@@ -267,47 +677,40 @@ void NBEFileFormat::parseLine(Project * project, std::string & line)
 				}
 			}
 			node->position = newpos;
-		} else if (lower.find("texture ") == 0){
-			std::string n = trim(line.substr(7));
-			size_t nid = n.find(" ");
-			if (nid == std::string::npos || nid < 0){
-				nid = n.size();
-			}
-			std::string one = trim(n.substr(0, nid));
-			std::string two = trim(n.substr(nid));
-			node->setTexture(cubeSideFromString(one), project->media.get(two.c_str()));
-		} else if (lower.find("nodebox ") == 0) {
-			std::string n = trim(line.substr(7));
-			std::string s[7];
-			for (unsigned int i = 0; n != ""; i++){
-				size_t nid = n.find(" ");
-
-				if (nid == std::string::npos){
-					nid = n.size();
-				}
-				if (i >= 7) {
-					std::cerr << "Too many arguments in nodebox tag" << std::endl;
+			positioned = true;
+		} else if (keyword.is("texture") && !rest.empty()){
+			TextRange face = nextToken(pos, end);
+			TextRange image = trimRange(pos, end);
+			node->setTexture(cubeSideFromString(face),
+					project->media.get(image.start, image.size()));
+		} else if (keyword.is("nodebox") && !rest.empty()) {
+			TextRange name = nextToken(pos, end);
+			f32 v[6] = {0, 0, 0, 0, 0, 0};
+			for (int i = 0; i < 6; i++) {
+				TextRange token = nextToken(pos, end);
+				if (token.empty()) {
+					parseError(token.start, "Expected a name and 6 numbers in nodebox tag");
 					break;
 				}
-				s[i] = trim(n.substr(0, nid));
-				n = trim(n.substr(nid));
+				if (!parseNumber(token, v[i]))
+					parseError(token.start, "Invalid number");
 			}
+			TextRange extra = nextToken(pos, end);
+			if (!extra.empty())
+				parseError(extra.start, "Too many arguments in nodebox tag");
+
 			NodeBox *box = node->addNodeBox(
-				vector3df(
-					(f32)atof(s[1].c_str()),
-					(f32)atof(s[2].c_str()),
-					(f32)atof(s[3].c_str())
-				),
-				vector3df(
-					(f32)atof(s[4].c_str()),
-					(f32)atof(s[5].c_str()),
-					(f32)atof(s[6].c_str())
-				));
-			box->name = s[0];
-			box->rebuild_needed = true;
-			node->remesh(box);
-		} else if (lower.find("end node") == 0){
-			project->AddNode(node);
+				vector3df(v[0], v[1], v[2]),
+				vector3df(v[3], v[4], v[5]), false);
+			box->name = name.str();
+		} else if (keyword.is("end") && nextToken(pos, end).is("node")) {
+			// The meshes are built when the project is remeshed.
+			// AddNode moves nodes at the origin, so put it back if that
+			// was its position.
+			vector3di pos = node->position;
+			project->AddNode(node, true, false);
+			if (positioned)
+				node->position = pos;
 			node = NULL;
 			stage = READ_STAGE_ROOT;
 		}
@@ -1,8 +1,10 @@
 #ifndef NBEFILEFORMAT_HPP_INCLUDED
 #define NBEFILEFORMAT_HPP_INCLUDED
 
+#include <ostream>
 #include "FileFormat.hpp"
 #include "../project/node.hpp"
+#include "../util/SimpleFileCombiner.hpp"
 
 class NBEFileFormat : public FileFormat
 {
@@ -10,7 +12,12 @@ public:
 	NBEFileFormat(EditorState *st) :
 		state(st),
 		node(NULL),
-		stage(READ_STAGE_ROOT)
+		stage(READ_STAGE_ROOT),
+		merging(false),
+		positioned(false),
+		source(NULL),
+		line_number(0),
+		line_start(NULL)
 	{}
 	virtual Project *read(const std::string &filename, Project *project=NULL);
 	virtual bool write(Project *project, const std::string &filename);
@@ -27,9 +34,35 @@ private:
 	Node *node;
 	EditorState *state;
 	bool merging;
+	bool positioned;
 	bool readProjectFile(Project *project, const std::string &filename);
 	bool writeProjectFile(Project *project, const std::string &filename);
-	void parseLine(Project *project, std::string &line);
+	void writeNode(std::ostream &file, Node *node, unsigned int i);
+
+	// Parses project.txt in place, without copying lines or tokens.
+	// `source` is the name used in error messages, and line_number
+	// counts on from its value when parseText() is called.
+	bool readProjectText(Project *project, const char *text, size_t size,
+			const std::string &source);
+	void parseText(Project *project, const char *text, size_t size,
+			const std::string &source);
+	void parseLine(Project *project, const char *start, const char *end);
+
+	// Prints "source:line:column: message", for the character at `at`
+	void parseError(const char *at, const char *message) const;
+	const std::string *source;
+	unsigned int line_number;
+	const char *line_start;
+
+	// Adds project.txt and the images to fc
+	bool writeContainer(Project *project, SimpleFileCombiner &fc);
+
+	// Journaled saves, see NBEJournal.hpp
+	bool writeJournal(Project *project, const std::string &filename);
+	void readJournal(Project *project, const std::string &filename,
+			size_t start, size_t first_node);
+	void resetJournal(Project *project, const std::string &filename);
+	std::string getNodeText(Node *node, unsigned int i);
 };
 
 #endif
@@ -0,0 +1,240 @@
+#include "NBEBinary.hpp"
+#include <set>
+#include <string.h>
+#include "../project/project.hpp"
+#include "../util/NameTable.hpp"
+#include "../util/string.hpp"
+
+static void appendU32(std::vector<char> &out, u32 value)
+{
+	const char *bytes = static_cast<const char*>(static_cast<void*>(&value));
+	out.insert(out.end(), bytes, bytes + sizeof(u32));
+}
+
+static void appendColumn(std::vector<char> &out, const std::vector<f32> &column)
+{
+	if (column.empty())
+		return;
+	const char *bytes = static_cast<const char*>(static_cast<const void*>(&column[0]));
+	out.insert(out.end(), bytes, bytes + column.size() * sizeof(f32));
+}
+
+static void appendStrings(std::vector<char> &out, const NameTable &strings)
+{
+	appendU32(out, strings.size());
+	for (NameId id = 0; id < strings.size(); id++) {
+		const std::string &str = strings.get(id);
+		appendU32(out, str.size());
+		out.insert(out.end(), str.begin(), str.end());
+	}
+}
+
+void NBEBinary::write(Project *project, std::vector<char> &out)
+{
+	NameTable strings;
+	std::vector<u32> nodes;
+	std::vector<u32> box_names;
+	std::vector<f32> columns[6];
+
+	u32 name = strings.add(project->name);
+	unsigned int i = 0;
+	for (std::list<Node*>::const_iterator it = project->nodes.begin();
+			it != project->nodes.end();
+			++it, ++i) {
+		Node *node = *it;
+
+		// Same names as project.txt
+		nodes.push_back(strings.add(node->name == "" ? "Node" + num_to_str(i) : node->name));
+		nodes.push_back(node->position.X);
+		nodes.push_back(node->position.Y);
+		nodes.push_back(node->position.Z);
+		for (int face = 0; face < 6; face++) {
+			Media::Image *image = node->getTexture((ECUBE_SIDE)face);
+			nodes.push_back(image ? strings.add(image->name) : NBEB_NONE);
+		}
+		nodes.push_back(node->boxes.size());
+
+		for (std::vector<NodeBox*>::const_iterator it = node->boxes.begin();
+				it != node->boxes.end();
+				++it) {
+			NodeBox *box = *it;
+			box_names.push_back(strings.add(box->name));
+			columns[0].push_back(box->one.X);
+			columns[1].push_back(box->one.Y);
+			columns[2].push_back(box->one.Z);
+			columns[3].push_back(box->two.X);
+			columns[4].push_back(box->two.Y);
+			columns[5].push_back(box->two.Z);
+		}
+	}
+
+	out.insert(out.end(), "NBEB", "NBEB" + 4);
+	appendU32(out, NBEB_VERSION);
+	appendStrings(out, strings);
+	appendU32(out, name);
+	appendU32(out, project->nodes.size());
+	for (std::vector<u32>::const_iterator it = nodes.begin(); it != nodes.end(); ++it)
+		appendU32(out, *it);
+	appendU32(out, box_names.size());
+	for (std::vector<u32>::const_iterator it = box_names.begin(); it != box_names.end(); ++it)
+		appendU32(out, *it);
+	for (int c = 0; c < 6; c++)
+		appendColumn(out, columns[c]);
+}
+
+// Reads numbers and strings, failing once anything is out of range
+class BinaryReader
+{
+public:
+	BinaryReader(const char *data, size_t size):
+		pos(data),
+		end(data + size),
+		ok(true)
+	{}
+
+	u32 readU32()
+	{
+		u32 value = 0;
+		if (!has(sizeof(u32)))
+			return 0;
+		memcpy(&value, pos, sizeof(u32));
+		pos += sizeof(u32);
+		return value;
+	}
+
+	// Checks that `count` items of `size` bytes are left
+	bool has(size_t count, size_t size = 1)
+	{
+		if (!ok || count > (size_t)(end - pos) / size)
+			ok = false;
+		return ok;
+	}
+
+	const char *pos;
+	const char *end;
+	bool ok;
+};
+
+#define NODE_FIELDS 11
+
+bool NBEBinary::read(const char *data, size_t size, Project *project,
+		EditorState *state, bool merging)
+{
+	BinaryReader in(data, size);
+	if (!in.has(8) || memcmp(in.pos, "NBEB", 4) != 0)
+		return false;
+	in.pos += 4;
+	if (in.readU32() != NBEB_VERSION)
+		return false;
+
+	// Strings are used where they are in the data, until the nodes are made
+	u32 string_count = in.readU32();
+	if (!in.has(string_count, sizeof(u32)))
+		return false;
+	std::vector<const char*> string_data(string_count);
+	std::vector<u32> string_sizes(string_count);
+	for (u32 i = 0; i < string_count && in.ok; i++) {
+		string_sizes[i] = in.readU32();
+		if (in.has(string_sizes[i])) {
+			string_data[i] = in.pos;
+			in.pos += string_sizes[i];
+		}
+	}
+
+	u32 name = in.readU32();
+	u32 node_count = in.readU32();
+	if (!in.has(node_count, NODE_FIELDS * sizeof(u32)))
+		return false;
+	std::vector<u32> nodes(node_count * NODE_FIELDS);
+	if (!nodes.empty())
+		memcpy(&nodes[0], in.pos, nodes.size() * sizeof(u32));
+	in.pos += nodes.size() * sizeof(u32);
+
+	u32 box_count = in.readU32();
+	if (!in.has(box_count, sizeof(u32) + 6 * sizeof(f32)))
+		return false;
+	std::vector<u32> box_names(box_count);
+	if (box_count > 0)
+		memcpy(&box_names[0], in.pos, box_count * sizeof(u32));
+	in.pos += box_count * sizeof(u32);
+	std::vector<f32> columns[6];
+	for (int c = 0; c < 6; c++) {
+		columns[c].resize(box_count);
+		if (box_count > 0)
+			memcpy(&columns[c][0], in.pos, box_count * sizeof(f32));
+		in.pos += box_count * sizeof(f32);
+	}
+
+	// Check every reference before changing the project
+	if (!in.ok || name >= string_count)
+		return false;
+	u64 boxes_used = 0;
+	for (u32 i = 0; i < node_count; i++) {
+		const u32 *node = &nodes[i * NODE_FIELDS];
+		if (node[0] >= string_count)
+			return false;
+		for (int face = 0; face < 6; face++) {
+			if (node[4 + face] != NBEB_NONE && node[4 + face] >= string_count)
+				return false;
+		}
+		boxes_used += node[10];
+	}
+	if (boxes_used != box_count)
+		return false;
+	for (u32 i = 0; i < box_count; i++) {
+		if (box_names[i] >= string_count)
+			return false;
+	}
+
+	if (!merging)
+		project->name = std::string(string_data[name], string_sizes[name]);
+
+	std::set<std::string> names;
+	for (std::list<Node*>::const_iterator it = project->nodes.begin();
+			it != project->nodes.end();
+			++it) {
+		names.insert((*it)->name);
+	}
+
+	u32 box = 0;
+	for (u32 i = 0; i < node_count; i++) {
+		const u32 *fields = &nodes[i * NODE_FIELDS];
+		Node *node = new Node(state->device, state, project->GetNodeCount());
+
+		// Like project.txt, clashing names are replaced by AddNode()
+		node->name.assign(string_data[fields[0]], string_sizes[fields[0]]);
+		if (!names.insert(node->name).second)
+			node->name = "";
+
+		vector3di position((s32)fields[1], (s32)fields[2], (s32)fields[3]);
+		bool positioned = true;
+		if (merging && project->GetNode(position))
+			positioned = false;
+		else
+			node->position = position;
+
+		for (int face = 0; face < 6; face++) {
+			u32 texture = fields[4 + face];
+			if (texture != NBEB_NONE) {
+				node->setTexture((ECUBE_SIDE)face,
+						project->media.get(string_data[texture], string_sizes[texture]));
+			}
+		}
+
+		node->boxes.reserve(fields[10]);
+		for (u32 j = 0; j < fields[10]; j++, box++) {
+			NodeBox *added = node->addNodeBox(
+					vector3df(columns[0][box], columns[1][box], columns[2][box]),
+					vector3df(columns[3][box], columns[4][box], columns[5][box]),
+					false);
+			added->name.assign(string_data[box_names[box]], string_sizes[box_names[box]]);
+		}
+
+		project->AddNode(node, true, false);
+		if (positioned)
+			node->position = position;
+		if (node->name != "")
+			names.insert(node->name);
+	}
+	return true;
+}
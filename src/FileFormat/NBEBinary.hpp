@@ -0,0 +1,43 @@
+#ifndef NBEBINARY_HPP_INCLUDED
+#define NBEBINARY_HPP_INCLUDED
+
+#include <string>
+#include <vector>
+#include "../common.hpp"
+
+class EditorState;
+class Project;
+
+// project.bin holds the same project as project.txt, laid out in tables
+// that can be loaded without parsing any text. project.txt is still
+// written next to it, for older versions and for diffs.
+//
+// All numbers are 32 bits, in the byte order of the machine:
+//
+//   "NBEB", version
+//   string count, then each string as a length followed by its bytes
+//   project name (a string index)
+//   node count, then for each node:
+//     name, position X Y Z, the 6 face textures (string index, or
+//     NBEB_NONE), and the number of boxes
+//   box count, then the name of every box, followed by columns of every
+//   box's one.X, one.Y, one.Z, two.X, two.Y and two.Z (floats)
+//
+// The boxes are stored node by node, in the order of the node table.
+#define NBEB_VERSION 1
+#define NBEB_NONE 0xFFFFFFFF
+
+class NBEBinary
+{
+public:
+	static void write(Project *project, std::vector<char> &out);
+
+	// Adds the nodes to project. Returns false without changing the
+	// project if the data is damaged or from a newer version.
+	// When merging, the project's name is kept, and nodes that would
+	// overlap an existing node are placed elsewhere.
+	static bool read(const char *data, size_t size, Project *project,
+			EditorState *state, bool merging);
+};
+
+#endif
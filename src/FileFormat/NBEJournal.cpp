@@ -0,0 +1,130 @@
+#include "NBEJournal.hpp"
+#include <stdio.h>
+#include <string.h>
+#include "../util/Log.hpp"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#endif
+
+// Moves from over to, which may exist. rename() won't replace a file on
+// Windows.
+static bool replaceFile(const std::string &from, const std::string &to)
+{
+#ifdef _WIN32
+	if (MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING))
+		return true;
+	NBE_LOG(ELV_ERROR, ELC_FILES, "Unable to replace " << to << " (error " << GetLastError() << ")");
+#else
+	if (rename(from.c_str(), to.c_str()) == 0)
+		return true;
+	NBE_LOG(ELV_ERROR, ELC_FILES, "Unable to replace " << to << " (" << strerror(errno) << ")");
+#endif
+	return false;
+}
+
+class CompactionTask
+{
+public:
+	CompactionTask(const SimpleFileCombiner &fc, const std::string &filename):
+		fc(fc),
+		filename(filename)
+	{}
+
+	void operator()()
+	{
+		// Write next to the file, so it is never left half written
+		std::string tmp = filename + ".tmp";
+		if (!fc.write(tmp) || !replaceFile(tmp, filename))
+			NBE_LOG(ELV_ERROR, ELC_FILES, "Failed to compact " << filename);
+		else
+			NBE_LOG(ELV_VERBOSE, ELC_FILES, "Compacted " << filename);
+	}
+private:
+	SimpleFileCombiner fc;
+	std::string filename;
+};
+
+void NBEJournal::compact(const SimpleFileCombiner &fc)
+{
+	waitForCompaction();
+	compaction = std::thread(CompactionTask(fc, filename));
+	base_size = fc.getSize();
+	file_size = base_size;
+}
+
+void NBEJournal::waitForCompaction()
+{
+	if (compaction.joinable())
+		compaction.join();
+}
+
+static void appendBytes(std::vector<char> &out, const char *data, size_t size)
+{
+	unsigned int length = size;
+	const char *length_bytes = static_cast<const char*>(static_cast<void*>(&length));
+	out.insert(out.end(), length_bytes, length_bytes + sizeof(unsigned int));
+	out.insert(out.end(), data, data + size);
+}
+
+void NBEJournal::appendRecord(std::vector<char> &out, NBEJournalRecord type,
+		const std::string &name, const char *data, size_t size)
+{
+	out.insert(out.end(), "NBEJ", "NBEJ" + 4);
+	out.push_back((char)type);
+	appendBytes(out, name.c_str(), name.size());
+	appendBytes(out, data, size);
+}
+
+static bool readBytes(const std::vector<char> &in, size_t &pos, const char *&data, size_t &size)
+{
+	unsigned int length = 0;
+	if (in.size() - pos < sizeof(unsigned int))
+		return false;
+	memcpy(&length, &in[pos], sizeof(unsigned int));
+	pos += sizeof(unsigned int);
+	if (in.size() - pos < length)
+		return false;
+	data = in.empty() ? NULL : &in[0] + pos;
+	size = length;
+	pos += length;
+	return true;
+}
+
+bool NBEJournal::readRecord(const std::vector<char> &in, size_t &pos,
+		char &type, std::string &name, std::vector<char> &data)
+{
+	if (pos > in.size() || in.size() - pos < 5 || memcmp(&in[pos], "NBEJ", 4) != 0)
+		return false;
+
+	size_t p = pos + 4;
+	type = in[p++];
+
+	const char *name_data, *bytes;
+	size_t name_size, size;
+	if (!readBytes(in, p, name_data, name_size) || !readBytes(in, p, bytes, size))
+		return false;
+
+	name.assign(name_data, name_size);
+	data.assign(bytes, bytes + size);
+	pos = p;
+	return true;
+}
+
+NBEJournal::MediaEntry NBEJournal::getMediaEntry(const std::vector<char> &bytes)
+{
+	// FNV-1a
+	unsigned int hash = 2166136261u;
+	for (std::vector<char>::const_iterator it = bytes.begin();
+			it != bytes.end();
+			++it) {
+		hash = (hash ^ (unsigned char)*it) * 16777619u;
+	}
+
+	MediaEntry entry;
+	entry.size = bytes.size();
+	entry.hash = hash;
+	entry.revision = 0;
+	return entry;
+}
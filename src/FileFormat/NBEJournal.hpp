@@ -0,0 +1,85 @@
+#ifndef NBEJOURNAL_HPP_INCLUDED
+#define NBEJOURNAL_HPP_INCLUDED
+
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../util/SimpleFileCombiner.hpp"
+#include "../project/changes.hpp"
+
+// Journaled .nbe files are a normal .nbe file (the base), followed by
+// records of the changes made by each save since the base was written.
+// Older versions of the editor only read the base.
+//
+// Each record is "NBEJ", a type byte, then a name and data which are
+// each a length (unsigned int) followed by that many bytes.
+enum NBEJournalRecord
+{
+	NBEJR_PROJECT = 'P', // data is the project name
+	NBEJR_NODE = 'N',    // name is the node key, data is its project.txt block
+	NBEJR_DELETE = 'D',  // name is the node key
+	NBEJR_MEDIA = 'M'    // name is the image name, data is the file contents
+};
+
+// What was last written to a journaled file, so that the next save only
+// has to append the differences.
+class NBEJournal
+{
+public:
+	NBEJournal():
+		base_size(0),
+		file_size(0),
+		next_key(0)
+	{}
+	~NBEJournal() { waitForCompaction(); }
+
+	// The text is only made again when the node's revision or index in
+	// the project has changed.
+	class NodeEntry
+	{
+	public:
+		unsigned int key;
+		std::string text;
+		unsigned int index;
+		Revision revision;
+	};
+
+	class MediaEntry
+	{
+	public:
+		size_t size;
+		unsigned int hash;
+		Revision revision;
+	};
+
+	std::string filename;
+	size_t base_size;
+	size_t file_size;
+	std::string name;
+
+	// By Node::NodeId()
+	std::map<unsigned int, NodeEntry> nodes;
+	std::map<std::string, MediaEntry> media;
+	unsigned int next_key;
+
+	bool needsCompaction() const { return file_size - base_size > base_size; }
+
+	// Writes the full file on another thread, replacing the journaled one
+	void compact(const SimpleFileCombiner &fc);
+	void waitForCompaction();
+
+	static void appendRecord(std::vector<char> &out, NBEJournalRecord type,
+			const std::string &name, const char *data, size_t size);
+
+	// Reads the record at pos, returning false at the end of the journal
+	// or if the record is incomplete.
+	static bool readRecord(const std::vector<char> &in, size_t &pos,
+			char &type, std::string &name, std::vector<char> &data);
+
+	static MediaEntry getMediaEntry(const std::vector<char> &bytes);
+private:
+	std::thread compaction;
+};
+
+#endif
@@ -1,6 +1,8 @@
 #include "helpers.hpp"
 #include "../util/string.hpp"
 #include "../util/filesys.hpp"
+#include "../util/Log.hpp"
+#include "../project/preview.hpp"
 
 void save_file(FileFormat *writer, EditorState *state, std::string file, bool check_ext)
 {
@@ -14,7 +16,7 @@ void save_file(FileFormat *writer, EditorState *state, std::string file, bool ch
 		after += writer->getExtension();
 	}
 
-	std::cerr << "Saving to " << after << std::endl;
+	NBE_LOG(ELV_INFO, ELC_FILES, "Saving to " << after);
 
 	if (!writer->write(state->project, after)) {
 		if (writer->error_code == EFFE_IO_ERROR) {
@@ -29,23 +31,64 @@ void save_file(FileFormat *writer, EditorState *state, std::string file, bool ch
 	delete writer;
 }
 
-void export_textures(std::string dir, EditorState *state)
+void export_textures(std::string dir, EditorState *state, u32 level)
 {
 	if (dir == "")
 		return;
 
-	std::cerr << "Exporting Images to " << dir.c_str() << std::endl;
+	NBE_LOG(ELV_INFO, ELC_MEDIA, "Exporting Images to " << dir);
 	CreateDir(dir.c_str());
 	Media *media = &state->project->media;
-	std::map<std::string, Media::Image*>& images = media->getList();
-	for (std::map<std::string, Media::Image*>::const_iterator it = images.begin();
+	media->encode(state->device->getVideoDriver(), state->threads, level);
+	const std::vector<Media::Image*> &images = media->getList();
+	for (std::vector<Media::Image*>::const_iterator it = images.begin();
 			it != images.end();
 			++it) {
-		Media::Image *image = it->second;
-		if (!image->get()) {
-			std::cerr << "Image->get() is NULL!" << std::endl;
-			continue;
+		Media::Image *image = *it;
+		if (!image->write(state->device->getVideoDriver(), dir + image->name, level))
+			NBE_LOG(ELV_ERROR, ELC_MEDIA, "Unable to write " << image->name << "!");
+	}
+}
+
+bool export_inventory_images(std::string dir, EditorState *state, u32 size, u32 level)
+{
+	if (dir == "" || size == 0)
+		return false;
+
+	NBE_LOG(ELV_INFO, ELC_MEDIA, "Drawing inventory images to " << dir);
+	CreateDir(dir.c_str());
+
+	PreviewRenderer renderer(state);
+	std::vector<std::string> names;
+	unsigned int i = 0;
+	for (std::list<Node*>::const_iterator it = state->project->nodes.begin();
+			it != state->project->nodes.end();
+			++it, ++i) {
+		Node *node = *it;
+		renderer.add(node, size);
+		names.push_back(state->project->name + "_" +
+				(node->name == "" ? "node_" + num_to_str(i + 1) : node->name) + "_inv.png");
+	}
+
+	std::vector<IImage*> images;
+	renderer.render(images);
+
+	// Encoded on the thread pool, and only written if they've changed
+	Media previews;
+	for (size_t i = 0; i < images.size(); i++)
+		previews.add("", names[i], images[i], true);
+	IVideoDriver *driver = state->device->getVideoDriver();
+	previews.encode(driver, state->threads, level);
+
+	bool ok = true;
+	const std::vector<Media::Image*> &list = previews.getList();
+	for (std::vector<Media::Image*>::const_iterator it = list.begin();
+			it != list.end();
+			++it) {
+		if (!(*it)->write(driver, dir + (*it)->name, level)) {
+			NBE_LOG(ELV_ERROR, ELC_MEDIA, "Unable to write " << (*it)->name << "!");
+			ok = false;
 		}
-		state->device->getVideoDriver()->writeImageToFile(image->get(), (dir + image->name).c_str());
 	}
+	return ok;
 }
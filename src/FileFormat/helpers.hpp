@@ -5,6 +5,11 @@
 
 void save_file(FileFormat *writer, EditorState *state, std::string file, bool check_ext=true);
 
-void export_textures(std::string dir, EditorState *state);
+// level is the zlib level for images that need encoding, 0 for the default
+void export_textures(std::string dir, EditorState *state, u32 level = 0);
+
+// Draws each node as an inventory image, size pixels square, named
+// <project>_<node>_inv.png. Returns false if any couldn't be written.
+bool export_inventory_images(std::string dir, EditorState *state, u32 size, u32 level = 0);
 
 #endif
@@ -0,0 +1,693 @@
+#include "mesh.hpp"
+#include <string.h>
+#include <charconv>
+#include <map>
+#include <unordered_map>
+#include "../project/project.hpp"
+#include "../project/node.hpp"
+#include "../util/string.hpp"
+#include "../util/filesys.hpp"
+
+// The faces in the order and with the texture coordinates of
+// NodeBox::prepareMesh(). Corners are 0 for the box's low side on each
+// axis and 1 for its high side. The texture's u goes along u_axis, and
+// its v down v_axis.
+struct ExportFace
+{
+	ECUBE_SIDE side;
+	u8 corners[4][3];
+	f32 normal[3];
+	int u_axis;
+	f32 u_sign;
+	int v_axis;
+};
+
+static const ExportFace export_faces[6] = {
+	{ECS_FRONT,  {{0,0,0}, {1,0,0}, {1,1,0}, {0,1,0}}, { 0, 0,-1}, 0,  1.f, 1},
+	{ECS_BACK,   {{1,0,1}, {0,0,1}, {0,1,1}, {1,1,1}}, { 0, 0, 1}, 0, -1.f, 1},
+	{ECS_LEFT,   {{0,0,1}, {0,0,0}, {0,1,0}, {0,1,1}}, {-1, 0, 0}, 2, -1.f, 1},
+	{ECS_RIGHT,  {{1,0,0}, {1,0,1}, {1,1,1}, {1,1,0}}, { 1, 0, 0}, 2,  1.f, 1},
+	{ECS_TOP,    {{0,1,0}, {1,1,0}, {1,1,1}, {0,1,1}}, { 0, 1, 0}, 0,  1.f, 2},
+	{ECS_BOTTOM, {{0,0,1}, {1,0,1}, {1,0,0}, {0,0,0}}, { 0,-1, 0}, 0, -1.f, 2}
+};
+
+// Clockwise, as Irrlicht draws them
+static const u32 export_indices[6] = {0, 2, 1, 0, 3, 2};
+
+// Vertices are merged when all of their bytes match
+struct VertexHash
+{
+	size_t operator()(const ExportMesh::Vertex &v) const
+	{
+		u32 words[8];
+		memcpy(words, &v, sizeof(words));
+		size_t hash = 2166136261u;
+		for (int i = 0; i < 8; i++)
+			hash = (hash ^ words[i]) * 16777619u;
+		return hash ^ (hash >> 15);
+	}
+};
+
+struct VertexEqual
+{
+	bool operator()(const ExportMesh::Vertex &a, const ExportMesh::Vertex &b) const
+	{
+		return memcmp(&a, &b, sizeof(a)) == 0;
+	}
+};
+
+ExportMesh::ExportMesh(Node *node, unsigned int number):
+	name(node->name),
+	position(node->position)
+{
+	if (name == "")
+		name = "node_" + num_to_str(number);
+
+	// The group of each face, in the order of export_faces
+	size_t face_groups[6];
+	std::map<std::string, size_t> group_of;
+	for (int i = 0; i < 6; i++) {
+		Media::Image *image = node->getTexture(export_faces[i].side);
+		std::string texture = image ? image->name : "";
+		std::map<std::string, size_t>::const_iterator found = group_of.find(texture);
+		if (found == group_of.end()) {
+			face_groups[i] = groups.size();
+			group_of[texture] = groups.size();
+			groups.push_back(Group());
+			groups.back().texture = texture;
+		} else {
+			face_groups[i] = found->second;
+		}
+	}
+
+	std::unordered_map<Vertex, u32, VertexHash, VertexEqual> merged;
+	merged.reserve(node->boxes.size() * 24);
+	vertices.reserve(node->boxes.size() * 24);
+
+	for (std::vector<NodeBox*>::const_iterator it = node->boxes.begin();
+			it != node->boxes.end();
+			++it) {
+		const NodeBox *box = *it;
+		f32 sides[2][3] = {
+			{std::min(box->one.X, box->two.X), std::min(box->one.Y, box->two.Y),
+					std::min(box->one.Z, box->two.Z)},
+			{std::max(box->one.X, box->two.X), std::max(box->one.Y, box->two.Y),
+					std::max(box->one.Z, box->two.Z)}
+		};
+
+		for (int i = 0; i < 6; i++) {
+			const ExportFace &face = export_faces[i];
+			int normal_axis = face.normal[0] ? 0 : (face.normal[1] ? 1 : 2);
+			bool flat = false;
+			for (int axis = 0; axis < 3; axis++) {
+				if (axis != normal_axis && sides[0][axis] == sides[1][axis])
+					flat = true;
+			}
+			if (flat)
+				continue;
+
+			u32 ids[4];
+			for (int j = 0; j < 4; j++) {
+				Vertex v;
+				for (int axis = 0; axis < 3; axis++) {
+					// Adding 0 turns -0 into 0, so that they merge
+					v.position[axis] = sides[face.corners[j][axis]][axis] + 0.f;
+					v.normal[axis] = face.normal[axis];
+				}
+				v.uv[0] = face.u_sign * v.position[face.u_axis] + 0.5f + 0.f;
+				v.uv[1] = 0.5f - v.position[face.v_axis] + 0.f;
+
+				std::pair<std::unordered_map<Vertex, u32, VertexHash, VertexEqual>::iterator, bool>
+						res = merged.insert(std::make_pair(v, (u32)vertices.size()));
+				if (res.second)
+					vertices.push_back(v);
+				ids[j] = res.first->second;
+			}
+			std::vector<u32> &indices = groups[face_groups[i]].indices;
+			for (int j = 0; j < 6; j++)
+				indices.push_back(ids[export_indices[j]]);
+		}
+	}
+
+	// Faces with no area can leave a texture unused
+	for (size_t i = groups.size(); i-- > 0;) {
+		if (groups[i].indices.empty())
+			groups.erase(groups.begin() + i);
+	}
+}
+
+
+//
+// Binary helpers
+//
+
+// Numbers are written in the machine's byte order, which both formats
+// expect to be little endian.
+static void appendBytes(std::vector<char> &out, const void *data, size_t size)
+{
+	const char *bytes = static_cast<const char*>(data);
+	out.insert(out.end(), bytes, bytes + size);
+}
+
+static void appendU32(std::vector<char> &out, u32 value) { appendBytes(out, &value, 4); }
+static void appendF32(std::vector<char> &out, f32 value) { appendBytes(out, &value, 4); }
+
+static void patchU32(std::vector<char> &out, size_t pos, u32 value)
+{
+	memcpy(&out[pos], &value, 4);
+}
+
+static void appendPadding(std::vector<char> &out, char fill)
+{
+	while (out.size() % 4 != 0)
+		out.push_back(fill);
+}
+
+static void collectTextures(const std::vector<ExportMesh*> &meshes,
+		std::vector<std::string> &textures, std::map<std::string, u32> &ids)
+{
+	for (std::vector<ExportMesh*>::const_iterator it = meshes.begin();
+			it != meshes.end();
+			++it) {
+		for (size_t i = 0; i < (*it)->groups.size(); i++) {
+			const std::string &texture = (*it)->groups[i].texture;
+			if (texture != "" && ids.find(texture) == ids.end()) {
+				ids[texture] = textures.size();
+				textures.push_back(texture);
+			}
+		}
+	}
+}
+
+
+//
+// B3D
+//
+
+// Starts a chunk, returning where its size goes
+static size_t beginChunk(std::vector<char> &out, const char *tag)
+{
+	appendBytes(out, tag, 4);
+	appendU32(out, 0);
+	return out.size() - 4;
+}
+
+static void endChunk(std::vector<char> &out, size_t size_pos)
+{
+	patchU32(out, size_pos, out.size() - size_pos - 4);
+}
+
+static void appendCString(std::vector<char> &out, const std::string &str)
+{
+	appendBytes(out, str.c_str(), str.size() + 1);
+}
+
+static void appendB3DNode(std::vector<char> &out, const std::string &name, vector3df position)
+{
+	appendCString(out, name);
+	appendF32(out, position.X);
+	appendF32(out, position.Y);
+	appendF32(out, position.Z);
+	for (int i = 0; i < 3; i++)
+		appendF32(out, 1.f); // Scale
+	appendF32(out, 1.f);     // Rotation, as w x y z
+	for (int i = 0; i < 3; i++)
+		appendF32(out, 0.f);
+}
+
+static void appendB3DMesh(std::vector<char> &out, const ExportMesh *mesh,
+		const std::map<std::string, u32> &brushes)
+{
+	size_t mesh_chunk = beginChunk(out, "MESH");
+	appendU32(out, (u32)-1); // No brush for the whole mesh
+
+	size_t vrts = beginChunk(out, "VRTS");
+	appendU32(out, 1); // Normals, without colours
+	appendU32(out, 1); // One set of texture coordinates...
+	appendU32(out, 2); // ...of u and v
+	appendBytes(out, mesh->vertices.empty() ? NULL : &mesh->vertices[0],
+			mesh->vertices.size() * sizeof(ExportMesh::Vertex));
+	endChunk(out, vrts);
+
+	for (size_t i = 0; i < mesh->groups.size(); i++) {
+		const ExportMesh::Group &group = mesh->groups[i];
+		size_t tris = beginChunk(out, "TRIS");
+		std::map<std::string, u32>::const_iterator brush = brushes.find(group.texture);
+		appendU32(out, brush == brushes.end() ? (u32)-1 : brush->second);
+		appendBytes(out, &group.indices[0], group.indices.size() * 4);
+		endChunk(out, tris);
+	}
+	endChunk(out, mesh_chunk);
+}
+
+void meshesToB3D(const std::vector<ExportMesh*> &meshes, std::vector<char> &out)
+{
+	size_t reserve = 1024;
+	for (size_t i = 0; i < meshes.size(); i++) {
+		reserve += 256 + meshes[i]->vertices.size() * sizeof(ExportMesh::Vertex);
+		for (size_t j = 0; j < meshes[i]->groups.size(); j++)
+			reserve += 16 + meshes[i]->groups[j].indices.size() * 4;
+	}
+	out.clear();
+	out.reserve(reserve);
+
+	std::vector<std::string> textures;
+	std::map<std::string, u32> ids;
+	collectTextures(meshes, textures, ids);
+
+	size_t file = beginChunk(out, "BB3D");
+	appendU32(out, 1);
+
+	// One brush for each texture, with the same index
+	if (!textures.empty()) {
+		size_t texs = beginChunk(out, "TEXS");
+		for (size_t i = 0; i < textures.size(); i++) {
+			appendCString(out, textures[i]);
+			appendU32(out, 1); // Colour
+			appendU32(out, 2); // Multiply
+			appendF32(out, 0.f);
+			appendF32(out, 0.f);
+			appendF32(out, 1.f);
+			appendF32(out, 1.f);
+			appendF32(out, 0.f);
+		}
+		endChunk(out, texs);
+
+		size_t brus = beginChunk(out, "BRUS");
+		appendU32(out, 1); // Textures per brush
+		for (size_t i = 0; i < textures.size(); i++) {
+			appendCString(out, textures[i]);
+			for (int j = 0; j < 4; j++)
+				appendF32(out, 1.f); // Colour
+			appendF32(out, 0.f); // Shininess
+			appendU32(out, 1);   // Blend
+			appendU32(out, 0);   // Effects
+			appendU32(out, i);
+		}
+		endChunk(out, brus);
+	}
+
+	size_t root = beginChunk(out, "NODE");
+	if (meshes.size() == 1) {
+		appendB3DNode(out, meshes[0]->name, vector3df(0, 0, 0));
+		appendB3DMesh(out, meshes[0], ids);
+	} else {
+		appendB3DNode(out, "project", vector3df(0, 0, 0));
+		for (std::vector<ExportMesh*>::const_iterator it = meshes.begin();
+				it != meshes.end();
+				++it) {
+			size_t node = beginChunk(out, "NODE");
+			appendB3DNode(out, (*it)->name, vector3df((*it)->position.X,
+					(*it)->position.Y, (*it)->position.Z));
+			appendB3DMesh(out, *it, ids);
+			endChunk(out, node);
+		}
+	}
+	endChunk(out, root);
+	endChunk(out, file);
+}
+
+
+//
+// glTF
+//
+
+static void appendJSONString(std::string &out, const std::string &str)
+{
+	out += '"';
+	for (size_t i = 0; i < str.size(); i++) {
+		unsigned char c = str[i];
+		if (c == '"' || c == '\\') {
+			out += '\\';
+			out += c;
+		} else if (c < 0x20) {
+			char buf[8];
+			snprintf(buf, sizeof(buf), "\\u%04x", c);
+			out += buf;
+		} else {
+			out += c;
+		}
+	}
+	out += '"';
+}
+
+static void appendVec3(std::string &out, const f32 v[3])
+{
+	out += '[';
+	for (int i = 0; i < 3; i++) {
+		if (i > 0)
+			out += ',';
+		append_float(out, v[i]);
+	}
+	out += ']';
+}
+
+// Buffer views and accessors, which refer to each other by index
+class GLTFLayout
+{
+public:
+	std::string views;
+	std::string accessors;
+	u32 view_count;
+	u32 accessor_count;
+
+	GLTFLayout(): view_count(0), accessor_count(0) {}
+
+	u32 addView(size_t offset, size_t size, u32 stride, u32 target)
+	{
+		if (view_count > 0)
+			views += ',';
+		views += "{\"buffer\":0,\"byteOffset\":" + num_to_str(offset) +
+				",\"byteLength\":" + num_to_str(size);
+		if (stride)
+			views += ",\"byteStride\":" + num_to_str(stride);
+		views += ",\"target\":" + num_to_str(target) + "}";
+		return view_count++;
+	}
+
+	u32 addAccessor(u32 view, size_t offset, u32 type, size_t count, const char *shape,
+			const f32 *min = NULL, const f32 *max = NULL)
+	{
+		if (accessor_count > 0)
+			accessors += ',';
+		accessors += "{\"bufferView\":" + num_to_str(view) +
+				",\"byteOffset\":" + num_to_str(offset) +
+				",\"componentType\":" + num_to_str(type) +
+				",\"count\":" + num_to_str(count) +
+				",\"type\":\"" + shape + "\"";
+		if (min && max) {
+			accessors += ",\"min\":";
+			appendVec3(accessors, min);
+			accessors += ",\"max\":";
+			appendVec3(accessors, max);
+		}
+		accessors += '}';
+		return accessor_count++;
+	}
+};
+
+#define GLTF_ARRAY_BUFFER 34962
+#define GLTF_ELEMENT_ARRAY_BUFFER 34963
+#define GLTF_FLOAT 5126
+#define GLTF_UNSIGNED_SHORT 5123
+#define GLTF_UNSIGNED_INT 5125
+#define GLTF_NEAREST 9728
+
+// glTF is right handed, so z is flipped, and the triangles are turned
+// around to keep facing outwards.
+void meshesToGLB(const std::vector<ExportMesh*> &meshes, std::vector<char> &out)
+{
+	std::vector<std::string> textures;
+	std::map<std::string, u32> ids;
+	collectTextures(meshes, textures, ids);
+
+	std::vector<char> bin;
+	GLTFLayout layout;
+	std::string json_meshes, json_nodes, scene_nodes;
+	bool untextured = false;
+	u32 mesh_id = 0;
+	for (size_t m = 0; m < meshes.size(); m++) {
+		const ExportMesh *mesh = meshes[m];
+		if (mesh->vertices.empty())
+			continue;
+
+		// Vertices, interleaved
+		f32 min[3] = {1e30f, 1e30f, 1e30f};
+		f32 max[3] = {-1e30f, -1e30f, -1e30f};
+		size_t start = bin.size();
+		bin.resize(start + mesh->vertices.size() * sizeof(ExportMesh::Vertex));
+		ExportMesh::Vertex *dest = (ExportMesh::Vertex*)&bin[start];
+		for (std::vector<ExportMesh::Vertex>::const_iterator it = mesh->vertices.begin();
+				it != mesh->vertices.end();
+				++it, ++dest) {
+			*dest = *it;
+			dest->position[2] = -dest->position[2] + 0.f;
+			dest->normal[2] = -dest->normal[2] + 0.f;
+			for (int i = 0; i < 3; i++) {
+				min[i] = std::min(min[i], dest->position[i]);
+				max[i] = std::max(max[i], dest->position[i]);
+			}
+		}
+		u32 view = layout.addView(start, bin.size() - start, sizeof(ExportMesh::Vertex),
+				GLTF_ARRAY_BUFFER);
+		u32 positions = layout.addAccessor(view, 0, GLTF_FLOAT, mesh->vertices.size(),
+				"VEC3", min, max);
+		layout.addAccessor(view, 12, GLTF_FLOAT, mesh->vertices.size(), "VEC3");
+		layout.addAccessor(view, 24, GLTF_FLOAT, mesh->vertices.size(), "VEC2");
+
+		// Indices of every group, in one view
+		bool short_indices = mesh->vertices.size() <= 0xFFFF;
+		start = bin.size();
+		std::vector<size_t> offsets;
+		for (size_t g = 0; g < mesh->groups.size(); g++) {
+			const std::vector<u32> &indices = mesh->groups[g].indices;
+			offsets.push_back(bin.size() - start);
+			if (short_indices) {
+				size_t pos = bin.size();
+				bin.resize(pos + indices.size() * 2);
+				u16 *dest = (u16*)&bin[pos];
+				for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+					dest[i] = indices[i];
+					dest[i + 1] = indices[i + 2];
+					dest[i + 2] = indices[i + 1];
+				}
+			} else {
+				size_t pos = bin.size();
+				bin.resize(pos + indices.size() * 4);
+				u32 *dest = (u32*)&bin[pos];
+				for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+					dest[i] = indices[i];
+					dest[i + 1] = indices[i + 2];
+					dest[i + 2] = indices[i + 1];
+				}
+			}
+			appendPadding(bin, 0);
+		}
+		view = layout.addView(start, bin.size() - start, 0, GLTF_ELEMENT_ARRAY_BUFFER);
+
+		if (mesh_id > 0)
+			json_meshes += ',';
+		json_meshes += "{\"name\":";
+		appendJSONString(json_meshes, mesh->name);
+		json_meshes += ",\"primitives\":[";
+		for (size_t g = 0; g < mesh->groups.size(); g++) {
+			const ExportMesh::Group &group = mesh->groups[g];
+			u32 indices = layout.addAccessor(view, offsets[g],
+					short_indices ? GLTF_UNSIGNED_SHORT : GLTF_UNSIGNED_INT,
+					group.indices.size(), "SCALAR");
+			u32 material = textures.size();
+			if (group.texture != "")
+				material = ids[group.texture];
+			else
+				untextured = true;
+			if (g > 0)
+				json_meshes += ',';
+			json_meshes += "{\"attributes\":{\"POSITION\":" + num_to_str(positions) +
+					",\"NORMAL\":" + num_to_str(positions + 1) +
+					",\"TEXCOORD_0\":" + num_to_str(positions + 2) +
+					"},\"indices\":" + num_to_str(indices) +
+					",\"material\":" + num_to_str(material) + "}";
+		}
+		json_meshes += "]}";
+
+		if (mesh_id > 0)
+			json_nodes += ',';
+		json_nodes += "{\"name\":";
+		appendJSONString(json_nodes, mesh->name);
+		json_nodes += ",\"mesh\":" + num_to_str(mesh_id);
+		if (meshes.size() > 1) {
+			f32 translation[3] = {(f32)mesh->position.X, (f32)mesh->position.Y,
+					-(f32)mesh->position.Z + 0.f};
+			json_nodes += ",\"translation\":";
+			appendVec3(json_nodes, translation);
+		}
+		json_nodes += '}';
+		if (mesh_id > 0)
+			scene_nodes += ',';
+		scene_nodes += num_to_str(mesh_id);
+		mesh_id++;
+	}
+
+	// glTF doesn't allow empty arrays, so a file with no meshes has only
+	// its asset. Materials have the index of their texture, and the
+	// untextured one comes last.
+	std::string json = "{\"asset\":{\"version\":\"2.0\",\"generator\":\"NodeBoxEditor\"}";
+	if (mesh_id > 0) {
+		json += ",\"scene\":0,\"scenes\":[{\"nodes\":[" + scene_nodes + "]}]"
+				",\"nodes\":[" + json_nodes + "],\"meshes\":[" + json_meshes + "]";
+	}
+	if (!textures.empty() || untextured) {
+		json += ",\"materials\":[";
+		for (size_t i = 0; i < textures.size(); i++) {
+			if (i > 0)
+				json += ',';
+			json += "{\"name\":";
+			appendJSONString(json, textures[i]);
+			json += ",\"pbrMetallicRoughness\":{\"baseColorTexture\":{\"index\":" +
+					num_to_str(i) + "},\"metallicFactor\":0},\"alphaMode\":\"MASK\"}";
+		}
+		if (untextured) {
+			if (!textures.empty())
+				json += ',';
+			json += "{\"name\":\"untextured\",\"pbrMetallicRoughness\":{\"metallicFactor\":0}}";
+		}
+		json += ']';
+	}
+	if (!textures.empty()) {
+		json += ",\"samplers\":[{\"magFilter\":" + num_to_str(GLTF_NEAREST) +
+				",\"minFilter\":" + num_to_str(GLTF_NEAREST) + "}],\"textures\":[";
+		for (size_t i = 0; i < textures.size(); i++) {
+			if (i > 0)
+				json += ',';
+			json += "{\"sampler\":0,\"source\":" + num_to_str(i) + "}";
+		}
+		json += "],\"images\":[";
+		for (size_t i = 0; i < textures.size(); i++) {
+			if (i > 0)
+				json += ',';
+			json += "{\"uri\":";
+			appendJSONString(json, textures[i]);
+			json += '}';
+		}
+		json += ']';
+	}
+	if (layout.view_count > 0) {
+		json += ",\"buffers\":[{\"byteLength\":" + num_to_str(bin.size()) + "}]"
+				",\"bufferViews\":[" + layout.views + "]"
+				",\"accessors\":[" + layout.accessors + "]";
+	}
+	json += '}';
+	while (json.size() % 4 != 0)
+		json += ' ';
+
+	out.clear();
+	out.reserve(12 + 8 + json.size() + 8 + bin.size());
+	appendBytes(out, "glTF", 4);
+	appendU32(out, 2);
+	appendU32(out, 0);
+	appendU32(out, json.size());
+	appendBytes(out, "JSON", 4);
+	appendBytes(out, json.data(), json.size());
+	if (!bin.empty()) {
+		appendU32(out, bin.size());
+		appendBytes(out, "BIN\0", 4);
+		appendBytes(out, &bin[0], bin.size());
+	}
+	patchU32(out, 8, out.size());
+}
+
+
+//
+// Wavefront OBJ
+//
+
+// OBJ files are read with x flipped, so the triangles are turned around,
+// and with v going up
+void meshesToObj(const std::vector<ExportMesh*> &meshes, const std::string &mtl_name,
+		std::string &obj, std::string &mtl)
+{
+	size_t reserve = 64;
+	for (size_t i = 0; i < meshes.size(); i++)
+		reserve += meshes[i]->vertices.size() * 96 + meshes[i]->groups.size() * 64;
+	obj.clear();
+	obj.reserve(reserve);
+	obj += "mtllib " + mtl_name + ".mtl\n";
+
+	u32 first = 1;
+	for (std::vector<ExportMesh*>::const_iterator it = meshes.begin();
+			it != meshes.end();
+			++it) {
+		const ExportMesh *mesh = *it;
+		vector3df offset(0, 0, 0);
+		if (meshes.size() > 1)
+			offset = vector3df(mesh->position.X, mesh->position.Y, mesh->position.Z);
+
+		obj += "o " + str_replace(mesh->name, ' ', '_') + "\n";
+		for (size_t i = 0; i < mesh->vertices.size(); i++) {
+			const ExportMesh::Vertex &v = mesh->vertices[i];
+			obj += "v ";
+			append_float(obj, -(v.position[0] + offset.X) + 0.f);
+			obj += ' ';
+			append_float(obj, v.position[1] + offset.Y);
+			obj += ' ';
+			append_float(obj, v.position[2] + offset.Z);
+			obj += "\nvt ";
+			append_float(obj, v.uv[0]);
+			obj += ' ';
+			append_float(obj, 1.f - v.uv[1]);
+			obj += "\nvn ";
+			append_float(obj, -v.normal[0] + 0.f);
+			obj += ' ';
+			append_float(obj, v.normal[1]);
+			obj += ' ';
+			append_float(obj, v.normal[2]);
+			obj += '\n';
+		}
+
+		obj += "s off\n";
+		for (size_t g = 0; g < mesh->groups.size(); g++) {
+			const ExportMesh::Group &group = mesh->groups[g];
+			obj += "usemtl " + (group.texture == "" ? std::string("none") :
+					str_replace(group.texture, ' ', '_')) + "\n";
+			for (size_t i = 0; i + 2 < group.indices.size(); i += 3) {
+				obj += 'f';
+				static const int order[3] = {0, 2, 1};
+				for (int j = 0; j < 3; j++) {
+					char index[16];
+					size_t size = std::to_chars(index, index + sizeof(index),
+							group.indices[i + order[j]] + first).ptr - index;
+					for (int k = 0; k < 3; k++) {
+						obj += k == 0 ? ' ' : '/';
+						obj.append(index, size);
+					}
+				}
+				obj += '\n';
+			}
+		}
+		first += mesh->vertices.size();
+	}
+
+	std::vector<std::string> textures;
+	std::map<std::string, u32> ids;
+	collectTextures(meshes, textures, ids);
+	mtl = "newmtl none\n";
+	for (size_t i = 0; i < textures.size(); i++)
+		mtl += "\nnewmtl " + str_replace(textures[i], ' ', '_') + "\nmap_Kd " +
+				textures[i] + "\n";
+}
+
+
+bool exportMesh(Project *project, Node *node, const std::string &filename)
+{
+	std::vector<ExportMesh*> meshes;
+	unsigned int number = 1;
+	for (std::list<Node*>::const_iterator it = project->nodes.begin();
+			it != project->nodes.end();
+			++it, ++number) {
+		if (!node || *it == node)
+			meshes.push_back(new ExportMesh(*it, number));
+	}
+
+	std::string ext = str_to_lower(extFromFilename(filename));
+	bool ok;
+	if (ext == "obj") {
+		std::string obj, mtl;
+		meshesToObj(meshes, filenameWithoutExt(filename), obj, mtl);
+		std::string mtl_file = filename.substr(0, filename.size() - 3) + "mtl";
+		ok = syncFile(filename, obj.data(), obj.size()) &&
+				syncFile(mtl_file, mtl.data(), mtl.size());
+	} else {
+		std::vector<char> out;
+		if (ext == "glb")
+			meshesToGLB(meshes, out);
+		else
+			meshesToB3D(meshes, out);
+		ok = syncFile(filename, &out[0], out.size());
+	}
+
+	for (std::vector<ExportMesh*>::const_iterator it = meshes.begin();
+			it != meshes.end();
+			++it)
+		delete *it;
+	return ok;
+}
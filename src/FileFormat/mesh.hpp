@@ -0,0 +1,52 @@
+#ifndef MESH_HPP_INCLUDED
+#define MESH_HPP_INCLUDED
+
+#include <string>
+#include <vector>
+#include "../common.hpp"
+
+class Node;
+class Project;
+
+// A node's boxes as one mesh, with the vertices that boxes share merged,
+// and the triangles grouped by texture. Positions, normals and texture
+// coordinates are the ones buildMesh() draws, in Irrlicht's left handed
+// space and relative to the node's position. Faces with no area are left
+// out.
+class ExportMesh
+{
+public:
+	ExportMesh(Node *node, unsigned int number);
+
+	struct Vertex
+	{
+		f32 position[3];
+		f32 normal[3];
+		f32 uv[2];
+	};
+
+	class Group
+	{
+	public:
+		std::string texture; // Empty if the faces have none
+		std::vector<u32> indices;
+	};
+
+	std::string name;
+	vector3di position;
+	std::vector<Vertex> vertices;
+	std::vector<Group> groups;
+};
+
+// Each mesh is placed at its node's position, unless there is only one
+// mesh, which is left at the origin.
+void meshesToB3D(const std::vector<ExportMesh*> &meshes, std::vector<char> &out);
+void meshesToGLB(const std::vector<ExportMesh*> &meshes, std::vector<char> &out);
+void meshesToObj(const std::vector<ExportMesh*> &meshes, const std::string &mtl_name,
+		std::string &obj, std::string &mtl);
+
+// Writes node, or every node in the project if it is NULL, to a .b3d,
+// .glb or .obj file, picked by the filename's extension.
+bool exportMesh(Project *project, Node *node, const std::string &filename);
+
+#endif
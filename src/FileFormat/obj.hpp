@@ -1,8 +0,0 @@
-#ifndef OBJ_HPP_INCLUDED
-#define OBJ_HPP_INCLUDED
-
-#include "../project/node.hpp"
-
-std::string nodeToObj(Node *node, std::string filenameNoExt = "out");
-
-#endif
@@ -56,8 +56,10 @@ void MenuState::init()
 	submenu = submenu->getSubMenu(5);
 	submenu->addItem(L"Standalone Lua File (.lua)", GUI_FILE_EXPORT_LUA);
 	submenu->addItem(L"Minetest Mod", GUI_FILE_EXPORT_MOD);
-	submenu->addItem(L"Current node to mesh (.obj)", GUI_FILE_EXPORT_OBJ);
+	submenu->addItem(L"Current node to mesh (.b3d, .glb, .obj)", GUI_FILE_EXPORT_MESH);
+	submenu->addItem(L"All nodes to mesh (.b3d, .glb, .obj)", GUI_FILE_EXPORT_MESH_ALL);
 	submenu->addItem(L"Textures to Folder", GUI_FILE_EXPORT_TEX);
+	submenu->addItem(L"Inventory Images to Folder", GUI_FILE_EXPORT_INV);
 
 	// Edit
 	submenu = menubar->getSubMenu(1);
@@ -80,10 +82,16 @@ void MenuState::init()
 	submenu->addItem(L"Top Right", GUI_VIEW_SP_TOP);
 	submenu->addItem(L"Bottom Left", GUI_VIEW_SP_FRT);
 	submenu->addItem(L"Bottom Right", GUI_VIEW_SP_RHT);
+	submenu->addSeparator();
+	submenu->addItem(L"Memory Usage", GUI_VIEW_MEMORY);
 
 	// Project
 	projectMenubar = menubar->getSubMenu(3);
 	projectMenubar->addItem(L"Import Image", GUI_PROJ_IMAGE_IM);
+	projectMenubar->addSeparator();
+	projectMenubar->addItem(L"Merge Boxes", GUI_PROJ_UNITE);
+	projectMenubar->addItem(L"Cut Out Selected Box", GUI_PROJ_SUBTRACT);
+	projectMenubar->addItem(L"Keep Inside Selected Box", GUI_PROJ_INTERSECT);
 
 
 	// Help
@@ -171,13 +179,22 @@ bool MenuState::OnEvent(const SEvent& event)
 				FileDialog_save_project(state);
 				return true;
 			case GUI_FILE_RUN_IN_MINETEST: {
-				Minetest mt(state->settings);
-				if (!mt.findMinetest(state->isInstalled)) {
+				if (!state->minetest)
+					state->minetest = new Minetest(state->settings);
+				Minetest *mt = state->minetest;
+				if (mt->poll()) {
+					state->device->getGUIEnvironment()->addMessageBox(L"Minetest is running",
+							L"Close Minetest before running the project again.");
+					return true;
+				}
+				if (!mt->findMinetest(state->isInstalled)) {
 					state->device->getGUIEnvironment()->addMessageBox(L"Unable to find Minetest",
 							L"Minetest could not be found by NBE.\n\t(try setting 'minetest_root' in editor.conf)");
 					return true;
 				}
-				mt.runMod(state);
+				if (!mt->runMod(state))
+					state->device->getGUIEnvironment()->addMessageBox(L"Unable to run Minetest",
+							L"Minetest could not be started. See the log for details.");
 				return true;
 			}
 			case GUI_FILE_EXPORT_LUA:
@@ -186,12 +203,18 @@ bool MenuState::OnEvent(const SEvent& event)
 			case GUI_FILE_EXPORT_MOD:
 				FileDialog_export_mod(state);
 				return true;
-			case GUI_FILE_EXPORT_OBJ:
-				FileDialog_export_obj(state, state->project->GetCurrentNode());
+			case GUI_FILE_EXPORT_MESH:
+				FileDialog_export_mesh(state, state->project->GetCurrentNode());
+				return true;
+			case GUI_FILE_EXPORT_MESH_ALL:
+				FileDialog_export_mesh(state, NULL);
 				return true;
 			case GUI_FILE_EXPORT_TEX:
 				FileDialog_export_textures(state);
 				return true;
+			case GUI_FILE_EXPORT_INV:
+				FileDialog_export_inventory_images(state);
+				return true;
 			case GUI_FILE_IMPORT:
 				FileDialog_import(state);
 				return true;
@@ -223,6 +246,37 @@ bool MenuState::OnEvent(const SEvent& event)
 				menu->setItemChecked(menu->getSelectedItem(),
 						state->settings->getBool("limiting"));
 				return true;
+			case GUI_VIEW_MEMORY: {
+				if (!state->project)
+					return true;
+
+				MemoryUsage usage = state->project->getMemoryUsage();
+				std::string msg;
+				for (int i = 0; i < EMC_COUNT; i++) {
+					msg += std::string(getMemoryCategoryName((EMemoryCategory)i)) + ": " +
+							formatBytes(usage.get((EMemoryCategory)i)) + "\n";
+				}
+				msg += "\nTotal: " + formatBytes(usage.total()) +
+						" (CPU " + formatBytes(usage.getCPU()) +
+						", GPU " + formatBytes(usage.getGPU()) + ")\n";
+
+				Node *node = state->project->GetCurrentNode();
+				if (node) {
+					MemoryUsage node_usage;
+					node->getMemoryUsage(node_usage);
+					msg += "Current node: " + formatBytes(node_usage.total()) + "\n";
+				}
+
+				int budget = state->settings->getInt("memory_budget");
+				if (budget > 0)
+					msg += "Budget: " + num_to_str(budget) + " MB";
+				else
+					msg += "Budget: unlimited";
+
+				state->device->getGUIEnvironment()->addMessageBox(L"Memory Usage",
+						narrow_to_wide(msg).c_str());
+				return true;
+			}
 			case GUI_PROJ_IMAGE_IM:
 				ImageDialog::show(state, NULL, ECS_TOP);
 				return true;
@@ -16,8 +16,10 @@ enum GUI_ID
 	GUI_FILE_RUN_IN_MINETEST,
 	GUI_FILE_EXPORT_LUA,
 	GUI_FILE_EXPORT_MOD,
-	GUI_FILE_EXPORT_OBJ,
+	GUI_FILE_EXPORT_MESH,
+	GUI_FILE_EXPORT_MESH_ALL,
 	GUI_FILE_EXPORT_TEX,
+	GUI_FILE_EXPORT_INV,
 	GUI_FILE_IMPORT,
 	GUI_FILE_EXIT,
 
@@ -33,12 +35,16 @@ enum GUI_ID
 	GUI_VIEW_SP_TOP,
 	GUI_VIEW_SP_FRT,
 	GUI_VIEW_SP_RHT,
+	GUI_VIEW_MEMORY,
 
 	// Tools
 	GUI_PROJ_NEW_BOX,
 	GUI_PROJ_DELETE_BOX,
 	GUI_PROJ_CLONE,
 	GUI_PROJ_IMAGE_IM,
+	GUI_PROJ_UNITE,
+	GUI_PROJ_SUBTRACT,
+	GUI_PROJ_INTERSECT,
 
 	// Help
 	GUI_HELP_HELP,
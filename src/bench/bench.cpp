@@ -0,0 +1,992 @@
+// nbe_bench - microbenchmarks for the editor's hot paths
+//
+// Runs against the EDT_NULL driver, so no display is needed. Results are
+// written to stdout as one JSON object per line, progress goes to stderr.
+// Run from the source root so that media/ can be found.
+//
+//     ./bin/nbe_bench --sizes 1,10,100 --reps 5 > bench_output.txt
+//
+// With --replay, a session recorded with `nodeboxeditor --record <file>` is
+// played back through the editor instead, as fast as it will go:
+//
+//     ./bin/nbe_bench --replay session.nber --per-frame > replay_output.txt
+
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include "../common.hpp"
+#include "../Configuration.hpp"
+#include "../Editor.hpp"
+#include "../EditorState.hpp"
+#include "../EventRecording.hpp"
+#include "../project/project.hpp"
+#include "../project/node.hpp"
+#include "../project/nodebox.hpp"
+#include "../project/csg.hpp"
+#include "../project/preview.hpp"
+#include "../FileFormat/NBE.hpp"
+#include "../FileFormat/Lua.hpp"
+#include "../FileFormat/mesh.hpp"
+#include "../util/string.hpp"
+#include "../util/filesys.hpp"
+#include "../util/SimpleFileCombiner.hpp"
+#include "generator.hpp"
+
+//
+// Allocation counting
+//
+// Every allocation made through operator new, including those made by
+// Irrbloss, is counted while a benchmark is running.
+//
+
+static std::atomic<unsigned long long> alloc_count(0);
+static std::atomic<unsigned long long> alloc_bytes(0);
+
+static void *counted_alloc(size_t size)
+{
+	alloc_count.fetch_add(1, std::memory_order_relaxed);
+	alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+	void *ptr = malloc(size ? size : 1);
+	if (!ptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void *operator new(size_t size) { return counted_alloc(size); }
+void *operator new[](size_t size) { return counted_alloc(size); }
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete[](void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { free(ptr); }
+
+static unsigned long long countAllocations()
+{
+	return alloc_count.load(std::memory_order_relaxed);
+}
+
+
+//
+// Environment shared by all benchmarks
+//
+
+// Files the benchmarks write, in the system temp directory. Set in main.
+static std::string bench_dir;
+
+struct BenchEnv
+{
+	IrrlichtDevice *device;
+	EditorState *state;
+	unsigned int boxes_per_node;
+};
+
+static BenchEnv env;
+
+// Deterministic test image, so that PNG sizes are stable between runs.
+static IImage *createTestImage(u32 size)
+{
+	IImage *image = env.device->getVideoDriver()->createImage(ECF_A8R8G8B8,
+			dimension2d<u32>(size, size));
+	for (u32 y = 0; y < size; y++) {
+		for (u32 x = 0; x < size; x++) {
+			u32 v = (x * 31 + y * 17) & 0xFF;
+			image->setPixel(x, y, SColor(255, v, 255 - v, (x ^ y) & 0xFF));
+		}
+	}
+	return image;
+}
+
+static void fillNode(Node *node, unsigned int boxes)
+{
+	for (unsigned int i = 0; i < boxes; i++) {
+		f32 a = (f32)(i % 16) / 16.f - 0.5f;
+		f32 b = (f32)((i * 7) % 16) / 16.f - 0.5f;
+		node->addNodeBox(vector3df(a, -0.5f, b),
+				vector3df(a + 1.f / 16.f, b + 0.5f, 0.5f));
+	}
+}
+
+static Project *createTestProject(unsigned int nodes, unsigned int boxes)
+{
+	GeneratorSettings settings;
+	settings.nodes = nodes;
+	settings.boxes_per_node = boxes;
+	settings.textures = 4;
+	settings.build_mesh = true;
+	return generateProject(env.state, settings);
+}
+
+
+//
+// Harness
+//
+
+class Benchmark
+{
+public:
+	Benchmark(const std::string &name, const std::string &param):
+		name(name), param(param)
+	{}
+	virtual ~Benchmark() {}
+
+	virtual void setUp() {}
+	virtual void run() = 0;
+	virtual void tearDown() {}
+
+	// Number of operations a single call to run() performs.
+	virtual unsigned int opsPerRun() const { return 1; }
+
+	std::string name;
+	std::string param;
+};
+
+struct BenchOptions
+{
+	BenchOptions():
+		reps(5),
+		min_time_ms(50),
+		filter("")
+	{}
+
+	unsigned int reps;
+	unsigned int min_time_ms;
+	std::string filter;
+	std::vector<unsigned int> sizes;
+};
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double timeRuns(Benchmark *bench, unsigned long iterations)
+{
+	bench_clock::time_point start = bench_clock::now();
+	for (unsigned long i = 0; i < iterations; i++)
+		bench->run();
+	bench_clock::time_point end = bench_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+static void runBenchmark(Benchmark *bench, const BenchOptions &opts)
+{
+	std::cerr << "Running " << bench->name << " (" << bench->param << ")" << std::endl;
+	bench->setUp();
+
+	// Warm up and find an iteration count that fills min_time
+	double min_ns = opts.min_time_ms * 1e6;
+	unsigned long iterations = 1;
+	for (;;) {
+		double ns = timeRuns(bench, iterations);
+		if (ns >= min_ns || iterations >= (1ul << 24))
+			break;
+		unsigned long next = (unsigned long)(iterations * 1.2 * min_ns / (ns + 1));
+		iterations = std::max(iterations * 2, std::min(next, iterations * 100));
+	}
+
+	std::vector<double> samples;
+	unsigned long long allocs = 0;
+	unsigned long long bytes = 0;
+	for (unsigned int r = 0; r < opts.reps; r++) {
+		unsigned long long count_before = alloc_count.load();
+		unsigned long long bytes_before = alloc_bytes.load();
+		double ns = timeRuns(bench, iterations);
+		allocs = alloc_count.load() - count_before;
+		bytes = alloc_bytes.load() - bytes_before;
+		samples.push_back(ns / ((double)iterations * bench->opsPerRun()));
+	}
+	bench->tearDown();
+
+	std::sort(samples.begin(), samples.end());
+	double ops = (double)iterations * bench->opsPerRun();
+	std::cout << "{\"name\":\"" << bench->name << "\""
+		<< ",\"param\":\"" << bench->param << "\""
+		<< ",\"reps\":" << opts.reps
+		<< ",\"ops\":" << (unsigned long long)ops
+		<< ",\"ns_median\":" << samples[samples.size() / 2]
+		<< ",\"ns_min\":" << samples.front()
+		<< ",\"ns_max\":" << samples.back()
+		<< ",\"allocs_per_op\":" << allocs / ops
+		<< ",\"bytes_per_op\":" << bytes / ops
+		<< "}" << std::endl;
+}
+
+
+//
+// Benchmarks
+//
+
+class BuildMeshBench : public Benchmark
+{
+public:
+	BuildMeshBench(u32 texture_size):
+		Benchmark("NodeBox::buildMesh", "texture=" + num_to_str(texture_size)),
+		texture_size(texture_size), project(NULL), node(NULL)
+	{}
+
+	void setUp()
+	{
+		project = new Project();
+		project->media.add("", "texture.png", createTestImage(texture_size));
+		node = new Node(env.device, env.state, 0);
+		node->setAllTextures(project->media.get("texture.png"));
+		fillNode(node, 1);
+	}
+
+	void run() { node->remesh(true); }
+
+	void tearDown()
+	{
+		delete node;
+		delete project;
+	}
+private:
+	u32 texture_size;
+	Project *project;
+	Node *node;
+};
+
+class DarkenBench : public Benchmark
+{
+public:
+	DarkenBench(u32 texture_size):
+		Benchmark("darken", "texture=" + num_to_str(texture_size)),
+		texture_size(texture_size), image(NULL)
+	{}
+
+	void setUp() { image = createTestImage(texture_size); }
+
+	void run()
+	{
+		IVideoDriver *driver = env.device->getVideoDriver();
+		driver->removeTexture(darken(driver, image, 0.5f, "bench_darken"));
+	}
+
+	void tearDown() { image->drop(); }
+private:
+	u32 texture_size;
+	IImage *image;
+};
+
+// Converts an image of random pixels between color formats. Operations are
+// pixels, so ns_median is the time per pixel. Set IRRBLOSS_SIMD=none to
+// compare against the scalar converters.
+class ConvertBench : public Benchmark
+{
+public:
+	ConvertBench(ECOLOR_FORMAT from, ECOLOR_FORMAT to, u32 texture_size):
+		Benchmark("convert", std::string(ColorFormatNames[from]) + "->" +
+			ColorFormatNames[to] + " texture=" + num_to_str(texture_size)),
+		from(from), to(to), texture_size(texture_size), image(NULL)
+	{}
+
+	void setUp()
+	{
+		image = env.device->getVideoDriver()->createImage(from,
+				dimension2d<u32>(texture_size, texture_size));
+		u8 *data = (u8*)image->getData();
+		for (u32 i = 0; i < image->getImageDataSizeInBytes(); i++)
+			data[i] = (u8)rand();
+		target.resize(texture_size * texture_size *
+				IImage::getBitsPerPixelFromFormat(to) / 8);
+	}
+
+	void run() { image->copyToScaling(&target[0], texture_size, texture_size, to); }
+
+	unsigned int opsPerRun() const { return texture_size * texture_size; }
+
+	void tearDown() { image->drop(); }
+private:
+	ECOLOR_FORMAT from;
+	ECOLOR_FORMAT to;
+	u32 texture_size;
+	IImage *image;
+	std::vector<u8> target;
+};
+
+// Nearest neighbour enlarging of a texture to four times its size, as
+// for pixel art previews. Operations are target pixels.
+class ScaleBench : public Benchmark
+{
+public:
+	ScaleBench(u32 texture_size):
+		Benchmark("scale", "texture=" + num_to_str(texture_size) + "->" +
+			num_to_str(texture_size * 4)),
+		texture_size(texture_size), image(NULL)
+	{}
+
+	void setUp()
+	{
+		image = createTestImage(texture_size);
+		target.resize(texture_size * texture_size * 16 * 4);
+	}
+
+	void run()
+	{
+		image->copyToScaling(&target[0], texture_size * 4, texture_size * 4,
+				ECF_A8R8G8B8);
+	}
+
+	unsigned int opsPerRun() const { return texture_size * texture_size * 16; }
+
+	void tearDown() { image->drop(); }
+private:
+	u32 texture_size;
+	IImage *image;
+	std::vector<u8> target;
+};
+
+class NodeTransformBench : public Benchmark
+{
+public:
+	NodeTransformBench(bool flip, unsigned int boxes):
+		Benchmark(flip ? "Node::flip" : "Node::rotate", "boxes=" + num_to_str(boxes)),
+		flip(flip), boxes(boxes), project(NULL), axis(0)
+	{}
+
+	void setUp() { project = createTestProject(1, boxes); }
+
+	void run()
+	{
+		Node *node = project->GetNode(0);
+		if (flip)
+			node->flip((EAxis)axis);
+		else
+			node->rotate((EAxis)axis);
+		axis = (axis + 1) % 3;
+	}
+
+	void tearDown() { delete project; }
+private:
+	bool flip;
+	unsigned int boxes;
+	Project *project;
+	int axis;
+};
+
+class ProjectRemeshBench : public Benchmark
+{
+public:
+	ProjectRemeshBench(unsigned int nodes):
+		Benchmark("Project::remesh", "nodes=" + num_to_str(nodes)),
+		nodes(nodes), project(NULL)
+	{}
+
+	void setUp() { project = createTestProject(nodes, env.boxes_per_node); }
+
+	// Like switching modes with hide_other_nodes set
+	void run()
+	{
+		project->hideAllButCurrentNode();
+		project->remesh();
+	}
+
+	void tearDown() { delete project; }
+private:
+	unsigned int nodes;
+	Project *project;
+};
+
+class NBEWriteBench : public Benchmark
+{
+public:
+	NBEWriteBench(unsigned int nodes):
+		Benchmark("NBEFileFormat::write", "nodes=" + num_to_str(nodes)),
+		nodes(nodes), project(NULL)
+	{}
+
+	void setUp() { project = createTestProject(nodes, env.boxes_per_node); }
+
+	void run()
+	{
+		NBEFileFormat writer(env.state);
+		writer.write(project, bench_dir + "write.nbe");
+	}
+
+	void tearDown() { delete project; }
+private:
+	unsigned int nodes;
+	Project *project;
+};
+
+class NBEReadBench : public Benchmark
+{
+public:
+	NBEReadBench(unsigned int nodes):
+		Benchmark("NBEFileFormat::read", "nodes=" + num_to_str(nodes)),
+		nodes(nodes)
+	{}
+
+	void setUp()
+	{
+		Project *project = createTestProject(nodes, env.boxes_per_node);
+		NBEFileFormat writer(env.state);
+		writer.write(project, bench_dir + "read.nbe");
+		delete project;
+	}
+
+	void run()
+	{
+		NBEFileFormat reader(env.state);
+		delete reader.read(bench_dir + "read.nbe");
+	}
+private:
+	unsigned int nodes;
+};
+
+class CombinerBench : public Benchmark
+{
+public:
+	CombinerBench(bool read, unsigned int blob_size):
+		Benchmark(read ? "SimpleFileCombiner::read" : "SimpleFileCombiner::write",
+				"blob=" + num_to_str(blob_size)),
+		read(read), blob_size(blob_size)
+	{}
+
+	static const int BLOBS = 4;
+
+	void setUp()
+	{
+		std::vector<char> data(blob_size);
+		for (unsigned int i = 0; i < blob_size; i++)
+			data[i] = (char)(i * 2654435761u >> 24);
+		for (int i = 0; i < BLOBS; i++) {
+			std::ofstream file((bench_dir + "blob" + num_to_str(i)).c_str(),
+					std::ios::binary);
+			file.write(&data[0], data.size());
+		}
+		if (read)
+			combine();
+	}
+
+	void run()
+	{
+		if (read) {
+			SimpleFileCombiner fc;
+			fc.read((bench_dir + "blobs.nbe").c_str(), bench_dir + "extracted");
+		} else {
+			combine();
+		}
+	}
+private:
+	void combine()
+	{
+		SimpleFileCombiner fc;
+		for (int i = 0; i < BLOBS; i++)
+			fc.add((bench_dir + "blob" + num_to_str(i)).c_str(), "blob" + num_to_str(i));
+		fc.write(bench_dir + "blobs.nbe");
+	}
+
+	bool read;
+	unsigned int blob_size;
+};
+
+// Exports everything, or only one changed box since the last export
+class LuaBench : public Benchmark
+{
+public:
+	LuaBench(bool incremental, unsigned int nodes):
+		Benchmark(incremental ? "LuaFileFormat::write (one box changed)" :
+				"LuaFileFormat::write", "nodes=" + num_to_str(nodes)),
+		incremental(incremental), nodes(nodes), project(NULL), next(0)
+	{}
+
+	void setUp()
+	{
+		project = createTestProject(nodes, env.boxes_per_node);
+		list.assign(project->nodes.begin(), project->nodes.end());
+		LuaFileFormat writer(env.state);
+		writer.write(project, bench_dir + "init.lua");
+	}
+
+	void run()
+	{
+		if (incremental) {
+			list[next]->boxes[0]->changed();
+			next = (next + 1) % list.size();
+		} else {
+			delete project->lua_cache;
+			project->lua_cache = NULL;
+		}
+
+		LuaFileFormat writer(env.state);
+		writer.write(project, bench_dir + "init.lua");
+	}
+
+	void tearDown() { delete project; }
+private:
+	bool incremental;
+	unsigned int nodes;
+	Project *project;
+	std::vector<Node*> list;
+	unsigned int next;
+};
+
+// Cuts a box through the middle of many overlapping boxes on the 1/16 grid
+class CSGBench : public Benchmark
+{
+public:
+	CSGBench(ECSGOperation op, unsigned int boxes):
+		Benchmark(op == ECSG_UNION ? "combineBoxes (union)" : "combineBoxes (subtract)",
+				"boxes=" + num_to_str(boxes)),
+		op(op), boxes(boxes)
+	{}
+
+	void setUp()
+	{
+		for (unsigned int i = 0; i < boxes; i++) {
+			f32 x = (f32)((i * 5) % 14) / 16.f - 0.5f;
+			f32 y = (f32)((i * 3) % 12) / 16.f - 0.5f;
+			f32 z = (f32)((i * 7) % 13) / 16.f - 0.5f;
+			a.push_back(aabbox3df(x, y, z, x + 3.f / 16.f, y + 5.f / 16.f, z + 4.f / 16.f));
+		}
+		b.push_back(aabbox3df(-0.25f, -0.5f, -0.25f, 0.25f, 0.5f, 0.25f));
+	}
+
+	void run() { combineBoxes(op, a, b, out); }
+	void tearDown() { a.clear(); b.clear(); }
+private:
+	ECSGOperation op;
+	unsigned int boxes;
+	std::vector<aabbox3df> a, b, out;
+};
+
+// Merges a node's boxes into one mesh, and writes it to memory
+class MeshExportBench : public Benchmark
+{
+public:
+	MeshExportBench(const std::string &format, unsigned int boxes):
+		Benchmark("ExportMesh (" + format + ")", "boxes=" + num_to_str(boxes)),
+		format(format), boxes(boxes), project(NULL)
+	{}
+
+	void setUp() { project = createTestProject(1, boxes); }
+
+	void run()
+	{
+		std::vector<ExportMesh*> meshes;
+		meshes.push_back(new ExportMesh(project->GetNode(0), 1));
+		std::vector<char> out;
+		if (format == "b3d") {
+			meshesToB3D(meshes, out);
+		} else if (format == "glb") {
+			meshesToGLB(meshes, out);
+		} else {
+			std::string obj, mtl;
+			meshesToObj(meshes, "out", obj, mtl);
+		}
+		delete meshes[0];
+	}
+
+	void tearDown() { delete project; }
+private:
+	std::string format;
+	unsigned int boxes;
+	Project *project;
+};
+
+// Draws every node's inventory image, as the export does
+class PreviewBench : public Benchmark
+{
+public:
+	PreviewBench(unsigned int nodes):
+		Benchmark("PreviewRenderer::render", "nodes=" + num_to_str(nodes) + " size=64"),
+		nodes(nodes), project(NULL)
+	{}
+
+	void setUp() { project = createTestProject(nodes, env.boxes_per_node); }
+
+	void run()
+	{
+		PreviewRenderer renderer(env.state);
+		for (std::list<Node*>::const_iterator it = project->nodes.begin();
+				it != project->nodes.end();
+				++it)
+			renderer.add(*it, 64);
+
+		std::vector<IImage*> images;
+		renderer.render(images);
+		for (size_t i = 0; i < images.size(); i++)
+			images[i]->drop();
+	}
+
+	void tearDown() { delete project; }
+private:
+	unsigned int nodes;
+	Project *project;
+};
+
+// Picks a node's mesh with a patch of rays, like the pixels around the
+// cursor, one at a time or all at once. Operations are rays. Set
+// IRRBLOSS_SIMD=none to compare against the scalar ray test.
+class RaycastBench : public Benchmark
+{
+public:
+	RaycastBench(bool batch, unsigned int boxes):
+		Benchmark(batch ? "ISceneCollisionManager::getCollisionPoints" :
+				"ISceneCollisionManager::getCollisionPoint",
+				"boxes=" + num_to_str(boxes) + " rays=64"),
+		batch(batch), boxes(boxes), selector(NULL)
+	{}
+
+	void setUp()
+	{
+		Project *project = createTestProject(1, boxes);
+		ExportMesh exported(project->GetNode(0), 1);
+		delete project;
+
+		// Unshared vertices, so that big nodes can be split between buffers
+		// without running out of 16 bit indices
+		SMesh *mesh = new SMesh();
+		SMeshBuffer *buffer = NULL;
+		for (size_t i = 0; i < exported.groups.size(); i++) {
+			const std::vector<u32> &indices = exported.groups[i].indices;
+			for (size_t j = 0; j < indices.size(); j++) {
+				if (j % 3 == 0 && (!buffer || buffer->Vertices.size() > 0xFFFF - 3)) {
+					buffer = new SMeshBuffer();
+					mesh->addMeshBuffer(buffer);
+					buffer->drop();
+				}
+				const ExportMesh::Vertex &v = exported.vertices[indices[j]];
+				buffer->Indices.push_back((u16)buffer->Vertices.size());
+				buffer->Vertices.push_back(S3DVertex(
+						v.position[0], v.position[1], v.position[2],
+						v.normal[0], v.normal[1], v.normal[2],
+						SColor(255, 255, 255, 255), v.uv[0], v.uv[1]));
+			}
+		}
+		selector = env.device->getSceneManager()->
+				createOctreeTriangleSelector(mesh, NULL, 32);
+		mesh->drop();
+
+		const vector3df eye(0.3f, 1.5f, -2.f);
+		rays.clear();
+		for (int y = 0; y < 8; y++)
+		for (int x = 0; x < 8; x++) {
+			const vector3df target(-0.6f + x * 0.15f, -0.6f + y * 0.15f, 2.f);
+			rays.push_back(line3df(eye, eye + (target - eye) * 2.f));
+		}
+		hits.resize(rays.size());
+	}
+
+	void run()
+	{
+		ISceneCollisionManager *collision =
+				env.device->getSceneManager()->getSceneCollisionManager();
+		if (batch) {
+			collision->getCollisionPoints(&hits[0], hit, &rays[0],
+					rays.size(), selector);
+		} else {
+			for (size_t i = 0; i < rays.size(); i++)
+				hit[i] = collision->getCollisionPoint(hits[i], rays[i], selector);
+		}
+	}
+
+	unsigned int opsPerRun() const { return rays.size(); }
+
+	void tearDown() { selector->drop(); }
+private:
+	bool batch;
+	unsigned int boxes;
+	ITriangleSelector *selector;
+	std::vector<line3df> rays;
+	std::vector<SCollisionHit> hits;
+	bool hit[64];
+};
+
+class LookupBench : public Benchmark
+{
+public:
+	LookupBench(bool by_position, unsigned int nodes):
+		Benchmark(by_position ? "Project::GetNode(pos)" : "Project::GetNode(id)",
+				"nodes=" + num_to_str(nodes)),
+		by_position(by_position), nodes(nodes), project(NULL)
+	{}
+
+	void setUp()
+	{
+		project = createTestProject(nodes, 1);
+		for (std::list<Node*>::const_iterator it = project->nodes.begin();
+				it != project->nodes.end();
+				++it) {
+			positions.push_back((*it)->position);
+		}
+	}
+
+	// Looks up every node once
+	void run()
+	{
+		for (unsigned int i = 0; i < nodes; i++) {
+			if (by_position)
+				project->GetNode(positions[i]);
+			else
+				project->GetNode(i);
+		}
+	}
+
+	unsigned int opsPerRun() const { return nodes; }
+
+	void tearDown() { delete project; }
+private:
+	bool by_position;
+	unsigned int nodes;
+	Project *project;
+	std::vector<vector3di> positions;
+};
+
+
+//
+// Replay
+//
+
+static int runReplay(const std::string &filename, bool per_frame)
+{
+	EventPlayer player;
+	if (!player.load(filename))
+		return EXIT_FAILURE;
+	player.setAllocationCounter(countAllocations);
+
+	SIrrlichtCreationParameters params;
+	params.DriverType = EDT_NULL;
+	params.WindowSize = player.getScreenSize();
+	params.LoggingLevel = ELL_ERROR;
+	IrrlichtDevice *device = createDeviceEx(params);
+	if (!device) {
+		std::cerr << "Unable to create the null device" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	Configuration *conf = new Configuration();
+	player.applySettings(conf);
+	std::cerr << "Replaying " << filename << " (" << player.getFrameCount()
+		<< " frames)" << std::endl;
+	Editor *editor = new Editor();
+	editor->setPlayer(&player);
+	editor->run(device, conf, false);
+	delete editor;
+	device->drop();
+	delete conf;
+
+	const std::vector<ReplayFrame> &frames = player.getResults();
+	if (frames.empty()) {
+		std::cerr << "Nothing was replayed" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::vector<double> cpu;
+	double cpu_total = 0;
+	double wall_total = 0;
+	unsigned long long meshes = 0;
+	unsigned long long allocs = 0;
+	unsigned long long events = 0;
+	for (std::vector<ReplayFrame>::const_iterator it = frames.begin();
+			it != frames.end();
+			++it) {
+		if (per_frame)
+			std::cout << "{\"frame\":" << it->frame
+				<< ",\"events\":" << it->events
+				<< ",\"cpu_ms\":" << it->cpu_ms
+				<< ",\"wall_ms\":" << it->wall_ms
+				<< ",\"meshes\":" << it->meshes
+				<< ",\"allocs\":" << it->allocs
+				<< "}" << std::endl;
+		cpu.push_back(it->cpu_ms);
+		cpu_total += it->cpu_ms;
+		wall_total += it->wall_ms;
+		meshes += it->meshes;
+		allocs += it->allocs;
+		events += it->events;
+	}
+
+	std::sort(cpu.begin(), cpu.end());
+	std::cout << "{\"name\":\"replay\""
+		<< ",\"param\":\"" << filename << "\""
+		<< ",\"frames\":" << frames.size()
+		<< ",\"events\":" << events
+		<< ",\"cpu_ms_total\":" << cpu_total
+		<< ",\"wall_ms_total\":" << wall_total
+		<< ",\"cpu_ms_median\":" << cpu[cpu.size() / 2]
+		<< ",\"cpu_ms_p99\":" << cpu[cpu.size() * 99 / 100]
+		<< ",\"cpu_ms_max\":" << cpu.back()
+		<< ",\"meshes\":" << meshes
+		<< ",\"allocs_per_frame\":" << (double)allocs / frames.size()
+		<< "}" << std::endl;
+	return EXIT_SUCCESS;
+}
+
+
+//
+// Main
+//
+
+static std::vector<unsigned int> parseSizes(const std::string &input)
+{
+	std::vector<unsigned int> res;
+	std::string rest = input;
+	while (rest != "") {
+		size_t pos = rest.find(',');
+		if (pos == std::string::npos)
+			pos = rest.size();
+		int value = atoi(rest.substr(0, pos).c_str());
+		if (value > 0)
+			res.push_back(value);
+		rest = (pos < rest.size()) ? rest.substr(pos + 1) : "";
+	}
+	return res;
+}
+
+static void printUsage()
+{
+	std::cerr << "Usage: nbe_bench [options]\n"
+		"  --filter <str>    only run benchmarks whose name contains str\n"
+		"  --sizes <a,b,..>  node/box counts to run scaled benchmarks at (default 1,10,100)\n"
+		"  --boxes <n>       boxes per node in generated projects (default 8)\n"
+		"  --reps <n>        timed repetitions per benchmark (default 5)\n"
+		"  --min-time <ms>   minimum duration of one repetition (default 50)\n"
+		"  --list            list benchmarks and exit\n"
+		"  --replay <file>   replay a recorded session instead\n"
+		"  --per-frame       with --replay, also print each frame's costs\n";
+}
+
+int main(int argc, char *argv[])
+{
+	BenchOptions opts;
+	opts.sizes = parseSizes("1,10,100");
+	env.boxes_per_node = 8;
+	bool list = false;
+	std::string replay_file;
+	bool per_frame = false;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool has_value = (i + 1 < argc);
+		if (arg == "--filter" && has_value)
+			opts.filter = argv[++i];
+		else if (arg == "--sizes" && has_value)
+			opts.sizes = parseSizes(argv[++i]);
+		else if (arg == "--boxes" && has_value)
+			env.boxes_per_node = std::max(1, atoi(argv[++i]));
+		else if (arg == "--reps" && has_value)
+			opts.reps = std::max(1, atoi(argv[++i]));
+		else if (arg == "--min-time" && has_value)
+			opts.min_time_ms = std::max(1, atoi(argv[++i]));
+		else if (arg == "--list")
+			list = true;
+		else if (arg == "--replay" && has_value)
+			replay_file = argv[++i];
+		else if (arg == "--per-frame")
+			per_frame = true;
+		else {
+			printUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (replay_file != "")
+		return runReplay(replay_file, per_frame);
+
+	// Set up a headless editor
+	SIrrlichtCreationParameters params;
+	params.DriverType = EDT_NULL;
+	params.LoggingLevel = ELL_ERROR;
+	env.device = createDeviceEx(params);
+	if (!env.device) {
+		std::cerr << "Unable to create the null device" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	Configuration *conf = new Configuration();
+	conf->set("lighting", "2");
+	conf->set("limiting", "true");
+	conf->set("save_compression", "1");
+	conf->set("export_compression", "9");
+	conf->set("journaled_saves", "false");
+	conf->set("binary_project", "true");
+	conf->set("log_level", "info");
+	conf->set("log_verbose", "");
+	env.state = new EditorState(env.device, NULL, conf);
+	env.state->isInstalled = false;
+	bench_dir = getSystemTmpDirectory() + "nbe_bench" + DIR_DELIM;
+	CreateDir(bench_dir);
+	CreateDir(bench_dir + "extracted");
+	// Saving and loading .nbe files goes through the editor's temp directory
+	setTmpDirectory(bench_dir);
+
+	// Register benchmarks
+	std::vector<Benchmark*> benches;
+	static const u32 texture_sizes[] = {16, 64, 256};
+	static const unsigned int blob_sizes[] = {64 * 1024, 1024 * 1024, 16 * 1024 * 1024};
+	for (int i = 0; i < 3; i++)
+		benches.push_back(new BuildMeshBench(texture_sizes[i]));
+	for (int i = 0; i < 3; i++)
+		benches.push_back(new DarkenBench(texture_sizes[i]));
+	static const ECOLOR_FORMAT conversions[][2] = {
+		{ECF_R8G8B8, ECF_A8R8G8B8},
+		{ECF_A8R8G8B8, ECF_R8G8B8},
+		{ECF_A8R8G8B8, ECF_A1R5G5B5},
+		{ECF_A1R5G5B5, ECF_A8R8G8B8},
+		{ECF_R8G8B8, ECF_A1R5G5B5},
+	};
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 5; j++)
+			benches.push_back(new ConvertBench(conversions[j][0], conversions[j][1],
+					texture_sizes[i]));
+		benches.push_back(new ScaleBench(texture_sizes[i]));
+	}
+	for (size_t i = 0; i < opts.sizes.size(); i++) {
+		benches.push_back(new NodeTransformBench(false, opts.sizes[i]));
+		benches.push_back(new NodeTransformBench(true, opts.sizes[i]));
+	}
+	for (size_t i = 0; i < opts.sizes.size(); i++)
+		benches.push_back(new ProjectRemeshBench(opts.sizes[i]));
+	for (size_t i = 0; i < opts.sizes.size(); i++) {
+		benches.push_back(new NBEWriteBench(opts.sizes[i]));
+		benches.push_back(new NBEReadBench(opts.sizes[i]));
+	}
+	for (int i = 0; i < 3; i++) {
+		benches.push_back(new CombinerBench(false, blob_sizes[i]));
+		benches.push_back(new CombinerBench(true, blob_sizes[i]));
+	}
+	for (size_t i = 0; i < opts.sizes.size(); i++) {
+		benches.push_back(new LuaBench(false, opts.sizes[i]));
+		benches.push_back(new LuaBench(true, opts.sizes[i]));
+	}
+	for (size_t i = 0; i < opts.sizes.size(); i++) {
+		benches.push_back(new CSGBench(ECSG_UNION, opts.sizes[i]));
+		benches.push_back(new CSGBench(ECSG_SUBTRACT, opts.sizes[i]));
+	}
+	for (size_t i = 0; i < opts.sizes.size(); i++) {
+		benches.push_back(new MeshExportBench("obj", opts.sizes[i]));
+		benches.push_back(new MeshExportBench("b3d", opts.sizes[i]));
+		benches.push_back(new MeshExportBench("glb", opts.sizes[i]));
+	}
+	for (size_t i = 0; i < opts.sizes.size(); i++)
+		benches.push_back(new PreviewBench(opts.sizes[i]));
+	for (size_t i = 0; i < opts.sizes.size(); i++) {
+		benches.push_back(new RaycastBench(false, opts.sizes[i]));
+		benches.push_back(new RaycastBench(true, opts.sizes[i]));
+	}
+	for (size_t i = 0; i < opts.sizes.size(); i++) {
+		benches.push_back(new LookupBench(false, opts.sizes[i]));
+		benches.push_back(new LookupBench(true, opts.sizes[i]));
+	}
+
+	// Run
+	for (std::vector<Benchmark*>::iterator it = benches.begin();
+			it != benches.end();
+			++it) {
+		Benchmark *bench = *it;
+		if (bench->name.find(opts.filter) != std::string::npos) {
+			if (list)
+				std::cout << bench->name << " (" << bench->param << ")" << std::endl;
+			else
+				runBenchmark(bench, opts);
+		}
+		delete bench;
+	}
+
+	delete env.state;
+	delete conf;
+	env.device->drop();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,100 @@
+// nbe_generate - writes synthetic projects for benchmarking and profiling
+//
+//     ./bin/nbe_generate --nodes 10000 --boxes 8 --out large
+//
+// creates large.nbe and large.lua. The same options always produce the same
+// files.
+
+#include <stdlib.h>
+#include <algorithm>
+#include "generator.hpp"
+#include "../Configuration.hpp"
+#include "../FileFormat/NBE.hpp"
+#include "../FileFormat/Lua.hpp"
+#include "../util/filesys.hpp"
+
+static void printUsage()
+{
+	std::cerr << "Usage: nbe_generate [options]\n"
+		"  --seed <n>          random seed (default 1)\n"
+		"  --nodes <n>         number of nodes (default 100)\n"
+		"  --boxes <n>         boxes per node (default 8)\n"
+		"  --textures <n>      number of textures (default 16)\n"
+		"  --texture-size <n>  width and height of textures (default 16)\n"
+		"  --duplicates <f>    fraction of duplicated nodes and textures (default 0)\n"
+		"  --out <path>        output path without extension (default generated)\n";
+}
+
+int main(int argc, char *argv[])
+{
+	GeneratorSettings settings;
+	std::string out = "generated";
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (i + 1 >= argc) {
+			printUsage();
+			return EXIT_FAILURE;
+		}
+		const char *value = argv[++i];
+		if (arg == "--seed")
+			settings.seed = strtoul(value, NULL, 10);
+		else if (arg == "--nodes")
+			settings.nodes = std::max(0, atoi(value));
+		else if (arg == "--boxes")
+			settings.boxes_per_node = std::max(0, atoi(value));
+		else if (arg == "--textures")
+			settings.textures = std::max(0, atoi(value));
+		else if (arg == "--texture-size")
+			settings.texture_size = std::max(1, atoi(value));
+		else if (arg == "--duplicates")
+			settings.duplicate_ratio = (f32)atof(value);
+		else if (arg == "--out")
+			out = value;
+		else {
+			printUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	SIrrlichtCreationParameters params;
+	params.DriverType = EDT_NULL;
+	params.LoggingLevel = ELL_ERROR;
+	IrrlichtDevice *device = createDeviceEx(params);
+	if (!device) {
+		std::cerr << "Unable to create the null device" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	Configuration *conf = new Configuration();
+	conf->set("lighting", "2");
+	conf->set("save_compression", "1");
+	conf->set("export_compression", "9");
+	conf->set("journaled_saves", "false");
+	conf->set("binary_project", "true");
+	conf->set("log_level", "info");
+	conf->set("log_verbose", "");
+	EditorState *state = new EditorState(device, NULL, conf);
+	state->isInstalled = false;
+	setTmpDirectory(getSystemTmpDirectory() + "nbe_generate" + DIR_DELIM);
+
+	Project *project = generateProject(state, settings);
+	state->project = project;
+
+	int retval = EXIT_SUCCESS;
+	NBEFileFormat nbe(state);
+	if (!nbe.write(project, out + ".nbe")) {
+		std::cerr << "Failed to write " << out << ".nbe" << std::endl;
+		retval = EXIT_FAILURE;
+	}
+	LuaFileFormat lua(state);
+	if (!lua.write(project, out + ".lua")) {
+		std::cerr << "Failed to write " << out << ".lua" << std::endl;
+		retval = EXIT_FAILURE;
+	}
+
+	delete project;
+	delete state;
+	delete conf;
+	device->drop();
+	return retval;
+}
@@ -0,0 +1,107 @@
+#include "generator.hpp"
+#include <math.h>
+#include <vector>
+#include "../project/node.hpp"
+#include "../util/string.hpp"
+
+static IImage *generateImage(IVideoDriver *driver, GeneratorRandom &rand, u32 size)
+{
+	IImage *image = driver->createImage(ECF_A8R8G8B8, dimension2d<u32>(size, size));
+	u32 r = rand.range(256);
+	u32 g = rand.range(256);
+	u32 b = rand.range(256);
+	for (u32 y = 0; y < size; y++) {
+		for (u32 x = 0; x < size; x++) {
+			// Darken randomly, like most pixel art textures
+			u32 shade = 160 + rand.range(96);
+			image->setPixel(x, y, SColor(255, r * shade / 255, g * shade / 255,
+					b * shade / 255));
+		}
+	}
+	return image;
+}
+
+static void generateTextures(Project *project, IVideoDriver *driver,
+		GeneratorRandom &rand, const GeneratorSettings &settings)
+{
+	std::vector<IImage*> images;
+	for (u32 i = 0; i < settings.textures; i++) {
+		IImage *image = NULL;
+		if (i > 0 && rand.fraction() < settings.duplicate_ratio) {
+			IImage *source = images[rand.range(i)];
+			image = driver->createImage(source->getColorFormat(), source->getDimension());
+			source->copyTo(image);
+		} else {
+			image = generateImage(driver, rand, settings.texture_size);
+		}
+		images.push_back(image);
+		project->media.add("", "texture_" + num_to_str(i + 1) + ".png", image);
+	}
+}
+
+static void generateBoxes(Node *node, GeneratorRandom &rand, u32 count, bool build_mesh)
+{
+	for (u32 i = 0; i < count; i++) {
+		// Snap to 1/16ths, like boxes made in the editor
+		f32 one[3];
+		f32 two[3];
+		for (int axis = 0; axis < 3; axis++) {
+			u32 start = rand.range(16);
+			u32 end = start + 1 + rand.range(16 - start);
+			one[axis] = (f32)start / 16.f - 0.5f;
+			two[axis] = (f32)end / 16.f - 0.5f;
+		}
+		node->addNodeBox(vector3df(one[0], one[1], one[2]),
+				vector3df(two[0], two[1], two[2]), build_mesh);
+	}
+}
+
+static void copyNode(Node *node, Node *source, bool build_mesh)
+{
+	for (std::vector<NodeBox*>::const_iterator it = source->boxes.begin();
+			it != source->boxes.end();
+			++it) {
+		NodeBox *box = node->addNodeBox((*it)->one, (*it)->two, build_mesh);
+		box->name = (*it)->name;
+	}
+	for (int i = 0; i < 6; i++)
+		node->setTexture((ECUBE_SIDE)i, source->getTexture((ECUBE_SIDE)i));
+}
+
+Project *generateProject(EditorState *state, const GeneratorSettings &settings)
+{
+	GeneratorRandom rand(settings.seed);
+	Project *project = new Project();
+	project->name = "generated";
+	generateTextures(project, state->device->getVideoDriver(), rand, settings);
+
+	// Lay nodes out in a square on the floor
+	u32 side = (u32)ceil(sqrt((double)settings.nodes));
+	std::vector<Node*> nodes;
+	for (u32 i = 0; i < settings.nodes; i++) {
+		Node *node = new Node(state->device, state, i);
+		node->name = "node_" + num_to_str(i + 1);
+		node->position = vector3di(i % side, 0, i / side);
+
+		if (i > 0 && rand.fraction() < settings.duplicate_ratio) {
+			copyNode(node, nodes[rand.range(i)], settings.build_mesh);
+		} else {
+			if (settings.textures > 0) {
+				if (rand.range(2) == 0) {
+					node->setAllTextures(project->media.get(("texture_" +
+							num_to_str(rand.range(settings.textures) + 1) + ".png").c_str()));
+				} else {
+					for (int face = 0; face < 6; face++) {
+						node->setTexture((ECUBE_SIDE)face, project->media.get(("texture_" +
+								num_to_str(rand.range(settings.textures) + 1) + ".png").c_str()));
+					}
+				}
+			}
+			generateBoxes(node, rand, settings.boxes_per_node, settings.build_mesh);
+		}
+
+		nodes.push_back(node);
+		project->AddNode(node, false, settings.build_mesh);
+	}
+	return project;
+}
@@ -0,0 +1,66 @@
+#ifndef BENCH_GENERATOR_HPP_INCLUDED
+#define BENCH_GENERATOR_HPP_INCLUDED
+
+#include "../common.hpp"
+#include "../EditorState.hpp"
+#include "../project/project.hpp"
+
+// Settings for generateProject().
+//
+// The same settings and seed always produce the same project.
+struct GeneratorSettings
+{
+	GeneratorSettings():
+		seed(1),
+		nodes(100),
+		boxes_per_node(8),
+		textures(16),
+		texture_size(16),
+		duplicate_ratio(0.f),
+		build_mesh(false)
+	{}
+
+	u32 seed;
+	u32 nodes;
+	u32 boxes_per_node;
+	u32 textures;
+	u32 texture_size;
+
+	// Fraction (0 to 1) of nodes which are copies of an earlier node, and of
+	// textures whose pixels are copies of an earlier texture.
+	f32 duplicate_ratio;
+
+	// Whether to create scene nodes for the boxes. Not needed when the project
+	// is only going to be saved.
+	bool build_mesh;
+};
+
+// Small xorshift generator, so that output doesn't depend on the C library.
+class GeneratorRandom
+{
+public:
+	GeneratorRandom(u32 seed):
+		state(seed ? seed : 0x9E3779B9)
+	{}
+
+	u32 next()
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	// Returns a number in [0, max)
+	u32 range(u32 max) { return max ? next() % max : 0; }
+
+	// Returns a number in [0, 1)
+	f32 fraction() { return (f32)(next() >> 8) / (f32)(1 << 24); }
+private:
+	u32 state;
+};
+
+// Build a synthetic project for load, save and render stress tests.
+Project *generateProject(EditorState *state, const GeneratorSettings &settings);
+
+#endif
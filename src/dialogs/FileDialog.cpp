@@ -37,11 +37,12 @@ void FileDialog_open_project(EditorState *state)
 	std::cerr << "Reading from " << file << std::endl;
 	Project *tmp = parser->read(file);
 	if (tmp) {
-		if (state->project)
-			delete state->project;
+			// Unloaded first, as the mode listens to the old project
+			state->Mode()->unload();
+			if (state->project)
+				delete state->project;
 			state->project = tmp;
 			state->project->SelectNode(0);
-			state->Mode()->unload();
 			state->menu->init();
 			state->Mode()->load();
 			delete parser;
@@ -194,19 +195,18 @@ void FileDialog_export(EditorState *state, int parser)
 	save_file(writer, state, file);
 }
 
-#include "../FileFormat/obj.hpp"
-#include <fstream>
+#include "../FileFormat/mesh.hpp"
 
-void FileDialog_export_obj(EditorState *state, Node *node)
+void FileDialog_export_mesh(EditorState *state, Node *node)
 {
 	// Get path
 	std::string path = getSaveLoadDirectory(state->settings->get("save_directory"),
 			state->isInstalled);
 
-	const char* filters[] = {"*.obj"};
+	const char* filters[] = {"*.b3d", "*.glb", "*.obj"};
 
-	const char *cfile = tinyfd_saveFileDialog("Export Node to Mesh", path.c_str(),
-			1, filters);	
+	const char *cfile = tinyfd_saveFileDialog(node ? "Export Node to Mesh" :
+			"Export Project to Mesh", path.c_str(), 3, filters);
 
 	if (!cfile)
 		return;
@@ -216,12 +216,13 @@ void FileDialog_export_obj(EditorState *state, Node *node)
 	if (filename == "")
 		return;
 
-	std::string res = nodeToObj(node, filenameWithoutExt(filename));
-	std::ofstream file(filename.c_str());
-	if (!file)
-		return;
-	file << res.c_str();
-	file.close();
+	std::string ext = str_to_lower(extFromFilename(filename));
+	if (ext != "b3d" && ext != "glb" && ext != "obj")
+		filename += ".b3d";
+
+	if (!exportMesh(state->project, node, filename))
+		state->device->getGUIEnvironment()->addMessageBox(L"Unable to export",
+				L"The mesh could not be written. See the log for details.");
 }
 
 void FileDialog_export_mod(EditorState *state)
@@ -240,7 +241,7 @@ void FileDialog_export_mod(EditorState *state)
 		return;
 
 	dir = cleanDirectoryPath(dir);
-	export_textures(dir + "textures/", state);
+	export_textures(dir + "textures/", state, state->settings->getInt("export_compression"));
 
 	FileFormat *writer = getFromType(FILE_FORMAT_LUA, state);
 	save_file(writer, state, dir + "init.lua");
@@ -262,5 +263,27 @@ void FileDialog_export_textures(EditorState *state)
 		return;
 
 	dir = cleanDirectoryPath(dir);
-	export_textures(dir, state);
+	export_textures(dir, state, state->settings->getInt("export_compression"));
+}
+
+void FileDialog_export_inventory_images(EditorState *state)
+{
+	std::string path = getSaveLoadDirectory(state->settings->get("save_directory"),
+			state->isInstalled);
+
+	const char *cdir = tinyfd_selectFolderDialog ("Select Folder", path.c_str());
+
+	if (!cdir)
+		return;
+
+	std::string dir = trim(cdir);
+
+	if (dir == "")
+		return;
+
+	dir = cleanDirectoryPath(dir);
+	if (!export_inventory_images(dir, state, state->settings->getInt("inventory_image_size"),
+			state->settings->getInt("export_compression")))
+		state->device->getGUIEnvironment()->addMessageBox(L"Unable to export",
+				L"Some inventory images could not be written. See the log for details.");
 }
@@ -7,8 +7,10 @@ extern void FileDialog_open_project(EditorState *state);
 extern void FileDialog_save_project(EditorState *state);
 extern void FileDialog_import(EditorState *state);
 extern void FileDialog_export(EditorState *state, int parser);
-extern void FileDialog_export_obj(EditorState *state, Node *node);
+// Exports node, or every node if it is NULL
+extern void FileDialog_export_mesh(EditorState *state, Node *node);
 extern void FileDialog_export_mod(EditorState *state);
 extern void FileDialog_export_textures(EditorState *state);
+extern void FileDialog_export_inventory_images(EditorState *state);
 
 #endif
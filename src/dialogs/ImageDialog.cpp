@@ -120,15 +120,10 @@ bool ImageDialog::OnEvent(const SEvent &event)
 
 			// Do import or show warning
 			if (!already_exists || cb->isChecked()) {
-				IImage *image = state->device->getVideoDriver()->createImageFromFile(path.c_str());
-				if (!image) {
+				if (!state->project->media.import(path, shortname, state->device, cb->isChecked())) {
 					state->device->getGUIEnvironment()->addMessageBox(L"Unable to import",
 							L"Failed to open the image\n\t(Does it not exist, or is it readonly?)");
 					return true;
-				} else if (!state->project->media.add(path.c_str(), shortname, image, cb->isChecked())) {
-					state->device->getGUIEnvironment()->addMessageBox(L"Unable to import",
-							L"Failed to add the image\n\t(Unknown reason)");
-					return true;
 				}
 				state->project->remesh();
 				if (node)
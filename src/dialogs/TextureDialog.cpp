@@ -1,5 +1,6 @@
 #include "TextureDialog.hpp"
 #include "../util/string.hpp"
+#include "../project/nodebox.hpp"
 #include "ImageDialog.hpp"
 #include "../util/filesys.hpp"
 #include "../util/tinyfiledialogs.h"
@@ -54,33 +55,28 @@ TextureDialog::TextureDialog(EditorState *pstate, Node *pnode, ECUBE_SIDE pface)
 
 	// Fill out listbox
 	lb = guienv->addListBox(rect<s32>(10, 104, 74 * 3, 74 * 3), win, 502);
-	Media *media = &state->project->media;
-	std::map<std::string, Media::Image*>& images = media->getList();
-	int count = 1;
+	state->project->media.getSorted(rows);
 	lb->addItem(L"");
 	lb->setSelected(0);
-	for (std::map<std::string, Media::Image*>::const_iterator it = images.begin();
-			it != images.end();
+	for (std::vector<Media::Image*>::const_iterator it = rows.begin();
+			it != rows.end();
 			++it) {
-		if (!it->second) {
-			continue;
-		}
-		if (it->second->name == "default") {
+		Media::Image *image = *it;
+		if (image->name == "default") {
 			lb->addItem(L"");
 		} else {
-			lb->addItem(narrow_to_wide(it->second->name + " [used " +
-					num_to_str(it->second->getHolders()) + " times]").c_str());
+			lb->addItem(narrow_to_wide(image->name + " [used " +
+					num_to_str(image->getHolders()) + " times]").c_str());
 		}
-		if (it->second == node->getTexture(face))
-			lb->setSelected(count);
-		count++;
+		if (image == node->getTexture(face))
+			lb->setSelected(lb->getItemCount() - 1);
 	}
 
 	Media::Image *image = node->getTexture(face);
 	if (image) {
 		if (the_image)
 			driver->removeTexture(the_image);
-		the_image = driver->addTexture("tmpicon.png", image->get());
+		the_image = addPixelArtTexture(driver, "tmpicon.png", image->get());
 	}
 
 	// Context menu
@@ -141,6 +137,14 @@ bool TextureDialog::close()
 	return true;
 }
 
+Media::Image *TextureDialog::getSelectedImage() const
+{
+	s32 row = lb->getSelected() - 1;
+	if (row < 0 || row >= (s32)rows.size())
+		return NULL;
+	return rows[row];
+}
+
 bool TextureDialog::OnEvent(const SEvent &event)
 {
 	if (event.EventType != EET_GUI_EVENT)
@@ -153,25 +157,16 @@ bool TextureDialog::OnEvent(const SEvent &event)
 		case ETD_GUI_ID_APPLY: {
 			if (lb->getSelected() == 0) {
 				node->setTexture(face, NULL);
-				node->remesh(true);
+				node->remesh();
 				return true;
 			}
 
-			int count = 0;
-			Media *media = &state->project->media;
-			std::map<std::string, Media::Image*>& images = media->getList();
-			for (std::map<std::string, Media::Image*>::const_iterator it = images.begin();
-					it != images.end();
-					++it) {
-				if (count == lb->getSelected()-1) {
-					node->setTexture(face, it->second);
-					node->remesh(true);
-					break;
-				}
-				count++;
+			Media::Image *image = getSelectedImage();
+			if (image) {
+				node->setTexture(face, image);
+				node->remesh();
 			}
 
-
 			close();
 			return true;
 		}
@@ -188,23 +183,7 @@ bool TextureDialog::OnEvent(const SEvent &event)
 		IGUIContextMenu *menu = (IGUIContextMenu *)event.GUIEvent.Caller;
 		switch (menu->getItemCommandId(menu->getSelectedItem())) {
 		case ETD_GUI_ID_EXPORT: {
-			if (lb->getSelected() == 0)
-				return true;
-
-			int count = 0;
-			Media *media = &state->project->media;
-			Media::Image *image = NULL;
-			std::map<std::string, Media::Image*>& images = media->getList();
-			for (std::map<std::string, Media::Image*>::const_iterator it = images.begin();
-					it != images.end();
-					++it) {
-				if (count == lb->getSelected() - 1) {
-					image = it->second;
-					break;
-				}
-				count++;
-			}
-
+			Media::Image *image = getSelectedImage();
 			if (!image)
 				return true;
 
@@ -223,8 +202,8 @@ bool TextureDialog::OnEvent(const SEvent &event)
 			if (filename == "")
 				return true;
 
-			state->device->getVideoDriver()->writeImageToFile(image->get(),
-					filename.c_str());
+			image->write(state->device->getVideoDriver(), filename,
+					state->settings->getInt("export_compression"));
 
 			return true;
 		}} // end of switch
@@ -236,19 +215,11 @@ bool TextureDialog::OnEvent(const SEvent &event)
 			return true;
 		}
 
-		int count = 0;
-		Media *media = &state->project->media;
-		std::map<std::string, Media::Image*>& images = media->getList();
-		for (std::map<std::string, Media::Image*>::const_iterator it = images.begin();
-				it != images.end();
-				++it) {
-			if (count == lb->getSelected()-1) {
-				if (the_image)
-					driver->removeTexture(the_image);
-				the_image = state->device->getVideoDriver()->addTexture("tmpicon.png", it->second->get());
-				break;
-			}
-			count++;
+		Media::Image *image = getSelectedImage();
+		if (image) {
+			if (the_image)
+				driver->removeTexture(the_image);
+			the_image = addPixelArtTexture(driver, "tmpicon.png", image->get());
 		}
 		return true;
 	} else if (event.GUIEvent.EventType == EGET_ELEMENT_CLOSED && event.GUIEvent.Caller == win) {
@@ -1,6 +1,8 @@
 #ifndef TEXTUREDIALOG_HPP_INCLUDED
 #define TEXTUREDIALOG_HPP_INCLUDED
 #include "Dialog.hpp"
+#include <vector>
+#include "../project/media.hpp"
 
 class TextureDialog : public Dialog
 {
@@ -12,12 +14,18 @@ public:
 	virtual bool OnEvent(const SEvent &event);
 	virtual void draw(IVideoDriver *driver);
 private:
+	// The image of the selected row, or NULL for the first, empty row
+	Media::Image *getSelectedImage() const;
+
 	Node *node;
 	ECUBE_SIDE face;
 	IGUIWindow *win;
 	IGUIListBox *lb;
 	ITexture *the_image;
 	IGUIContextMenu *context;
+
+	// The images listed after the empty row, in order
+	std::vector<Media::Image*> rows;
 };
 
 #endif
@@ -1,10 +1,14 @@
 #include <stdlib.h>
 #include <iostream>
+#include <sstream>
 #include <irrlicht.h>
 #include "util/string.hpp"
 #include "util/filesys.hpp"
+#include "util/Log.hpp"
 #include "common.hpp"
 #include "Editor.hpp"
+#include "FileFormat/FileFormat.hpp"
+#include "FileFormat/helpers.hpp"
 
 #ifdef _MSC_VER
 #pragma comment(lib, "Irrlicht.lib")
@@ -68,6 +72,51 @@ void findWorkingDirectory(bool &editor_is_installed)
 }
 #endif // ifndef _WIN32
 
+// Relative to where the editor was started, not the working directory
+static std::string absolutePath(const std::string &path)
+{
+#ifndef _WIN32
+	char cwd[PATH_MAX];
+	if (path != "" && path[0] != '/' && getcwd(cwd, sizeof(cwd)))
+		return std::string(cwd) + "/" + path;
+#endif
+	return path;
+}
+
+// Draws a project's inventory images without a window, so that they can be
+// made on machines without a GPU.
+static int exportInventoryImages(Configuration *conf, const std::string &project_file,
+		const std::string &dir, u32 size)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = EDT_NULL;
+	params.LoggingLevel = ELL_ERROR;
+	IrrlichtDevice *device = createDeviceEx(params);
+	if (!device)
+		return EXIT_FAILURE;
+
+	EditorState *state = new EditorState(device, NULL, conf);
+	state->isInstalled = false;
+	FileFormat *reader = getFromType(FILE_FORMAT_NBE, state);
+	state->project = reader->read(project_file);
+	delete reader;
+
+	// Falls through to the clean up, so that the workers are joined and
+	// the device dropped whether or not the project could be read
+	bool ok = false;
+	if (state->project) {
+		std::string out = dir;
+		ok = export_inventory_images(cleanDirectoryPath(out), state, size,
+				conf->getInt("export_compression"));
+	} else {
+		std::cerr << "Unable to read " << project_file << std::endl;
+	}
+	delete state->project;
+	delete state;
+	device->drop();
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 int main(int argc, char *argv[]) {
 	std::cerr <<
 		" _   _           _        ____              _____    _ _ _             \n"
@@ -82,6 +131,22 @@ int main(int argc, char *argv[]) {
 #endif
 
 
+	// Recording the session's input, for nbe_bench --replay
+	std::string record_file;
+	// --inventory-images <project.nbe> <dir> [--size <n>]
+	std::string inventory_project, inventory_dir;
+	u32 inventory_size = 0;
+	for (int i = 1; i + 1 < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--record")
+			record_file = absolutePath(argv[++i]);
+		else if (arg == "--inventory-images" && i + 2 < argc) {
+			inventory_project = absolutePath(argv[++i]);
+			inventory_dir = absolutePath(argv[++i]);
+		} else if (arg == "--size")
+			inventory_size = atoi(argv[++i]);
+	}
+
 	// Find the working directory
 	bool editor_is_installed = false;
 #ifndef _WIN32
@@ -100,6 +165,7 @@ int main(int argc, char *argv[]) {
 	conf->set("hide_sidebar", "false");
 	conf->set("save_directory", "");
 	conf->set("minetest_root", "");
+	conf->set("minetest_executable", "");
 	conf->set("always_show_position_handle", "false");
 #ifdef _WIN32
 	conf->set("vsync", "false");
@@ -118,12 +184,44 @@ int main(int argc, char *argv[]) {
 	conf->set("fullscreen", "false");
 	conf->set("width", "896");
 	conf->set("height", "520");
+	conf->set("memory_budget", "1024");
+	conf->set("media_release_time", "60");
+	conf->set("save_compression", "1");
+	conf->set("export_compression", "9");
+	conf->set("journaled_saves", "false");
+	conf->set("binary_project", "true");
+	conf->set("log_level", "info");
+	conf->set("log_verbose", "");
+	conf->set("inventory_image_size", "64");
+	conf->set("watch_textures", "true");
 	if (!editor_is_installed)
 		conf->load("editor.conf");
 	else
 		if (!conf->load(std::string(getSaveLoadDirectory("", true)) + ".config/nodeboxeditor.conf"))
 			conf->load("editor.conf");
 
+	// Logging
+	ELogLevel log_level;
+	if (Log::levelFromString(conf->get("log_level"), log_level))
+		Log::setLevel(log_level);
+	std::istringstream verbose(conf->get("log_verbose"));
+	std::string category_name;
+	while (std::getline(verbose, category_name, ',')) {
+		ELogCategory category;
+		if (Log::categoryFromString(trim(category_name), category))
+			Log::setLevel(category, ELV_VERBOSE);
+	}
+	Log::start();
+
+	if (inventory_project != "") {
+		if (inventory_size == 0)
+			inventory_size = conf->getInt("inventory_image_size");
+		int retval = exportInventoryImages(conf, inventory_project, inventory_dir,
+				inventory_size);
+		Log::stop();
+		return retval;
+	}
+
 	// Set up irrlicht device
 	E_DRIVER_TYPE driv = irr::video::EDT_OPENGL;
 
@@ -145,11 +243,16 @@ int main(int argc, char *argv[]) {
 		conf->getBool("vsync")
 	);
 	if (device == NULL) {
+		Log::stop();
 		return EXIT_FAILURE; // could not create selected driver.
 	}
 
 	// Editor
 	Editor* editor = new Editor();
+	EventRecorder recorder;
+	if (record_file != "" &&
+			recorder.start(record_file, conf, device->getVideoDriver()->getScreenSize()))
+		editor->setRecorder(&recorder);
 	editor->run(device, conf, editor_is_installed);
 
 	if (!editor_is_installed)
@@ -158,6 +261,7 @@ int main(int argc, char *argv[]) {
 		if (!conf->save(std::string(getSaveLoadDirectory("", true)) + ".config/nodeboxeditor.conf"))
 			conf->save("editor.conf");
 
+	Log::stop();
 	return 1;
 }
 
@@ -6,15 +6,8 @@
 #include <stdlib.h>
 #include <fstream>
 
-#ifdef _WIN32
-    #include <direct.h>
-    #define getcwd _getcwd
-#else
-    #include <unistd.h>
-#endif
-
 Minetest::Minetest(Configuration *conf):
-	_conf(conf), minetest_dir(""), minetest_exe("")
+	_conf(conf), minetest_dir(""), minetest_exe(""), game_started(false)
 {}
 
 bool Minetest::findMinetestDir(std::string path)
@@ -23,7 +16,13 @@ bool Minetest::findMinetestDir(std::string path)
 		std::cerr << "Minetest found at " << path.c_str() << std::endl;
 		minetest_dir = path;
 
-		if (FileExists((path + "bin" + DIR_DELIM + "minetest"
+		std::string exe = _conf->get("minetest_executable");
+		if (exe != "") {
+			if (FileExists(exe.c_str()))
+				minetest_exe = exe;
+			else
+				std::cerr << "...but minetest_executable doesn't exist!" << std::endl;
+		} else if (FileExists((path + "bin" + DIR_DELIM + "minetest"
 #if _WIN32
 			".exe"
 #endif
@@ -113,12 +112,17 @@ bool Minetest::findMinetest(bool editor_is_installed)
 
 bool Minetest::runMod(EditorState *state, const std::string &world)
 {
+	if (poll()) {
+		NBE_LOG(ELV_WARNING, ELC_GENERAL, "Minetest is still running");
+		return false;
+	}
+
 	std::string worlddir = minetest_dir + "worlds" + DIR_DELIM + world + DIR_DELIM;
 	std::string modname = state->project->name;
 	if (DirExists(worlddir.c_str())) {
 		// Open file
-		const char *filename = (worlddir + "world.mt").c_str();
-		std::ifstream file(filename);
+		std::string filename = worlddir + "world.mt";
+		std::ifstream file(filename.c_str());
 		if (file) {
 			std::string line;
 			std::string search_for = std::string("load_mod_") + modname.c_str();
@@ -162,26 +166,37 @@ bool Minetest::runMod(EditorState *state, const std::string &world)
 	std::string mod_to = worlddir + "worldmods" + DIR_DELIM + modname;
 	CreateDir(mod_to);
 	mod_to = cleanDirectoryPath(mod_to);
-	export_textures(mod_to + "textures" + DIR_DELIM, state);
+	export_textures(mod_to + "textures" + DIR_DELIM, state, state->settings->getInt("save_compression"));
 	FileFormat *writer = getFromType(FILE_FORMAT_LUA, state);
 	save_file(writer, state, mod_to + "init.lua");
 
-	// Change working directory
-	char buffer[300];
-	char *prev_cwd = getcwd(buffer, sizeof(buffer));
-	if (!prev_cwd) {
-		std::cerr << "Failed to get CWD" << std::endl;
+	// Run Minetest in its own directory, without waiting for it
+	std::vector<std::string> args;
+	args.push_back("--worldname");
+	args.push_back(world);
+	args.push_back("--name");
+	args.push_back("tester");
+	args.push_back("--address");
+	args.push_back("");
+	args.push_back("--go");
+	std::cerr << "Starting Minetest in world " << world.c_str() << std::endl;
+	if (!game.start(minetest_exe, args, minetest_dir))
 		return false;
-	}
-
-	// Run minetest
-	chdir(minetest_dir.c_str());
-	std::string args = "--worldname " + world + " --name tester --address '' --go";
-	std::cerr << "Starting Minetest with " << args.c_str() << std::endl;
-	system((minetest_exe + " " + args).c_str());
+	game_started = true;
+	return true;
+}
 
-	// Change directory back
-	chdir(prev_cwd);
+bool Minetest::poll()
+{
+	if (!game_started)
+		return false;
+	if (game.isRunning())
+		return true;
 
-	return true;
+	game_started = false;
+	if (game.getExitCode() == 0)
+		NBE_LOG(ELV_INFO, ELC_GENERAL, "Minetest has exited");
+	else
+		NBE_LOG(ELV_WARNING, ELC_GENERAL, "Minetest exited with code " << game.getExitCode());
+	return false;
 }
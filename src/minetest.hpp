@@ -4,19 +4,30 @@
 #include "common.hpp"
 #include "EditorState.hpp"
 #include "Configuration.hpp"
+#include "util/Process.hpp"
 
 class Minetest
 {
 public:
 	Minetest(Configuration *conf);
 	bool findMinetest(bool editor_is_installed);
+
+	// Exports the project as a mod in the world, writing only the files
+	// that have changed, then starts Minetest and returns straight away
 	bool runMod(EditorState *state, const std::string &world = "nbe_test");
+
+	// Whether the game started by runMod() is still running. Logs how it
+	// exited once it has, so call it every so often.
+	bool poll();
 private:
 	bool findMinetestDir(std::string path);
 
 	Configuration *_conf;
 	std::string minetest_dir;
 	std::string minetest_exe;
+
+	Process game;
+	bool game_started;
 };
 
 #endif
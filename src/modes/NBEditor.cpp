@@ -1,4 +1,5 @@
 #include "NBEditor.hpp"
+#include <algorithm>
 #include <vector>
 #include "../GUIHelpers.hpp"
 #include "../util/string.hpp"
@@ -30,9 +31,59 @@ enum NODEBOX_EDITOR_GUI_IDS {
 	ENB_GUI_ROT_Z
 };
 
+void NodeBoxListSource::attach(Project *new_project)
+{
+	detach();
+	project = new_project;
+	project->changes.addListener(this);
+}
+
+void NodeBoxListSource::detach()
+{
+	if (project)
+		project->changes.removeListener(this);
+	project = NULL;
+}
+
+u32 NodeBoxListSource::getRowCount() const
+{
+	Node *node = state->project->GetCurrentNode();
+	return node ? node->boxes.size() : 0;
+}
+
+stringw NodeBoxListSource::getRowText(u32 row) const
+{
+	Node *node = state->project->GetCurrentNode();
+	if (!node || row >= node->boxes.size())
+		return L"";
+	return narrow_to_wide(node->boxes[row]->name).c_str();
+}
+
+void NodeBoxListSource::onChange(const ChangeEvent &event)
+{
+	Node *node = state->project->GetCurrentNode();
+	if (!node || event.node != node || !state->menu || !state->menu->sidebar)
+		return;
+
+	IGUIVirtualList *lb = (IGUIVirtualList*) state->menu->sidebar->getElementFromId(ENB_GUI_MAIN_LISTBOX);
+	if (!lb)
+		return;
+
+	if (event.type == ECT_NODE) {
+		// The boxes may have been added, deleted or replaced
+		lb->refresh();
+	} else if (event.type == ECT_NODEBOX) {
+		std::vector<NodeBox*>::const_iterator it =
+				std::find(node->boxes.begin(), node->boxes.end(), event.box);
+		if (it != node->boxes.end())
+			lb->updateRow(it - node->boxes.begin());
+	}
+}
+
 NBEditor::NBEditor(EditorState* st) :
 	EditorMode(st),
 	current(-1),
+	list_source(st),
 	prop_needs_update(false)
 {
 	for (int i = 0; i < 4; i++) {
@@ -53,7 +104,8 @@ void NBEditor::load()
 	if (state->settings->getBool("hide_other_nodes"))
 		state->project->hideAllButCurrentNode();
 	else
-		state->project->remesh();
+		state->project->showAllNodes();
+	list_source.attach(state->project);
 
 	if (sidebar) {
 		sidebar->setText(L"Node Box Tool");
@@ -62,8 +114,8 @@ void NBEditor::load()
 				false, true, sidebar, ENB_GUI_MAIN_MSG);
 
 
-		IGUIListBox *lb = guienv->addListBox(rect<s32>(10, 35+20, 227, 133+20),
-				sidebar, ENB_GUI_MAIN_LISTBOX, true);
+		IGUIVirtualList *lb = guienv->addVirtualList(rect<s32>(10, 35+20, 227, 133+20),
+				&list_source, sidebar, ENB_GUI_MAIN_LISTBOX, true);
 
 		if (lb) {
 			lb->setVisible(false);
@@ -161,20 +213,15 @@ void NBEditor::load_ui()
 		sidebar->getElementFromId(ENB_GUI_MAIN_LISTBOX)->setVisible(false);
 		sidebar->getElementFromId(ENB_GUI_PROP)->setVisible(false);
 	} else {
-		IGUIListBox *lb = (IGUIListBox *) sidebar->getElementFromId(ENB_GUI_MAIN_LISTBOX);
+		IGUIVirtualList *lb = (IGUIVirtualList *) sidebar->getElementFromId(ENB_GUI_MAIN_LISTBOX);
 		sidebar->getElementFromId(ENB_GUI_MAIN_MSG)->setVisible(false);
 		sidebar->getElementFromId(ENB_GUI_PROP)->setVisible(false);
 
 		if (lb) {
-			lb->clear();
+			// Only the visible rows are read again, when the list is drawn
+			lb->refresh();
 			lb->setVisible(true);
-			std::vector<NodeBox*> & boxes = node->boxes;
-			for (std::vector<NodeBox*>::const_iterator it = boxes.begin();
-					it != boxes.end();
-					++it) {
-				lb->addItem(narrow_to_wide((*it)->name).c_str());
-			}
-			lb->setSelected(lb->getListItem(node->GetId()));
+			lb->setSelected(node->GetId());
 		}
 
 		fillProperties();
@@ -224,7 +271,9 @@ void NBEditor::fillProperties()
 
 
 void NBEditor::unload()
-{}
+{
+	list_source.detach();
+}
 
 
 void NBEditor::update(double dtime)
@@ -482,7 +531,7 @@ bool NBEditor::OnEvent(const irr::SEvent &event) {
 			}
 			case GUI_PROJ_DELETE_BOX: {
 				Node* node = state->project->GetCurrentNode();
-				IGUIListBox* lb = (IGUIListBox*) state->menu->sidebar->getElementFromId(ENB_GUI_MAIN_LISTBOX);
+				IGUIVirtualList* lb = (IGUIVirtualList*) state->menu->sidebar->getElementFromId(ENB_GUI_MAIN_LISTBOX);
 				if (node && node->GetNodeBox(lb->getSelected())){
 					node->deleteNodebox(lb->getSelected());
 					load_ui();
@@ -491,7 +540,7 @@ bool NBEditor::OnEvent(const irr::SEvent &event) {
 			}
 			case GUI_PROJ_CLONE: {
 				Node* node = state->project->GetCurrentNode();
-				IGUIListBox* lb = (IGUIListBox*) state->menu->sidebar->getElementFromId(ENB_GUI_MAIN_LISTBOX);
+				IGUIVirtualList* lb = (IGUIVirtualList*) state->menu->sidebar->getElementFromId(ENB_GUI_MAIN_LISTBOX);
 				if (node && node->GetNodeBox(lb->getSelected())){
 					node->cloneNodebox(lb->getSelected());
 					load_ui();
@@ -540,9 +589,33 @@ bool NBEditor::OnEvent(const irr::SEvent &event) {
 					node->flip(EAX_Z);
 				break;
 			}}
+		} else if (event.GUIEvent.EventType == EGET_MENU_ITEM_SELECTED) {
+			// Box operations from the Project menu
+			IGUIContextMenu *menu = (IGUIContextMenu *)event.GUIEvent.Caller;
+			Node *node = state->project->GetCurrentNode();
+			switch (menu->getItemCommandId(menu->getSelectedItem())) {
+			case GUI_PROJ_UNITE:
+				if (node) {
+					node->unite();
+					load_ui();
+				}
+				return true;
+			case GUI_PROJ_SUBTRACT:
+				if (node) {
+					node->subtract(node->GetId());
+					load_ui();
+				}
+				return true;
+			case GUI_PROJ_INTERSECT:
+				if (node) {
+					node->intersect(node->GetId());
+					load_ui();
+				}
+				return true;
+			}
 		} else if (event.GUIEvent.EventType == EGET_LISTBOX_CHANGED) {
 			Node* node = state->project->GetCurrentNode();
-			IGUIListBox* lb = (IGUIListBox*) state->menu->sidebar->getElementFromId(ENB_GUI_MAIN_LISTBOX);
+			IGUIVirtualList* lb = (IGUIVirtualList*) state->menu->sidebar->getElementFromId(ENB_GUI_MAIN_LISTBOX);
 			if (node && lb && node->GetNodeBox(lb->getSelected())){
 				node->select(lb->getSelected());
 			}
@@ -568,13 +641,13 @@ bool NBEditor::OnEvent(const irr::SEvent &event) {
 			}
 		} else if (event.KeyInput.Key == KEY_DELETE) {
 			Node* node = state->project->GetCurrentNode();
-			IGUIListBox* lb = (IGUIListBox*) state->menu->sidebar->getElementFromId(ENB_GUI_MAIN_LISTBOX);
+			IGUIVirtualList* lb = (IGUIVirtualList*) state->menu->sidebar->getElementFromId(ENB_GUI_MAIN_LISTBOX);
 			if (node && node->GetNodeBox(lb->getSelected())) {
 				node->deleteNodebox(lb->getSelected());
 			}
 			load_ui();
 		} else if (event.KeyInput.Key == KEY_DOWN) {
-			IGUIListBox* lb = (IGUIListBox*) state->menu->sidebar->getElementFromId(ENB_GUI_MAIN_LISTBOX);
+			IGUIVirtualList* lb = (IGUIVirtualList*) state->menu->sidebar->getElementFromId(ENB_GUI_MAIN_LISTBOX);
 			Node* node = state->project->GetCurrentNode();
 			if (node) {
 				int idx = node->GetId();
@@ -584,7 +657,7 @@ bool NBEditor::OnEvent(const irr::SEvent &event) {
 			}
 			load_ui();
 		} else if (event.KeyInput.Key == KEY_UP) {
-			IGUIListBox* lb = (IGUIListBox*) state->menu->sidebar->getElementFromId(ENB_GUI_MAIN_LISTBOX);
+			IGUIVirtualList* lb = (IGUIVirtualList*) state->menu->sidebar->getElementFromId(ENB_GUI_MAIN_LISTBOX);
 			Node* node = state->project->GetCurrentNode();
 			if (node) {
 				int idx = node->GetId();
@@ -613,7 +686,7 @@ void NBEditor::updateProperties()
 
 	try {
 		irr::core::stringc name = prop->getElementFromId(ENB_GUI_PROP_NAME)->getText();
-		nb->name = str_replace(std::string(name.c_str(), name.size()), ' ', '_');
+		std::string new_name = str_replace(std::string(name.c_str(), name.size()), ' ', '_');
 		vector3df one(
 			(f32)wcstod(prop->getElementFromId(ENB_GUI_PROP_X1)->getText(), NULL),
 			(f32)wcstod(prop->getElementFromId(ENB_GUI_PROP_Y1)->getText(), NULL),
@@ -630,13 +703,14 @@ void NBEditor::updateProperties()
 			two /= 16;
 		}
 
-		if (one != nb->one || two != nb->two) {
+		if (new_name != nb->name || one != nb->one || two != nb->two) {
+			nb->name = new_name;
 			nb->one = one;
 			nb->two = two;
-			nb->rebuild_needed = true;
+			nb->changed();
 		}
 		node->remesh();
-		load_ui();
+		fillProperties();
 	} catch(void* e) {
 		state->device->getGUIEnvironment()->addMessageBox(L"Update failed",
 				L"Please check that the properties contain only numbers.");
@@ -20,6 +20,25 @@ public:
 	bool visible;
 };
 
+// The rows of the box list: the name of each box in the current node.
+// While attached, the list follows changes to the node's boxes.
+class NodeBoxListSource : public IGUIVirtualListSource, public ChangeListener
+{
+public:
+	NodeBoxListSource(EditorState *state) : state(state), project(NULL) {}
+
+	// Call detach() before the project is deleted
+	void attach(Project *project);
+	void detach();
+
+	virtual u32 getRowCount() const;
+	virtual stringw getRowText(u32 row) const;
+	virtual void onChange(const ChangeEvent &event);
+private:
+	EditorState *state;
+	Project *project;
+};
+
 class EditorMode;
 class NBEditor :public EditorMode
 {
@@ -41,6 +60,7 @@ private:
 	bool wasmd;
 	int current;
 	CDR cdrs[20];
+	NodeBoxListSource list_source;
 	void load_ui();
 	void fillProperties();
 	void updateProperties();
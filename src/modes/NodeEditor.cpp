@@ -1,17 +1,76 @@
 #include "NodeEditor.hpp"
+#include <algorithm>
 #include <list>
 #include "../project/node.hpp"
 #include "../GUIHelpers.hpp"
 #include "../util/string.hpp"
 
+void NodeListSource::attach(Project *new_project)
+{
+	detach();
+	project = new_project;
+	rows.assign(project->nodes.begin(), project->nodes.end());
+	project->changes.addListener(this);
+}
+
+void NodeListSource::detach()
+{
+	if (project)
+		project->changes.removeListener(this);
+	project = NULL;
+	rows.clear();
+}
+
+u32 NodeListSource::getRowCount() const
+{
+	return rows.size();
+}
+
+stringw NodeListSource::getRowText(u32 row) const
+{
+	if (row >= rows.size() || !rows[row])
+		return L"";
+	return narrow_to_wide(rows[row]->name).c_str();
+}
+
+void NodeListSource::onChange(const ChangeEvent &event)
+{
+	IGUIVirtualList *lb = NULL;
+	if (state->menu && state->menu->sidebar)
+		lb = (IGUIVirtualList*) state->menu->sidebar->getElementFromId(NodeEditor::ENG_GUI_MAIN_LISTBOX);
+
+	std::vector<Node*>::iterator it = std::find(rows.begin(), rows.end(), event.node);
+	switch (event.type) {
+	case ECT_NODE_ADD:
+		rows.push_back(event.node);
+		if (lb)
+			lb->refresh();
+		break;
+	case ECT_NODE_DELETE:
+		if (it != rows.end())
+			rows.erase(it);
+		if (lb)
+			lb->refresh();
+		break;
+	case ECT_NODE:
+		if (lb && it != rows.end())
+			lb->updateRow(it - rows.begin());
+		break;
+	default:
+		break;
+	}
+}
+
 NodeEditor::NodeEditor(EditorState* st) :
-	EditorMode(st)
+	EditorMode(st),
+	list_source(st)
 {
 }
 
 void NodeEditor::load()
 {
-	state->project->remesh();
+	state->project->showAllNodes();
+	list_source.attach(state->project);
 	IGUIStaticText* sidebar = state->menu->sidebar;
 	IGUIEnvironment* guienv = state->device->getGUIEnvironment();
 
@@ -19,7 +78,8 @@ void NodeEditor::load()
 		return;
 
 	sidebar->setText(L"Node Tool");
-	IGUIListBox* lb = guienv->addListBox(rect<s32>(20, 30, 230, 128), sidebar, ENG_GUI_MAIN_LISTBOX, true);
+	IGUIVirtualList* lb = guienv->addVirtualList(rect<s32>(20, 30, 230, 128),
+			&list_source, sidebar, ENG_GUI_MAIN_LISTBOX, true);
 
 	if (lb) {
 		//lb->setVisible(false);
@@ -78,21 +138,14 @@ void NodeEditor::load_ui(){
 		return;
 	}
 
-	IGUIListBox* lb = (IGUIListBox*) sidebar->getElementFromId(ENG_GUI_MAIN_LISTBOX);
+	IGUIVirtualList* lb = (IGUIVirtualList*) sidebar->getElementFromId(ENG_GUI_MAIN_LISTBOX);
 
 	if (lb) {
-		lb->clear();
+		// Only the visible rows are read again, when the list is drawn
+		lb->refresh();
+		lb->setSelected(state->project->GetSelectedNodeId());
 		sidebar->getElementFromId(ENG_GUI_PROP)->setVisible(false);
 
-		std::list<Node*> & nodes = state->project->nodes;
-		for (std::list<Node*>::const_iterator it = nodes.begin();
-				it != nodes.end();
-				++it) {
-			std::wstring wide = narrow_to_wide((*it)->name);
-			lb->addItem(wide.c_str());
-		}
-		lb->setSelected(lb->getListItem(state->project->GetSelectedNodeId()));
-
 		fillProperties();
 	}
 }
@@ -131,7 +184,9 @@ void NodeEditor::fillProperties(){
 
 
 void NodeEditor::unload()
-{}
+{
+	list_source.detach();
+}
 
 
 void NodeEditor::update(double dtime)
@@ -178,7 +233,7 @@ bool NodeEditor::OnEvent(const irr::SEvent &event)
 				break;
 			}
 		} else if (event.GUIEvent.EventType == EGET_LISTBOX_CHANGED) {
-			IGUIListBox* lb = (IGUIListBox*) state->menu->sidebar->getElementFromId(ENG_GUI_MAIN_LISTBOX);
+			IGUIVirtualList* lb = (IGUIVirtualList*) state->menu->sidebar->getElementFromId(ENG_GUI_MAIN_LISTBOX);
 			if (lb && state->project->GetNode(lb->getSelected())){
 				state->project->SelectNode(lb->getSelected());
 				load_ui();
@@ -205,14 +260,14 @@ bool NodeEditor::OnEvent(const irr::SEvent &event)
 				return true;
 			}
 		} else if (event.KeyInput.Key == KEY_DOWN){
-			IGUIListBox* lb = (IGUIListBox*) state->menu->sidebar->getElementFromId(ENG_GUI_MAIN_LISTBOX);
+			IGUIVirtualList* lb = (IGUIVirtualList*) state->menu->sidebar->getElementFromId(ENG_GUI_MAIN_LISTBOX);
 			int idx = state->project->GetSelectedNodeId();
-			if (lb && idx < (int)state->project->GetNodeCount() - 1){
+			if (lb && idx < (int)state->project->nodes.size() - 1){
 				state->project->SelectNode(idx + 1);
 				load_ui();
 			}
 		} else if (event.KeyInput.Key == KEY_UP){
-			IGUIListBox* lb = (IGUIListBox*) state->menu->sidebar->getElementFromId(ENG_GUI_MAIN_LISTBOX);
+			IGUIVirtualList* lb = (IGUIVirtualList*) state->menu->sidebar->getElementFromId(ENG_GUI_MAIN_LISTBOX);
 			int idx = state->project->GetSelectedNodeId();
 			if (lb && idx > 0){
 				state->project->SelectNode(idx - 1);
@@ -232,7 +287,7 @@ void NodeEditor::updateProperties() {
 
 	try {
 		irr::core::stringc name = prop->getElementFromId(ENG_GUI_PROP_NAME)->getText();
-		node->name = str_replace(std::string(name.c_str(), name.size()), ' ', '_');
+		std::string new_name = str_replace(std::string(name.c_str(), name.size()), ' ', '_');
 		int y = (int)wcstod(prop->getElementFromId(ENG_GUI_PROP_Y)->getText(), NULL);
 		if (state->settings->getBool("no_negative_node_y") && y < 0) {
 			std::list<Node*> & nodes = state->project->nodes;
@@ -240,21 +295,30 @@ void NodeEditor::updateProperties() {
 					it != nodes.end();
 					++it) {
 				(*it)->position.Y -= y; // Remember, y is negative
+				(*it)->changed();
 			}
 			state->project->remesh();
 			y = 0;
 		}
 
-		node->position = vector3di(
+		vector3di position(
 			wcstod(prop->getElementFromId(ENG_GUI_PROP_X)->getText(), NULL),
 			y,
 			wcstod(prop->getElementFromId(ENG_GUI_PROP_Z)->getText(), NULL)
 		);
-		node->snap_res = wcstod(prop->getElementFromId(ENG_GUI_PROP_SNAP_RES)->getText(), NULL);
-		if (node->snap_res < 0)
-			node->snap_res = -1;
+		int snap_res = wcstod(prop->getElementFromId(ENG_GUI_PROP_SNAP_RES)->getText(), NULL);
+		if (snap_res < 0)
+			snap_res = -1;
+
+		if (new_name != node->name || position != node->position ||
+				snap_res != node->snap_res) {
+			node->name = new_name;
+			node->position = position;
+			node->snap_res = snap_res;
+			node->changed();
+		}
 		node->remesh();
-		load_ui();
+		fillProperties();
 	} catch(void* e) {
 		state->device->getGUIEnvironment()->addMessageBox(L"Update failed",
 				L"Please check that the properties contain only numbers.");
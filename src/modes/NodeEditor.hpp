@@ -1,8 +1,30 @@
 #ifndef NODEEDITOR_HPP_INCLUDED
 #define NODEEDITOR_HPP_INCLUDED
 #include "../common.hpp"
+#include <vector>
 #include "../EditorState.hpp"
 
+// The rows of the node list: the name of each node in the project.
+// The rows are kept in a vector, so that each is found without walking
+// the project's list, and follow the project's changes while attached.
+class NodeListSource : public IGUIVirtualListSource, public ChangeListener
+{
+public:
+	NodeListSource(EditorState *state) : state(state), project(NULL) {}
+
+	// Call detach() before the project is deleted
+	void attach(Project *project);
+	void detach();
+
+	virtual u32 getRowCount() const;
+	virtual stringw getRowText(u32 row) const;
+	virtual void onChange(const ChangeEvent &event);
+private:
+	EditorState *state;
+	Project *project;
+	std::vector<Node*> rows;
+};
+
 class EditorMode;
 class NodeEditor :public EditorMode
 {
@@ -36,6 +58,7 @@ public:
 		ENG_GUI_PROP_REVERT
 	};
 private:
+	NodeListSource list_source;
 	void load_ui();
 	void fillProperties();
 	void updateProperties();
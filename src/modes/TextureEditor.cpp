@@ -1,6 +1,7 @@
 #include "TextureEditor.hpp"
 #include <list>
 #include "../util/string.hpp"
+#include "../project/nodebox.hpp"
 #include "../dialogs/TextureDialog.hpp"
 
 TextureEditor::TextureEditor(EditorState* st) :
@@ -13,7 +14,7 @@ void TextureEditor::load()
 	if (state->settings->getBool("hide_other_nodes"))
 		state->project->hideAllButCurrentNode();
 	else
-		state->project->remesh();
+		state->project->showAllNodes();
 
 	IGUIStaticText* sidebar = state->menu->sidebar;
 
@@ -35,7 +36,7 @@ void drawIconAt(const wchar_t* label, int x, int y, Media::Image *image, IVideoD
 	if (!image || image->name == "default") {
 		driver->draw2DRectangle(SColor(100, 0, 0, 0), rect<s32>(x, y, x + 64, y + 64));
 	} else {
-		ITexture *texture = driver->addTexture("tmpicon.png", image->get());
+		ITexture *texture = addPixelArtTexture(driver, "tmpicon.png", image->get());
 		driver->draw2DImage(texture, rect<s32>(x, y, x + 64, y + 64),
 				rect<s32>(0, 0, texture->getSize().Width, texture->getSize().Height));
 		driver->removeTexture(texture);
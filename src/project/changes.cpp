@@ -0,0 +1,34 @@
+#include "changes.hpp"
+#include <algorithm>
+
+static Revision last_revision = 0;
+
+Revision newRevision()
+{
+	return ++last_revision;
+}
+
+void ChangeBus::addListener(ChangeListener *listener)
+{
+	if (std::find(listeners.begin(), listeners.end(), listener) == listeners.end())
+		listeners.push_back(listener);
+}
+
+void ChangeBus::removeListener(ChangeListener *listener)
+{
+	std::vector<ChangeListener*>::iterator it =
+			std::find(listeners.begin(), listeners.end(), listener);
+	if (it != listeners.end())
+		listeners.erase(it);
+}
+
+void ChangeBus::post(const ChangeEvent &event)
+{
+	// Copied, so that listeners can remove themselves
+	std::vector<ChangeListener*> current = listeners;
+	for (std::vector<ChangeListener*>::const_iterator it = current.begin();
+			it != current.end();
+			++it) {
+		(*it)->onChange(event);
+	}
+}
@@ -0,0 +1,65 @@
+#ifndef CHANGES_HPP_INCLUDED
+#define CHANGES_HPP_INCLUDED
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+// Revisions come from one counter shared by everything in the editor, so
+// a revision is never reused, and the newest of several revisions changes
+// whenever any of them does. Caches can store the revision they were made
+// from, and compare it to find out whether they are out of date.
+typedef unsigned int Revision;
+
+// Main thread only.
+Revision newRevision();
+
+class Node;
+class NodeBox;
+
+enum EChangeType
+{
+	ECT_NODE_ADD = 0, // A node was added to the project
+	ECT_NODE_DELETE,  // A node is about to be deleted
+	ECT_NODE,         // A node's name, position, textures or box list
+	ECT_NODEBOX,      // A box's name or geometry
+	ECT_MEDIA         // An image was added or replaced
+};
+
+class ChangeEvent
+{
+public:
+	ChangeEvent(EChangeType type, Revision revision):
+		type(type),
+		revision(revision),
+		node(NULL),
+		box(NULL)
+	{}
+
+	EChangeType type;
+	Revision revision;
+	Node *node;        // All but ECT_MEDIA
+	NodeBox *box;      // ECT_NODEBOX
+	std::string image; // ECT_MEDIA
+};
+
+class ChangeListener
+{
+public:
+	virtual ~ChangeListener() {}
+	virtual void onChange(const ChangeEvent &event) = 0;
+};
+
+// Tells listeners about changes to a project, as they are made.
+// Listeners are not owned, and must be removed before they are deleted.
+class ChangeBus
+{
+public:
+	void addListener(ChangeListener *listener);
+	void removeListener(ChangeListener *listener);
+	void post(const ChangeEvent &event);
+private:
+	std::vector<ChangeListener*> listeners;
+};
+
+#endif
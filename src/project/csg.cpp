@@ -0,0 +1,235 @@
+#include "csg.hpp"
+#include <algorithm>
+#include <map>
+#include <utility>
+
+// A box of either set. Only the axes from the one being swept on are used.
+struct CSGBox
+{
+	f32 lo[3];
+	f32 hi[3];
+	bool in_b;
+};
+
+static bool inside(ECSGOperation op, bool in_a, bool in_b)
+{
+	switch (op) {
+	case ECSG_UNION:
+		return in_a || in_b;
+	case ECSG_SUBTRACT:
+		return in_a && !in_b;
+	default:
+		return in_a && in_b;
+	}
+}
+
+struct LowerStart
+{
+	LowerStart(int axis) : axis(axis) {}
+	bool operator()(const CSGBox *a, const CSGBox *b) const
+	{
+		return a->lo[axis] < b->lo[axis];
+	}
+	int axis;
+};
+
+// Where a box starts or ends along Z
+struct CSGEdge
+{
+	f32 pos;
+	int change;
+	bool in_b;
+
+	bool operator<(const CSGEdge &other) const { return pos < other.pos; }
+};
+
+// The intervals along Z that are inside
+static void sweepLine(ECSGOperation op, const std::vector<const CSGBox*> &boxes,
+		std::vector<CSGBox> &out)
+{
+	std::vector<CSGEdge> edges;
+	edges.reserve(boxes.size() * 2);
+	for (std::vector<const CSGBox*>::const_iterator it = boxes.begin();
+			it != boxes.end();
+			++it) {
+		CSGEdge start = {(*it)->lo[2], 1, (*it)->in_b};
+		CSGEdge end = {(*it)->hi[2], -1, (*it)->in_b};
+		edges.push_back(start);
+		edges.push_back(end);
+	}
+	std::sort(edges.begin(), edges.end());
+
+	int count[2] = {0, 0};
+	bool was_inside = false;
+	f32 start = 0;
+	for (size_t i = 0; i < edges.size();) {
+		f32 pos = edges[i].pos;
+		for (; i < edges.size() && edges[i].pos == pos; i++)
+			count[edges[i].in_b] += edges[i].change;
+
+		bool is_inside = inside(op, count[0] > 0, count[1] > 0);
+		if (is_inside && !was_inside) {
+			start = pos;
+		} else if (!is_inside && was_inside) {
+			CSGBox box;
+			box.lo[2] = start;
+			box.hi[2] = pos;
+			box.in_b = false;
+			out.push_back(box);
+		}
+		was_inside = is_inside;
+	}
+}
+
+// What a result box looks like across the axes after the swept one
+typedef std::pair<std::pair<f32, f32>, std::pair<f32, f32> > CSGSection;
+
+static CSGSection getSection(const CSGBox &box, int axis)
+{
+	if (axis == 1)
+		return CSGSection(std::make_pair(box.lo[2], box.hi[2]), std::make_pair(0.f, 0.f));
+	return CSGSection(std::make_pair(box.lo[1], box.hi[1]),
+			std::make_pair(box.lo[2], box.hi[2]));
+}
+
+// Cuts the space into slabs across axis, wherever a box starts or ends,
+// and combines the boxes in each slab on the following axes. A result in
+// one slab that is the same as one in the slab before is grown into it.
+static void sweep(ECSGOperation op, std::vector<const CSGBox*> &boxes, int axis,
+		std::vector<CSGBox> &out)
+{
+	if (axis == 2) {
+		sweepLine(op, boxes, out);
+		return;
+	}
+
+	std::vector<f32> cuts;
+	cuts.reserve(boxes.size() * 2);
+	for (std::vector<const CSGBox*>::const_iterator it = boxes.begin();
+			it != boxes.end();
+			++it) {
+		cuts.push_back((*it)->lo[axis]);
+		cuts.push_back((*it)->hi[axis]);
+	}
+	std::sort(cuts.begin(), cuts.end());
+	cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+	std::sort(boxes.begin(), boxes.end(), LowerStart(axis));
+
+	std::vector<const CSGBox*> active;
+	std::vector<CSGBox> slab;
+	std::map<CSGSection, size_t> open, next_open;
+	size_t next = 0;
+	for (size_t i = 0; i + 1 < cuts.size(); i++) {
+		f32 lo = cuts[i];
+		f32 hi = cuts[i + 1];
+
+		// Boxes that cover the slab
+		size_t kept = 0;
+		for (size_t j = 0; j < active.size(); j++) {
+			if (active[j]->hi[axis] > lo)
+				active[kept++] = active[j];
+		}
+		active.resize(kept);
+		for (; next < boxes.size() && boxes[next]->lo[axis] <= lo; next++)
+			active.push_back(boxes[next]);
+
+		slab.clear();
+		if (!active.empty()) {
+			std::vector<const CSGBox*> copy(active);
+			sweep(op, copy, axis + 1, slab);
+		}
+
+		next_open.clear();
+		for (std::vector<CSGBox>::const_iterator it = slab.begin();
+				it != slab.end();
+				++it) {
+			CSGSection section = getSection(*it, axis);
+			std::map<CSGSection, size_t>::const_iterator found = open.find(section);
+			if (found != open.end()) {
+				out[found->second].hi[axis] = hi;
+				next_open[section] = found->second;
+			} else {
+				CSGBox box = *it;
+				box.lo[axis] = lo;
+				box.hi[axis] = hi;
+				next_open[section] = out.size();
+				out.push_back(box);
+			}
+		}
+		open.swap(next_open);
+	}
+}
+
+// Whether two boxes make a box together
+static bool canJoin(const CSGBox &a, const CSGBox &b, int &axis)
+{
+	int same = 0;
+	axis = -1;
+	for (int i = 0; i < 3; i++) {
+		if (a.lo[i] == b.lo[i] && a.hi[i] == b.hi[i])
+			same++;
+		else if (a.hi[i] == b.lo[i] || b.hi[i] == a.lo[i])
+			axis = i;
+	}
+	return same == 2 && axis != -1;
+}
+
+void combineBoxes(ECSGOperation op, const std::vector<aabbox3df> &a,
+		const std::vector<aabbox3df> &b, std::vector<aabbox3df> &out)
+{
+	std::vector<CSGBox> input;
+	input.reserve(a.size() + b.size());
+	for (size_t i = 0; i < a.size() + b.size(); i++) {
+		const aabbox3df &from = i < a.size() ? a[i] : b[i - a.size()];
+		f32 one[3] = {from.MinEdge.X, from.MinEdge.Y, from.MinEdge.Z};
+		f32 two[3] = {from.MaxEdge.X, from.MaxEdge.Y, from.MaxEdge.Z};
+		CSGBox box;
+		bool flat = false;
+		for (int axis = 0; axis < 3; axis++) {
+			box.lo[axis] = std::min(one[axis], two[axis]);
+			box.hi[axis] = std::max(one[axis], two[axis]);
+			if (box.lo[axis] == box.hi[axis])
+				flat = true;
+		}
+		box.in_b = i >= a.size();
+		if (!flat)
+			input.push_back(box);
+	}
+
+	std::vector<const CSGBox*> boxes;
+	boxes.reserve(input.size());
+	for (size_t i = 0; i < input.size(); i++)
+		boxes.push_back(&input[i]);
+
+	std::vector<CSGBox> result;
+	sweep(op, boxes, 0, result);
+
+	// The sweep only grows boxes along the axis it cuts across, so join
+	// any that it left side by side
+	bool joined = true;
+	while (joined) {
+		joined = false;
+		for (size_t i = 0; i < result.size(); i++) {
+			for (size_t j = i + 1; j < result.size(); j++) {
+				int axis;
+				if (!canJoin(result[i], result[j], axis))
+					continue;
+				result[i].lo[axis] = std::min(result[i].lo[axis], result[j].lo[axis]);
+				result[i].hi[axis] = std::max(result[i].hi[axis], result[j].hi[axis]);
+				result.erase(result.begin() + j);
+				joined = true;
+				j = i;
+			}
+		}
+	}
+
+	out.clear();
+	out.reserve(result.size());
+	for (std::vector<CSGBox>::const_iterator it = result.begin();
+			it != result.end();
+			++it) {
+		out.push_back(aabbox3df(it->lo[0], it->lo[1], it->lo[2],
+				it->hi[0], it->hi[1], it->hi[2]));
+	}
+}
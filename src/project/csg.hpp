@@ -0,0 +1,25 @@
+#ifndef CSG_HPP_INCLUDED
+#define CSG_HPP_INCLUDED
+
+#include <vector>
+#include "../common.hpp"
+
+enum ECSGOperation
+{
+	ECSG_UNION = 0, // In a or b
+	ECSG_SUBTRACT,  // In a but not b
+	ECSG_INTERSECT  // In both a and b
+};
+
+// Combines two sets of boxes, giving boxes that don't overlap. Either set
+// may overlap itself. Boxes with no volume are ignored.
+//
+// The space is swept along X, then Y within each slab of X, and then Z,
+// so that the result is made of the largest boxes found that way, which
+// are then joined where two make a box. That is a small set, though not
+// always the smallest possible one. Every coordinate of the result is one
+// of the input's, so nothing moves off the grid.
+void combineBoxes(ECSGOperation op, const std::vector<aabbox3df> &a,
+		const std::vector<aabbox3df> &b, std::vector<aabbox3df> &out);
+
+#endif
@@ -1,18 +1,214 @@
 #include "media.hpp"
+#include <algorithm>
+#include <fstream>
+#include <string.h>
 #include "../util/filesys.hpp"
+#include "../util/Log.hpp"
+
+// Incremented every time an image is used, to find the least recently used
+static unsigned int media_clock = 0;
+
+// Level given to the original contents of files, which are never re-encoded
+#define ORIGINAL_LEVEL 10
+
+// zlib's default
+#define DEFAULT_LEVEL 6
+
+// Writes to a growing buffer in memory
+class VectorWriteFile : public io::IWriteFile
+{
+public:
+	VectorWriteFile(std::vector<char> &target, const io::path &filename):
+		target(target),
+		pos(0),
+		filename(filename)
+	{}
+
+	virtual size_t write(const void *buffer, size_t sizeToWrite)
+	{
+		if (pos + sizeToWrite > target.size())
+			target.resize(pos + sizeToWrite);
+		memcpy(&target[pos], buffer, sizeToWrite);
+		pos += sizeToWrite;
+		return sizeToWrite;
+	}
+
+	virtual bool seek(long finalPos, bool relativeMovement = false)
+	{
+		long newpos = relativeMovement ? (long)pos + finalPos : finalPos;
+		if (newpos < 0)
+			return false;
+		pos = newpos;
+		return true;
+	}
+
+	virtual long getPos() const { return pos; }
+	virtual const io::path &getFileName() const { return filename; }
+	virtual bool flush() { return true; }
+private:
+	std::vector<char> &target;
+	size_t pos;
+	io::path filename;
+};
+
+static bool isPNG(const std::string &filename, const std::vector<char> &bytes)
+{
+	static const char signature[8] = {(char)0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+	if (bytes.size() < 8 || memcmp(&bytes[0], signature, 8) != 0)
+		return false;
+	return filename.size() >= 4 &&
+			str_to_lower(filename.substr(filename.size() - 4)) == ".png";
+}
+
+IImage *Media::Image::get()
+{
+	last_used = ++media_clock;
+	if (!data && device && !encoded.empty()) {
+		io::IReadFile *file = device->getFileSystem()->createMemoryReadFile(
+				&encoded[0], encoded.size(), name.c_str(), false);
+		data = device->getVideoDriver()->createImageFromFile(file);
+		file->drop();
+		if (!data)
+			NBE_LOG(ELV_ERROR, ELC_MEDIA, "Failed to decode image '" << name << "'");
+	}
+	return data;
+}
+
+void Media::Image::update(IImage *ndata)
+{
+	if (data)
+		data->drop();
+	data = ndata;
+	encoded.clear();
+	revision = newRevision();
+}
+
+void Media::Image::update(const std::vector<char> &bytes, IrrlichtDevice *the_device,
+		IImage *decoded)
+{
+	if (data)
+		data->drop();
+	data = decoded;
+	encoded = bytes;
+	encoded_level = ORIGINAL_LEVEL;
+	device = the_device;
+	revision = newRevision();
+}
+
+bool Media::Image::needsEncoding(u32 level) const
+{
+	return encoded.empty() || (level > 0 && encoded_level < level);
+}
+
+bool Media::Image::encode(IVideoDriver *driver, u32 level)
+{
+	if (!data)
+		return false;
+
+	std::vector<char> result;
+	VectorWriteFile file(result, name.c_str());
+	if (!driver->writeImageToFile(data, &file, level))
+		return false;
+
+	encoded.swap(result);
+	encoded_level = (level > 0) ? level : DEFAULT_LEVEL;
+	return true;
+}
+
+const std::vector<char> *Media::Image::getEncoded(IVideoDriver *driver, u32 level)
+{
+	if (needsEncoding(level)) {
+		if (!get() || !encode(driver, level))
+			return encoded.empty() ? NULL : &encoded;
+	}
+	return &encoded;
+}
+
+bool Media::Image::write(IVideoDriver *driver, const std::string &filename, u32 level)
+{
+	const std::vector<char> *bytes = getEncoded(driver, level);
+	if (!bytes)
+		return false;
+
+	// Unchanged images are left alone, so that exporting a mod again
+	// only rewrites what was edited
+	return syncFile(filename, &(*bytes)[0], bytes->size());
+}
+
+size_t Media::Image::getMemoryUsage() const
+{
+	size_t size = encoded.size();
+	if (data)
+		size += data->getImageDataSizeInBytes();
+	return size;
+}
+
+bool Media::Image::evict(IrrlichtDevice *the_device)
+{
+	if (!data)
+		return false;
+
+	if (needsEncoding() && !encode(the_device->getVideoDriver()))
+		return false;
+
+	device = the_device;
+	data->drop();
+	data = NULL;
+	return true;
+}
+
+static bool compareLastUsed(Media::Image *a, Media::Image *b)
+{
+	return a->getLastUsed() < b->getLastUsed();
+}
 
 Media::~Media()
 {
-	for (std::map<std::string, Media::Image*>::const_iterator it = images.begin();
+	for (std::vector<Media::Image*>::const_iterator it = images.begin();
 			it != images.end();
 			++it) {
-		delete it->second;
+		delete *it;
 	}
 }
 
-bool Media::import(std::string filepath, std::string filename, IVideoDriver* driver)
+bool Media::import(std::string filepath, std::string filename, IrrlichtDevice *device,
+		bool overwrite)
 {
-	return add(filepath, filename, driver->createImageFromFile(filepath.c_str()));
+	std::ifstream file(filepath.c_str(), std::ios::binary|std::ios::ate);
+	if (!file)
+		return false;
+
+	std::vector<char> bytes((size_t)file.tellg());
+	file.seekg(0, std::ios::beg);
+	if (!bytes.empty())
+		file.read(&bytes[0], bytes.size());
+	if (!file)
+		return false;
+
+	return add(filepath, filename, bytes, device, overwrite);
+}
+
+Media::Image *Media::reserve(std::string filename, bool overwrite)
+{
+	Media::Image *existing = get(filename.c_str(), filename.size());
+	if (existing) {
+		if (overwrite) {
+			NBE_LOG(ELV_VERBOSE, ELC_MEDIA, "Overwriting '" << filename << "'");
+			return existing;
+		} else {
+			NBE_LOG(ELV_WARNING, ELC_MEDIA, "Failed to add image '" << filename
+					<< "', it already exists (and overwrite was not authorised)");
+			return NULL;
+		}
+	}
+
+	NBE_LOG(ELV_VERBOSE, ELC_MEDIA, "Adding '" << filename << "'");
+	Media::Image *image = new Media::Image(filename.c_str());
+	NameId id = names.add(filename);
+	assert(id == images.size());
+	(void)id;
+	images.push_back(image);
+	return image;
 }
 
 bool Media::add(std::string filepath, std::string filename, IImage *image, bool overwrite)
@@ -20,50 +216,196 @@ bool Media::add(std::string filepath, std::string filename, IImage *image, bool
 	if (!image)
 		return false;
 
+	Media::Image *target = reserve(trim(filename), overwrite);
+	if (!target)
+		return false;
+
+	target->update(image);
+	target->origpath = filepath;
+	changed(target);
+	return true;
+}
+
+bool Media::add(std::string filepath, std::string filename, const std::vector<char> &bytes,
+		IrrlichtDevice *device, bool overwrite)
+{
 	filename = trim(filename);
-	const char *shortpath = filename.c_str();
-	if (images[shortpath] != NULL) {
-		if (overwrite) {
-			std::cerr << "Overwriting '" << shortpath << "'" << std::endl;
-			images[shortpath]->update(image);
-			images[shortpath]->origpath = filepath;
-		} else {
-			std::cerr << "Failed to add image '" << shortpath
-					<< "', it already exists (and overwrite was not authorised)"
-					<< std::endl;
+
+	// Other formats are decoded now, so that they are saved as the format
+	// given by their name
+	if (!isPNG(filename, bytes)) {
+		if (bytes.empty())
 			return false;
-		}
-	} else {
-		std::cerr << "Adding '" << shortpath << "'" << std::endl;
-		images[shortpath] = new Media::Image(shortpath, image);
-		images[shortpath]->origpath = filepath;
+		io::IReadFile *file = device->getFileSystem()->createMemoryReadFile(
+				(void*)&bytes[0], bytes.size(), filename.c_str(), false);
+		IImage *image = device->getVideoDriver()->createImageFromFile(file);
+		file->drop();
+		return add(filepath, filename, image, overwrite);
 	}
+
+	Media::Image *target = reserve(filename, overwrite);
+	if (!target)
+		return false;
+
+	target->update(bytes, device);
+	target->origpath = filepath;
+	changed(target);
+	return true;
+}
+
+bool Media::reload(Media::Image *image, const std::vector<char> &bytes, IImage *decoded,
+		IrrlichtDevice *device)
+{
+	if (!decoded)
+		return false;
+
+	NBE_LOG(ELV_VERBOSE, ELC_MEDIA, "Reloading '" << image->name << "'");
+	if (isPNG(image->name, bytes))
+		image->update(bytes, device, decoded);
+	else
+		image->update(decoded);
+	changed(image);
 	return true;
 }
 
-Media::Image *Media::get(const char* name)
+void Media::changed(Media::Image *image)
 {
-	if (!images[name]) {
-		return NULL;
+	revision = image->getRevision();
+	if (changes) {
+		ChangeEvent event(ECT_MEDIA, revision);
+		event.image = image->name;
+		changes->post(event);
 	}
-	return images[name];
+}
+
+Media::Image *Media::get(const char *name, size_t size) const
+{
+	return get(names.find(name, size));
+}
+
+static bool compareName(Media::Image *a, Media::Image *b)
+{
+	return a->name < b->name;
+}
+
+void Media::getSorted(std::vector<Media::Image*> &out) const
+{
+	out = images;
+	std::sort(out.begin(), out.end(), compareName);
 }
 
 void Media::debug()
 {
 	std::cerr << "Media Manager:" << std::endl;
-	for (std::map<std::string, Media::Image*>::const_iterator it = images.begin();
+	for (std::vector<Media::Image*>::const_iterator it = images.begin();
+			it != images.end();
+			++it) {
+		std::cerr << (*it)->name.c_str() << " (" << (*it)->getHolders() << ", "
+				<< formatBytes((*it)->getMemoryUsage()) << ")" << std::endl;
+	}
+}
+
+void Media::getMemoryUsage(MemoryUsage &usage) const
+{
+	for (std::vector<Media::Image*>::const_iterator it = images.begin();
+			it != images.end();
+			++it) {
+		usage.add(EMC_IMAGE, (*it)->getMemoryUsage());
+	}
+}
+
+class EncodeTask : public ThreadPool::Task
+{
+public:
+	EncodeTask(Media::Image *image, IVideoDriver *driver, u32 level):
+		image(image),
+		driver(driver),
+		level(level)
+	{}
+
+	virtual void run() { image->encode(driver, level); }
+private:
+	Media::Image *image;
+	IVideoDriver *driver;
+	u32 level;
+};
+
+void Media::encode(IVideoDriver *driver, ThreadPool *threads, u32 level)
+{
+	// Decode on this thread, as decoding isn't thread safe
+	std::vector<EncodeTask*> tasks;
+	for (std::vector<Media::Image*>::const_iterator it = images.begin();
+			it != images.end();
+			++it) {
+		Media::Image *image = *it;
+		if (image->needsEncoding(level) && image->get())
+			tasks.push_back(new EncodeTask(image, driver, level));
+	}
+
+	for (std::vector<EncodeTask*>::const_iterator it = tasks.begin();
+			it != tasks.end();
+			++it) {
+		threads->add(*it);
+	}
+	threads->wait();
+
+	for (std::vector<EncodeTask*>::const_iterator it = tasks.begin();
+			it != tasks.end();
+			++it) {
+		delete *it;
+	}
+}
+
+size_t Media::evictUnused(IrrlichtDevice *device, size_t amount)
+{
+	std::vector<Media::Image*> candidates;
+	for (std::vector<Media::Image*>::const_iterator it = images.begin();
 			it != images.end();
 			++it) {
-		std::cerr << it->second->name.c_str() << " (" << it->second->getHolders() << ")" << std::endl;
+		Media::Image *image = *it;
+		if (image->isLoaded() && image->getHolders() == 0)
+			candidates.push_back(image);
+	}
+	std::sort(candidates.begin(), candidates.end(), compareLastUsed);
+
+	size_t freed = 0;
+	for (std::vector<Media::Image*>::const_iterator it = candidates.begin();
+			it != candidates.end() && freed < amount;
+			++it) {
+		size_t size = (*it)->getMemoryUsage();
+		if ((*it)->evict(device)) {
+			size -= (*it)->getMemoryUsage();
+			NBE_LOG(ELV_VERBOSE, ELC_MEDIA, "Evicted '" << (*it)->name << "' (" << formatBytes(size) << ")");
+			freed += size;
+		}
+	}
+	return freed;
+}
+
+size_t Media::releaseIdle(IrrlichtDevice *device)
+{
+	size_t freed = 0;
+	for (std::vector<Media::Image*>::const_iterator it = images.begin();
+			it != images.end();
+			++it) {
+		Media::Image *image = *it;
+		if (!image->isLoaded() || image->getLastUsed() > idle_mark)
+			continue;
+
+		// Textures are copies, so images on node faces can be freed too
+		size_t size = image->getMemoryUsage();
+		if (image->evict(device))
+			freed += size - image->getMemoryUsage();
 	}
+	idle_mark = media_clock;
+	return freed;
 }
 
 void Media::clearGrabs()
 {
-	for (std::map<std::string, Media::Image*>::const_iterator it = images.begin();
+	for (std::vector<Media::Image*>::const_iterator it = images.begin();
 			it != images.end();
 			++it) {
-		it->second->dropAll();
+		(*it)->dropAll();
 	}
 }
@@ -2,7 +2,12 @@
 #define MEDIAMANAGER_HPP_INCLUDED
 #include "../common.hpp"
 #include <assert.h>
-#include <map>
+#include <vector>
+#include "memory.hpp"
+#include "changes.hpp"
+#include "../util/Log.hpp"
+#include "../util/NameTable.hpp"
+#include "../util/ThreadPool.hpp"
 
 class Media
 {
@@ -12,41 +17,154 @@ public:
 	public:
 		Image(const char *the_name, IImage *the_data):
 			name(the_name),
+			origpath(""),
 			data(the_data),
 			holders(0),
-			origpath("")
+			device(NULL),
+			last_used(0),
+			encoded_level(0),
+			revision(newRevision())
+		{}
+
+		Image(const char *the_name):
+			name(the_name),
+			origpath(""),
+			data(NULL),
+			holders(0),
+			device(NULL),
+			last_used(0),
+			encoded_level(0),
+			revision(newRevision())
 		{}
 
 		Image():
-			data(NULL)
+			data(NULL),
+			holders(0),
+			device(NULL),
+			last_used(0),
+			encoded_level(0),
+			revision(newRevision())
 		{}
 
+		~Image() { if (data) data->drop(); }
+
 		std::string name;
 		std::string origpath;
 
-		IImage *get() const { return data; }
+		// Returns the decoded image, decoding it if it isn't loaded yet.
+		IImage *get();
 		void grab() { holders++; }
 		void drop() { assert(holders > 0); holders--; }
 		void dropAll() { holders = 0; }
-		void deleteImage() { data->drop(); }
 		unsigned int getHolders() const { return holders; }
-		void update(IImage *ndata) { data->drop(); data = ndata; }
+
+		// Changes whenever the image is replaced
+		Revision getRevision() const { return revision; }
+		void update(IImage *ndata);
+
+		// Replaces the image with compressed file contents, which are
+		// only decoded when the image is used, unless they are given
+		// already decoded. Takes ownership of decoded.
+		void update(const std::vector<char> &bytes, IrrlichtDevice *device,
+				IImage *decoded = NULL);
+
+		// Returns the image as a file in the format given by its name,
+		// encoding it if there is no compressed copy yet, or if the copy
+		// was compressed with a lower zlib level than `level`.
+		// A level of 0 accepts any copy, and uses the default when encoding.
+		// The original file contents of imported images are always used.
+		const std::vector<char> *getEncoded(IVideoDriver *driver, u32 level = 0);
+		bool write(IVideoDriver *driver, const std::string &filename, u32 level = 0);
+		bool needsEncoding(u32 level = 0) const;
+
+		// Encodes the decoded image, which must be loaded. Safe to call
+		// on different images from several threads.
+		bool encode(IVideoDriver *driver, u32 level = 0);
+
+		// Memory management
+		bool isLoaded() const { return data != NULL; }
+		size_t getMemoryUsage() const;
+		unsigned int getLastUsed() const { return last_used; }
+
+		// Frees the decoded pixels, keeping a compressed copy to decode from
+		// when the image is next used.
+		bool evict(IrrlichtDevice *device);
 	private:
 		IImage *data;
 		unsigned int holders;
+		std::vector<char> encoded;
+		IrrlichtDevice *device;
+		unsigned int last_used;
+		u32 encoded_level;
+		Revision revision;
 	};
 
-	Media() { std::cerr << "Media Manager created!" << std::endl; }
-	Media(const Media &old) { std::cerr << "Media Manager copied! (This shouldn't happen)" << std::endl; }
+	Media():
+		changes(NULL),
+		revision(newRevision()),
+		idle_mark(0)
+	{ NBE_LOG(ELV_VERBOSE, ELC_MEDIA, "Media Manager created!"); }
+	Media(const Media &old) { NBE_LOG(ELV_ERROR, ELC_MEDIA, "Media Manager copied! (This shouldn't happen)"); }
 	~Media();
-	bool import(std::string filepath, std::string filename, IVideoDriver* driver);
+	bool import(std::string filepath, std::string filename, IrrlichtDevice *device,
+			bool overwrite = false);
 	bool add(std::string filepath, std::string filename, IImage *image, bool overwrite = false);
-	Media::Image *get(const char* name);
+
+	// Adds an image from the contents of an image file. PNG files are kept
+	// compressed and decoded on first use.
+	bool add(std::string filepath, std::string filename, const std::vector<char> &bytes,
+			IrrlichtDevice *device, bool overwrite = false);
+
+	// Replaces image with new contents of the file it came from, and the
+	// same contents decoded, which can be done on another thread. Takes
+	// ownership of decoded.
+	bool reload(Media::Image *image, const std::vector<char> &bytes, IImage *decoded,
+			IrrlichtDevice *device);
+
+	// Lookups never add anything, and give NULL for unknown names
+	Media::Image *get(const char *name) const { return get(name, strlen(name)); }
+	Media::Image *get(const char *name, size_t size) const;
+	Media::Image *get(NameId id) const { return (id < images.size()) ? images[id] : NULL; }
+	NameId getId(const char *name, size_t size) const { return names.find(name, size); }
+
+	// Changes whenever an image is added or replaced
+	Revision getRevision() const { return revision; }
 	void clearGrabs();
 	void debug();
-	std::map<std::string, Media::Image*>& getList() const {return (std::map<std::string, Media::Image*>&)images;};
+
+	// Encodes the images that need it for `level` on the thread pool,
+	// so that saving only has to copy the results.
+	void encode(IVideoDriver *driver, ThreadPool *threads, u32 level = 0);
+
+	// Memory management
+	void getMemoryUsage(MemoryUsage &usage) const;
+
+	// Evicts the least recently used images that aren't on any node face,
+	// until at least `amount` bytes are freed. Returns the bytes freed.
+	size_t evictUnused(IrrlichtDevice *device, size_t amount);
+
+	// Frees the decoded pixels of images that haven't been used since the
+	// last call. Returns the bytes freed.
+	size_t releaseIdle(IrrlichtDevice *device);
+
+	// Every image, by id, which is the order they were added in
+	const std::vector<Media::Image*> &getList() const { return images; }
+
+	// Every image, sorted by name
+	void getSorted(std::vector<Media::Image*> &out) const;
+
+	// Where changes are posted, or NULL
+	ChangeBus *changes;
 private:
-	std::map<std::string, Media::Image*> images;
+	Media::Image *reserve(std::string filename, bool overwrite);
+	void changed(Media::Image *image);
+
+	Revision revision;
+
+	// The image with id `i` is images[i]
+	NameTable names;
+	std::vector<Media::Image*> images;
+	unsigned int idle_mark;
 };
 
 #endif
@@ -0,0 +1,66 @@
+#include "memory.hpp"
+#include <stdio.h>
+
+const char *getMemoryCategoryName(EMemoryCategory category)
+{
+	switch (category) {
+	case EMC_IMAGE:
+		return "Images";
+	case EMC_TEXTURE:
+		return "Textures";
+	case EMC_MESH:
+		return "Meshes";
+	default:
+		return "Unknown";
+	}
+}
+
+size_t getTextureMemory(ITexture *texture)
+{
+	if (!texture)
+		return 0;
+
+	dimension2d<u32> size = texture->getSize();
+	u32 bpp = IImage::getBitsPerPixelFromFormat(texture->getColorFormat());
+	if (bpp == 0)
+		bpp = 32;
+	size_t bytes = (size_t)size.Width * size.Height * bpp / 8;
+
+	// A full mipmap chain adds a third
+	if (texture->hasMipMaps())
+		bytes += bytes / 3;
+	return bytes;
+}
+
+size_t getMeshMemory(IMesh *mesh)
+{
+	if (!mesh)
+		return 0;
+
+	size_t bytes = 0;
+	for (u32 i = 0; i < mesh->getMeshBufferCount(); i++) {
+		IMeshBuffer *buffer = mesh->getMeshBuffer(i);
+		bytes += buffer->getVertexCount() * getVertexPitchFromType(buffer->getVertexType());
+		bytes += buffer->getIndexCount() *
+				(buffer->getIndexType() == EIT_16BIT ? sizeof(u16) : sizeof(u32));
+	}
+	return bytes;
+}
+
+std::string formatBytes(size_t bytes)
+{
+	static const char *units[] = {"B", "KB", "MB", "GB"};
+	double value = (double)bytes;
+	int unit = 0;
+	while (value >= 1024 && unit < 3) {
+		value /= 1024;
+		unit++;
+	}
+
+	char buffer[32];
+	if (unit == 0)
+		snprintf(buffer, sizeof(buffer), "%u B", (unsigned int)bytes);
+	else
+		snprintf(buffer, sizeof(buffer), "%.1f %s", value, units[unit]);
+	return buffer;
+}
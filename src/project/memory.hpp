@@ -0,0 +1,51 @@
+#ifndef MEMORY_HPP_INCLUDED
+#define MEMORY_HPP_INCLUDED
+#include <string>
+#include "../common.hpp"
+
+enum EMemoryCategory
+{
+	EMC_IMAGE = 0, // Decoded images held by Media (CPU)
+	EMC_TEXTURE,   // Textures created for box faces (GPU)
+	EMC_MESH,      // Vertex and index buffers of box meshes (CPU)
+	EMC_COUNT
+};
+
+// Bytes held by the project, per category
+class MemoryUsage
+{
+public:
+	MemoryUsage()
+	{
+		for (int i = 0; i < EMC_COUNT; i++)
+			bytes[i] = 0;
+	}
+
+	void add(EMemoryCategory category, size_t amount) { bytes[category] += amount; }
+	size_t get(EMemoryCategory category) const { return bytes[category]; }
+	size_t getCPU() const { return bytes[EMC_IMAGE] + bytes[EMC_MESH]; }
+	size_t getGPU() const { return bytes[EMC_TEXTURE]; }
+	size_t total() const { return getCPU() + getGPU(); }
+
+	MemoryUsage &operator+=(const MemoryUsage &other)
+	{
+		for (int i = 0; i < EMC_COUNT; i++)
+			bytes[i] += other.bytes[i];
+		return *this;
+	}
+private:
+	size_t bytes[EMC_COUNT];
+};
+
+const char *getMemoryCategoryName(EMemoryCategory category);
+
+// Estimated video memory used by a texture, including mipmaps
+size_t getTextureMemory(ITexture *texture);
+
+// Memory used by the vertex and index buffers of a mesh
+size_t getMeshMemory(IMesh *mesh);
+
+// Formats a byte count as "12.3 MB"
+std::string formatBytes(size_t bytes);
+
+#endif
@@ -0,0 +1,48 @@
+#include "meshbatch.hpp"
+#include "../EditorState.hpp"
+
+MeshBatch::MeshBatch(EditorState *state):
+	state(state)
+{}
+
+MeshBatch::~MeshBatch()
+{
+	for (std::vector<Job*>::iterator it = jobs.begin();
+			it != jobs.end();
+			++it) {
+		delete *it;
+	}
+}
+
+void MeshBatch::add(NodeBox *box, vector3di nd_position, Media::Image* images[6], bool force)
+{
+	IVideoDriver *driver = state->device->getVideoDriver();
+	Job *job = new Job(box, driver);
+	if (!box->beginMesh(job->data, state, nd_position, driver, images, force)) {
+		delete job;
+		return;
+	}
+	jobs.push_back(job);
+}
+
+void MeshBatch::build()
+{
+	if (jobs.size() == 1) {
+		jobs[0]->run();
+	} else if (jobs.size() > 1) {
+		for (std::vector<Job*>::iterator it = jobs.begin();
+				it != jobs.end();
+				++it) {
+			state->threads->add(*it);
+		}
+		state->threads->wait();
+	}
+
+	for (std::vector<Job*>::iterator it = jobs.begin();
+			it != jobs.end();
+			++it) {
+		(*it)->box->finishMesh((*it)->data, state->device);
+		delete *it;
+	}
+	jobs.clear();
+}
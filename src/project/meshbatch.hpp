@@ -0,0 +1,43 @@
+#ifndef MESHBATCH_HPP_INCLUDED
+#define MESHBATCH_HPP_INCLUDED
+
+#include <vector>
+#include "../common.hpp"
+#include "../util/ThreadPool.hpp"
+#include "nodebox.hpp"
+
+class EditorState;
+
+// Rebuilds the meshes of many node boxes at once.
+// The geometry and shaded images are made on the editor's thread pool,
+// then the textures and scene nodes are created on the main thread.
+class MeshBatch
+{
+public:
+	MeshBatch(EditorState *state);
+	~MeshBatch();
+
+	// Queues the box if its mesh needs to be rebuilt
+	void add(NodeBox *box, vector3di nd_position, Media::Image* images[6], bool force = false);
+	void build();
+private:
+	class Job : public ThreadPool::Task
+	{
+	public:
+		Job(NodeBox *box, IVideoDriver *driver):
+			box(box),
+			driver(driver)
+		{}
+
+		virtual void run() { box->prepareMesh(data, driver); }
+
+		NodeBox *box;
+		IVideoDriver *driver;
+		NodeBox::MeshData data;
+	};
+
+	EditorState *state;
+	std::vector<Job*> jobs;
+};
+
+#endif
@@ -1,13 +1,18 @@
 #include "../util/string.hpp"
 #include "node.hpp"
+#include "meshbatch.hpp"
+#include "project.hpp"
 
 Node::Node(IrrlichtDevice* device, EditorState* state, unsigned int id) :
-	device(device),
-	state(state),
+	snap_res(-1),
+	project(NULL),
 	_selected(-1),
 	_nid(id),
 	_box_count(0),
-	snap_res(-1)
+	_hidden(false),
+	device(device),
+	state(state),
+	revision(newRevision())
 {
 	for (int i = 0; i < 6; i++) {
 		images[i] = NULL;
@@ -27,6 +32,7 @@ void Node::setAllTextures(Media::Image *def)
 		def->grab();
 		images[i] = def;
 	}
+	changed();
 }
 
 Node::~Node()
@@ -52,7 +58,7 @@ NodeBox* Node::GetCurrentNodeBox()
 
 NodeBox* Node::GetNodeBox(int id)
 {
-	if (id < 0 || id > (int)boxes.size()) {
+	if (id < 0 || id >= (int)boxes.size()) {
 		return NULL;
 	}
 
@@ -60,19 +66,22 @@ NodeBox* Node::GetNodeBox(int id)
 }
 
 // Operation functions
-NodeBox* Node::addNodeBox(vector3df one, vector3df two)
+NodeBox* Node::addNodeBox(vector3df one, vector3df two, bool build_mesh)
 {
 	_box_count++;
 
 	// Set up structure
 	std::string name = "NodeBox" + num_to_str(_box_count);
 	NodeBox *tmp = new NodeBox(name, one, two);
+	tmp->parent = this;
 	boxes.push_back(tmp);
+	changed();
 
 	// Select
 	select(boxes.size() - 1);
 
-	tmp->buildMesh(state, position, device, images);
+	if (build_mesh)
+		tmp->buildMesh(state, position, device, images);
 
 	return tmp;
 }
@@ -88,6 +97,7 @@ void Node::deleteNodebox(int id)
 	boxes.erase(boxes.begin() + id);
 	if (GetId() >= (int)boxes.size())
 		_selected = boxes.size() - 1;
+	changed();
 }
 
 void Node::cloneNodebox(int id)
@@ -99,6 +109,7 @@ void Node::cloneNodebox(int id)
 	NodeBox *new_nb = addNodeBox();
 	new_nb->one = nb->one;
 	new_nb->two = nb->two;
+	new_nb->changed();
 	new_nb->buildMesh(state, position, device, images);
 }
 
@@ -109,16 +120,24 @@ void Node::setTexture(ECUBE_SIDE face, Media::Image *image)
 			images[face]->drop();
 		image->grab();
 		images[face] = image;
+		changed();
 	}
 }
 
 // Build node models
 void Node::remesh(bool force)
+{
+	MeshBatch batch(state);
+	remesh(batch, force);
+	batch.build();
+}
+
+void Node::remesh(MeshBatch &batch, bool force)
 {
 	for (std::vector<NodeBox*>::iterator it = boxes.begin();
 			it != boxes.end();
 			++it) {
-		(*it)->buildMesh(state, position, device, images, force);
+		batch.add(*it, position, images, force);
 	}
 }
 
@@ -127,16 +146,76 @@ void Node::remesh(NodeBox *box)
 	box->buildMesh(state, position, device, images);
 }
 
+void Node::updateTextures(Media::Image *image, MeshBatch &batch)
+{
+	bool used = false;
+	for (int i = 0; i < 6; i++)
+		used |= (images[i] == image);
+	if (!used)
+		return;
+
+	f32 shades[6];
+	getFaceShades(state->settings->get("lighting"), shades);
+
+	for (std::vector<NodeBox*>::iterator it = boxes.begin();
+			it != boxes.end();
+			++it) {
+		if (!(*it)->updateTextures(device->getVideoDriver(), images, image, shades))
+			batch.add(*it, position, images);
+	}
+}
+
 void Node::hide()
 {
+	_hidden = true;
+
+	// Free the textures as well, they are rebuilt when the node is shown
 	for (std::vector<NodeBox*>::iterator it = boxes.begin();
 			it != boxes.end();
 			++it) {
 		NodeBox *box = *it;
-		if (box->model) {
-			box->model->remove();
-			box->model = NULL;
-		}
+		box->removeMesh(device->getVideoDriver());
+	}
+}
+
+void Node::changed()
+{
+	revision = newRevision();
+	if (project) {
+		ChangeEvent event(ECT_NODE, revision);
+		event.node = this;
+		project->changes.post(event);
+	}
+}
+
+void Node::boxChanged(NodeBox *box)
+{
+	if (project) {
+		ChangeEvent event(ECT_NODEBOX, box->getRevision());
+		event.node = this;
+		event.box = box;
+		project->changes.post(event);
+	}
+}
+
+Revision Node::getRevision() const
+{
+	Revision newest = revision;
+	for (std::vector<NodeBox*>::const_iterator it = boxes.begin();
+			it != boxes.end();
+			++it) {
+		if ((*it)->getRevision() > newest)
+			newest = (*it)->getRevision();
+	}
+	return newest;
+}
+
+void Node::getMemoryUsage(MemoryUsage &usage) const
+{
+	for (std::vector<NodeBox*>::const_iterator it = boxes.begin();
+			it != boxes.end();
+			++it) {
+		(*it)->getMemoryUsage(usage);
 	}
 }
 
@@ -159,3 +238,67 @@ void Node::flip(EAxis axis)
 	}
 	remesh();
 }
+
+void Node::combine(ECSGOperation op, int id)
+{
+	// Cutting with a flat box would do nothing but remove it
+	if (id >= 0) {
+		aabbox3df bounds(boxes[id]->one, boxes[id]->two);
+		bounds.repair();
+		if (bounds.getVolume() <= 0)
+			return;
+	}
+
+	std::vector<aabbox3df> a, b;
+	std::vector<NodeBox*> kept;
+	std::vector<std::string> names;
+	for (int i = 0; i < (int)boxes.size(); i++) {
+		NodeBox *box = boxes[i];
+		aabbox3df bounds(box->one, box->two);
+		bounds.repair();
+		if (i == id) {
+			b.push_back(bounds);
+		} else if (bounds.getVolume() > 0) {
+			a.push_back(bounds);
+			names.push_back(box->name);
+		} else {
+			kept.push_back(box);
+			continue;
+		}
+		box->removeMesh(state->device->getVideoDriver());
+		delete box;
+	}
+
+	std::vector<aabbox3df> result;
+	combineBoxes(op, a, b, result);
+
+	// The result doesn't match the old boxes one to one, so it takes
+	// their names in order, and any boxes left over get new ones.
+	boxes = kept;
+	for (size_t i = 0; i < result.size(); i++) {
+		NodeBox *box = addNodeBox(result[i].MinEdge, result[i].MaxEdge, false);
+		if (i < names.size())
+			box->name = names[i];
+	}
+	if (_selected >= (int)boxes.size())
+		_selected = (int)boxes.size() - 1;
+	changed();
+	remesh();
+}
+
+void Node::unite()
+{
+	combine(ECSG_UNION, -1);
+}
+
+void Node::subtract(int id)
+{
+	if (GetNodeBox(id))
+		combine(ECSG_SUBTRACT, id);
+}
+
+void Node::intersect(int id)
+{
+	if (GetNodeBox(id))
+		combine(ECSG_INTERSECT, id);
+}
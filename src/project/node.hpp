@@ -6,9 +6,13 @@
 #include "../EditorState.hpp"
 #include "nodebox.hpp"
 #include "media.hpp"
+#include "changes.hpp"
+#include "csg.hpp"
 
 class EditorState;
 class NodeBox;
+class MeshBatch;
+class Project;
 class Node
 {
 public:
@@ -22,7 +26,7 @@ public:
 	NodeBox* GetCurrentNodeBox();
 	NodeBox* GetNodeBox(int id);
 	NodeBox* addNodeBox(vector3df one = vector3df(-0.5, -0.5, -0.5),
-		vector3df two = vector3df(0.5, 0.5, 0.5));
+		vector3df two = vector3df(0.5, 0.5, 0.5), bool build_mesh = true);
 	void deleteNodebox(int id);
 	void cloneNodebox(int id);
 	void select(int id) { _selected = id; }
@@ -30,28 +34,64 @@ public:
 	// Node bulk updaters
 	void remesh(bool force = false); // creates the node mesh
 	void remesh(NodeBox *box);
+	void remesh(MeshBatch &batch, bool force = false);
 	void setAllTextures(Media::Image *def);
+
+	// Updates the textures of faces showing image after it was replaced.
+	// Boxes with meshes that are out of date anyway are added to batch.
+	void updateTextures(Media::Image *image, MeshBatch &batch);
 	void rotate(EAxis axis);
 	void flip(EAxis axis);
+	// Hidden nodes free their meshes and aren't rebuilt by remesh()
+	// until they are shown again
 	void hide();
+	void show() { _hidden = false; }
+	bool isHidden() const { return _hidden; }
+
+	// Replaces the boxes with boxes that don't overlap, as combineBoxes()
+	// gives. Boxes with no volume are left as they are.
+	void unite();
+	// Box id is used up, unless it has no volume, when nothing is done
+	void subtract(int id);  // Cuts box id out of the others
+	void intersect(int id); // Keeps what is inside box id
+
+	void getMemoryUsage(MemoryUsage &usage) const;
 
 	void setTexture(ECUBE_SIDE face, Media::Image *image);
 	Media::Image *getTexture(ECUBE_SIDE face) { return images[face]; }
+	EditorState *getState() const { return state; }
+
+	// Call after changing position, name or snap_res directly
+	void changed();
+	void boxChanged(NodeBox *box);
+
+	// The node's own properties, without its boxes
+	Revision getOwnRevision() const { return revision; }
+
+	// The node and all of its boxes
+	Revision getRevision() const;
 
 	vector3di position;
 	std::string name;
 	std::vector<NodeBox*> boxes;
 	int snap_res;
+
+	// The project the node is in, set by Project::AddNode()
+	Project *project;
 private:
+	void combine(ECSGOperation op, int id);
+
 	// Data
 	int _selected;
 	unsigned int _nid; // the node's id.
 	int _box_count;
+	bool _hidden;
 
 	// Irrlicht
 	IrrlichtDevice* device;
 	EditorState* state;
 	Media::Image *images[6];
+	Revision revision;
 };
 
 #endif
@@ -1,4 +1,5 @@
 #include "nodebox.hpp"
+#include "node.hpp"
 
 void NodeBox::moveFace(EditorState* editor, ECDR_DIR type,
 		vector3df position, bool both)
@@ -87,7 +88,7 @@ void NodeBox::moveFace(EditorState* editor, ECDR_DIR type,
 	}
 
 	if (before_one != one || before_two != two)
-		rebuild_needed = true;
+		changed();
 }
 
 void NodeBox::move(EditorState* editor, ECDR_DIR type, vector3df position,
@@ -170,33 +171,114 @@ void NodeBox::move(EditorState* editor, ECDR_DIR type, vector3df position,
 	two = new_two;
 
 	if (move_dist != vector3df(0, 0, 0))
-		rebuild_needed = true;
+		changed();
 }
 
-ITexture* darken(IVideoDriver* driver, IImage* image, f32 amt, const char *name)
+void getFaceShades(const std::string &lighting, f32 shades[6])
+{
+	for (int i = 0; i < 6; i++)
+		shades[i] = 1.f;
+
+	if (lighting == "1" || lighting == "2") {
+		shades[ECS_FRONT] = 0.5f;
+		shades[ECS_BACK] = 0.5f;
+		shades[ECS_LEFT] = 0.7f;
+		shades[ECS_RIGHT] = 0.7f;
+		shades[ECS_BOTTOM] = 0.4f;
+	}
+	if (lighting == "1")
+		shades[ECS_TOP] = 0.7f;
+}
+
+// Multiplies the colour channels of 32 bit pixels by amt, rounding
+static void shadePixels(u32 *pixels, u32 count, f32 amt)
+{
+	// Look the channels up, rather than converting every pixel
+	u8 table[256];
+	for (u32 i = 0; i < 256; i++)
+		table[i] = (u8)(u32)(amt * i + 0.5f);
+
+	for (u32 i = 0; i < count; i++) {
+		u32 c = pixels[i];
+		pixels[i] = (c & 0xff000000) |
+				((u32)table[(c >> 16) & 0xff] << 16) |
+				((u32)table[(c >> 8) & 0xff] << 8) |
+				(u32)table[c & 0xff];
+	}
+}
+
+IImage* shade(IVideoDriver* driver, IImage* image, f32 amt)
 {
 	if (image == NULL)
 		return NULL;
 
 	core::dimension2d<u32> dim = image->getDimension();
-	IImage* image2 = driver->createImage(image->getColorFormat(), dim);
-	image->copyTo(image2);
-
-	for(u32 y=0; y<dim.Height; y++) {
-		for(u32 x=0; x<dim.Width; x++) {
-			video::SColor c = image2->getPixel(x,y);
-			c.setRed((u32)(amt * c.getRed() + 0.5f));
-			c.setGreen((u32)(amt * c.getGreen() + 0.5f));
-			c.setBlue((u32)(amt * c.getBlue() + 0.5f));
-			image2->setPixel(x, y, c);
-		}
-	}
+	IImage* image2 = driver->createImage(ECF_A8R8G8B8, dim);
+	image->copyToScaling(image2->getData(), dim.Width, dim.Height, ECF_A8R8G8B8,
+			image2->getPitch());
+	if (amt != 1.f)
+		shadePixels((u32*)image2->getData(), image2->getImageDataSizeInPixels(), amt);
+	return image2;
+}
 
-	ITexture *retval = driver->addTexture(name, image2);
+ITexture* darken(IVideoDriver* driver, IImage* image, f32 amt, const char *name)
+{
+	IImage* image2 = shade(driver, image, amt);
+	if (image2 == NULL)
+		return NULL;
+
+	ITexture *retval = addPixelArtTexture(driver, name, image2);
 	image2->drop();
 	return retval;
 }
 
+ITexture* addPixelArtTexture(IVideoDriver* driver, const char *name, IImage* image)
+{
+	// ETCF_ALWAYS_32_BIT is the driver's default, and keeps it from
+	// converting 32 bit images to 16 bits
+	static const E_TEXTURE_CREATION_FLAG flags[3] = {
+		ETCF_CREATE_MIP_MAPS, ETCF_ALLOW_MEMORY_COPY, ETCF_ALWAYS_32_BIT
+	};
+	static const bool profile[3] = {false, false, true};
+
+	bool saved[3];
+	for (int i = 0; i < 3; i++) {
+		saved[i] = driver->getTextureCreationFlag(flags[i]);
+		driver->setTextureCreationFlag(flags[i], profile[i]);
+	}
+
+	ITexture *texture = driver->addTexture(name, image);
+
+	for (int i = 0; i < 3; i++)
+		driver->setTextureCreationFlag(flags[i], saved[i]);
+	return texture;
+}
+
+bool updatePixelArtTexture(ITexture* texture, IImage* image, f32 amt)
+{
+	if (!texture || !image)
+		return false;
+
+	core::dimension2d<u32> dim = image->getDimension();
+	if (texture->getSize() != dim || texture->getOriginalSize() != dim ||
+			texture->getColorFormat() != ECF_A8R8G8B8)
+		return false;
+
+	u8 *pixels = (u8*)texture->lock(ETLM_WRITE_ONLY);
+	if (!pixels)
+		return false;
+
+	u32 pitch = texture->getPitch();
+	image->copyToScaling(pixels, dim.Width, dim.Height, ECF_A8R8G8B8, pitch);
+	if (amt != 1.f) {
+		for (u32 y = 0; y < dim.Height; y++)
+			shadePixels((u32*)(pixels + y * pitch), dim.Width, amt);
+	}
+	texture->unlock();
+	texture->regenerateMipMapLevels();
+	return true;
+}
+
 void NodeBox::removeMesh(IVideoDriver *driver)
 {
 	if (model) {
@@ -208,38 +290,98 @@ void NodeBox::removeMesh(IVideoDriver *driver)
 	}
 }
 
+void NodeBox::changed()
+{
+	revision = newRevision();
+	if (parent)
+		parent->boxChanged(this);
+}
+
+void NodeBox::getMemoryUsage(MemoryUsage &usage) const
+{
+	if (!model)
+		return;
+
+	for (u32 i = 0; i < model->getMaterialCount(); i++)
+		usage.add(EMC_TEXTURE, getTextureMemory(model->getMaterial(i).getTexture(0)));
+	usage.add(EMC_MESH, getMeshMemory(model->getMesh()));
+}
+
+// The face of each mesh buffer, in the order they are created
+static const ECUBE_SIDE mesh_faces[6] = {
+	ECS_FRONT, ECS_BACK, ECS_LEFT, ECS_RIGHT, ECS_TOP, ECS_BOTTOM
+};
+
+NodeBox::MeshData::MeshData():
+	mesh(NULL)
+{
+	for (int i = 0; i < 6; i++) {
+		sources[i] = NULL;
+		images[i] = NULL;
+		shaded[i] = NULL;
+		shades[i] = 1.f;
+	}
+}
+
+NodeBox::MeshData::~MeshData()
+{
+	if (mesh)
+		mesh->drop();
+	for (int i = 0; i < 6; i++) {
+		if (shaded[i])
+			shaded[i]->drop();
+	}
+}
+
+unsigned int NodeBox::meshes_built = 0;
+
 void NodeBox::buildMesh(EditorState* editor, vector3di nd_position,
 		IrrlichtDevice* device, Media::Image* images[6], bool force)
 {
-	if (!rebuild_needed && !force)
+	MeshData data;
+	if (!beginMesh(data, editor, nd_position, device->getVideoDriver(), images, force))
 		return;
 
-	rebuild_needed = false;
+	prepareMesh(data, device->getVideoDriver());
+	finishMesh(data, device);
+}
+
+bool NodeBox::beginMesh(MeshData &data, EditorState* editor, vector3di nd_position,
+		IVideoDriver* driver, Media::Image* images[6], bool force)
+{
+	Revision inputs = revision;
+	if (parent && parent->getOwnRevision() > inputs)
+		inputs = parent->getOwnRevision();
+	for (int i = 0; i < 6; i++) {
+		if (images[i] && images[i]->getRevision() > inputs)
+			inputs = images[i]->getRevision();
+	}
+	if (model && inputs == mesh_revision && !force)
+		return false;
+	if (parent && parent->isHidden())
+		return false;
+
+	mesh_revision = inputs;
+	meshes_built++;
 
-	video::IVideoDriver* driver = device->getVideoDriver();
 	static Media::Image *def = new Media::Image("default", driver->createImageFromFile("media/texture_box.png"));
 
-	Media::Image *copied[6];
+	// Decode the images here, as Media isn't thread safe
 	for (int i = 0; i < 6; i++) {
-		copied[i] = images[i];
-		if (!copied[i])
-			copied[i] = def;
+		data.sources[i] = images[i];
+		if (!data.sources[i] || !data.sources[i]->get())
+			data.sources[i] = def;
+		data.images[i] = data.sources[i]->get();
 	}
-	ISceneManager* smgr = device->getSceneManager();
 
-	removeMesh(driver);
+	getFaceShades(editor->settings->get("lighting"), data.shades);
 
-	vector3df position = vector3df(
-			nd_position.X + one.X + ((two.X - one.X) / 2),
-			nd_position.Y + one.Y + ((two.Y - one.Y) / 2),
-			nd_position.Z + one.Z + ((two.Z - one.Z) / 2)
-		);
-	vector3df size = vector3df(
-			two.X - one.X,
-			two.Y - one.Y,
-			two.Z - one.Z
-		);
+	data.nd_position = nd_position;
+	return true;
+}
 
+void NodeBox::prepareMesh(MeshData &data, IVideoDriver* driver) const
+{
 	// init variables
 	f32 cubeSize = 1.f;
 	video::SColor cubeColour(255, 255, 255, 255);
@@ -273,8 +415,6 @@ void NodeBox::buildMesh(EditorState* editor, vector3di nd_position,
 #define x0 -0.5f
 #define x1 0.5f
 
-	std::string lighting = editor->settings->get("lighting");
-
 	// Front face
 	vector2df topl((one.X + 0.5f), (-two.Y + 0.5f));
 	vector2df btmr((two.X + 0.5f), (-one.Y + 0.5f));
@@ -284,14 +424,6 @@ void NodeBox::buildMesh(EditorState* editor, vector3di nd_position,
 	buffer->Vertices[2] = video::S3DVertex(x1,x1,x0, 1, 1,-1, cubeColour, btmr.X, topl.Y);
 	buffer->Vertices[3] = video::S3DVertex(x0,x1,x0, -1, 1,-1, cubeColour, topl.X, topl.Y);
 	buffer->BoundingBox.reset(0,0,0);
-	ITexture *texture = NULL;
-	if (lighting == "1" || lighting == "2")
-		texture = darken(driver, copied[ECS_FRONT]->get(), 0.5f, copied[ECS_RIGHT]->name.c_str());
-	else
-		texture = driver->addTexture(copied[ECS_FRONT]->name.c_str(), copied[ECS_FRONT]->get());
-	SMaterial mat = SMaterial();
-	mat.setTexture(0, texture);
-	buffer->Material = mat;
 	cubeMesh->addMeshBuffer(buffer);
 	buffer->drop();
 
@@ -305,14 +437,6 @@ void NodeBox::buildMesh(EditorState* editor, vector3di nd_position,
 	buffer2->Vertices[2] = video::S3DVertex(x0,x1,x1, -1, 1, 1, cubeColour, btmr.X, topl.Y);
 	buffer2->Vertices[3] = video::S3DVertex(x1,x1,x1, 1, 1, 1, cubeColour, topl.X, topl.Y);
 	buffer2->BoundingBox.reset(0,0,0);
-	texture = NULL;
-	if (lighting == "1" || lighting == "2")
-		texture = darken(driver, copied[ECS_BACK]->get(), 0.5f, copied[ECS_BACK]->name.c_str());
-	else
-		texture = driver->addTexture(copied[ECS_BACK]->name.c_str(), copied[ECS_BACK]->get());
-	mat = SMaterial();
-	mat.setTexture(0, texture);
-	buffer2->Material = mat;
 	cubeMesh->addMeshBuffer(buffer2);
 	buffer2->drop();
 
@@ -326,14 +450,6 @@ void NodeBox::buildMesh(EditorState* editor, vector3di nd_position,
 	buffer3->Vertices[2] = video::S3DVertex(x0,x1,x0, -1, 1,-1, cubeColour, btmr.X, topl.Y);
 	buffer3->Vertices[3] = video::S3DVertex(x0,x1,x1, -1, 1, 1, cubeColour, topl.X, topl.Y);
 	buffer3->BoundingBox.reset(0,0,0);
-	texture = NULL;
-	if (lighting == "1" || lighting == "2")
-		texture = darken(driver, copied[ECS_LEFT]->get(), 0.7f, copied[ECS_LEFT]->name.c_str());
-	else
-		texture = driver->addTexture(copied[ECS_LEFT]->name.c_str(), copied[ECS_LEFT]->get());
-	mat = SMaterial();
-	mat.setTexture(0, texture);
-	buffer3->Material = mat;
 	cubeMesh->addMeshBuffer(buffer3);
 	buffer3->drop();
 
@@ -347,14 +463,6 @@ void NodeBox::buildMesh(EditorState* editor, vector3di nd_position,
 	buffer4->Vertices[2] = video::S3DVertex(x1,x1,x1,  1, 1, 1, cubeColour, btmr.X, topl.Y);
 	buffer4->Vertices[3] = video::S3DVertex(x1,x1,x0,  1, 1,-1, cubeColour, topl.X, topl.Y);
 	buffer4->BoundingBox.reset(0,0,0);
-	texture = NULL;
-	if (lighting == "1" || lighting == "2")
-		texture = darken(driver, copied[ECS_RIGHT]->get(), 0.7f, copied[ECS_RIGHT]->name.c_str());
-	else
-		texture = driver->addTexture(copied[ECS_RIGHT]->name.c_str(), copied[ECS_RIGHT]->get());
-	mat = SMaterial();
-	mat.setTexture(0, texture);
-	buffer4->Material = mat;
 	cubeMesh->addMeshBuffer(buffer4);
 	buffer4->drop();
 
@@ -368,14 +476,6 @@ void NodeBox::buildMesh(EditorState* editor, vector3di nd_position,
 	buffer5->Vertices[2] = video::S3DVertex(x1,x1,x1,  1, 1, 1, cubeColour, btmr.X, topl.Y);
 	buffer5->Vertices[3] = video::S3DVertex(x0,x1,x1, -1, 1, 1, cubeColour, topl.X, topl.Y);
 	buffer5->BoundingBox.reset(0,0,0);
-	texture = NULL;
-	if (lighting == "1")
-		texture = darken(driver, copied[ECS_TOP]->get(), 0.7f, copied[ECS_TOP]->name.c_str());
-	else
-		texture = driver->addTexture(copied[ECS_TOP]->name.c_str(), copied[ECS_TOP]->get());
-	mat = SMaterial();
-	mat.setTexture(0, texture);
-	buffer5->Material = mat;
 	cubeMesh->addMeshBuffer(buffer5);
 	buffer5->drop();
 
@@ -389,26 +489,96 @@ void NodeBox::buildMesh(EditorState* editor, vector3di nd_position,
 	buffer6->Vertices[2] = video::S3DVertex(x1,x0,x0,  1,-1,-1, cubeColour, btmr.X, topl.Y);
 	buffer6->Vertices[3] = video::S3DVertex(x0,x0,x0, -1,-1,-1, cubeColour, topl.X, topl.Y);
 	buffer6->BoundingBox.reset(0,0,0);
-	if (lighting == "1" || lighting == "2")
-		texture = darken(driver, copied[ECS_BOTTOM]->get(), 0.4f, copied[ECS_BOTTOM]->name.c_str());
-	else
-		texture = driver->addTexture(copied[ECS_BOTTOM]->name.c_str(), copied[ECS_BOTTOM]->get());
-	mat = SMaterial();
-	mat.setTexture(0, texture);
-	buffer6->Material = mat;
 	cubeMesh->addMeshBuffer(buffer6);
 	buffer6->drop();
 
+	// Shade the textures, and convert any that aren't 32 bit here, so
+	// that the driver can upload them as they are
+	for (int i = 0; i < 6; i++) {
+		if (data.shades[i] != 1.f || data.images[i]->getColorFormat() != ECF_A8R8G8B8)
+			data.shaded[i] = shade(driver, data.images[i], data.shades[i]);
+	}
+
+	if (data.mesh)
+		data.mesh->drop();
+	data.mesh = cubeMesh;
+}
+
+void NodeBox::finishMesh(MeshData &data, IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+
+	removeMesh(driver);
+
+	vector3df position = vector3df(
+			data.nd_position.X + one.X + ((two.X - one.X) / 2),
+			data.nd_position.Y + one.Y + ((two.Y - one.Y) / 2),
+			data.nd_position.Z + one.Z + ((two.Z - one.Z) / 2)
+		);
+	vector3df size = vector3df(
+			two.X - one.X,
+			two.Y - one.Y,
+			two.Z - one.Z
+		);
+
+	// Upload the textures
+	for (u32 i = 0; i < 6; i++) {
+		ECUBE_SIDE face = mesh_faces[i];
+		IImage *image = data.shaded[face] ? data.shaded[face] : data.images[face];
+		ITexture *texture = addPixelArtTexture(driver, data.sources[face]->name.c_str(), image);
+		SMaterial mat = SMaterial();
+		mat.setTexture(0, texture);
+		data.mesh->getMeshBuffer(i)->getMaterial() = mat;
+	}
 
 	// Create scene node from mesh
-	model = smgr->addMeshSceneNode(cubeMesh);
-	cubeMesh->drop();
+	model = smgr->addMeshSceneNode(data.mesh);
 	model->setPosition(position);
 	model->setScale(size);
 	model->setMaterialFlag(EMF_BILINEAR_FILTER, false);
 	model->setMaterialFlag(EMF_LIGHTING, false);
 }
 
+bool NodeBox::updateTextures(IVideoDriver* driver, Media::Image* images[6],
+		Media::Image* image, const f32 shades[6])
+{
+	if (!model)
+		return true;
+
+	// The revisions beginMesh() would find, but for the image
+	Revision inputs = revision;
+	if (parent && parent->getOwnRevision() > inputs)
+		inputs = parent->getOwnRevision();
+	for (int i = 0; i < 6; i++) {
+		if (images[i] && images[i] != image && images[i]->getRevision() > inputs)
+			inputs = images[i]->getRevision();
+	}
+	if (inputs > mesh_revision || !image->get())
+		return false;
+
+	for (u32 i = 0; i < model->getMaterialCount() && i < 6; i++) {
+		ECUBE_SIDE face = mesh_faces[i];
+		if (images[face] != image)
+			continue;
+
+		// Copied into the texture in place if it is still the same size
+		ITexture *old = model->getMaterial(i).getTexture(0);
+		if (updatePixelArtTexture(old, image->get(), shades[face]))
+			continue;
+
+		ITexture *texture = darken(driver, image->get(), shades[face], image->name.c_str());
+		model->getMaterial(i).setTexture(0, texture);
+		model->getMesh()->getMeshBuffer(i)->getMaterial().setTexture(0, texture);
+		if (old)
+			driver->removeTexture(old);
+	}
+
+	if (image->getRevision() > mesh_revision)
+		mesh_revision = image->getRevision();
+	return true;
+}
+
 void NodeBox::rotate(EAxis axis)
 {
 	switch (axis) {
@@ -456,7 +626,7 @@ void NodeBox::rotate(EAxis axis)
 		one.Z = two.Z;
 		two.Z = tmp;
 	}
-	rebuild_needed = true;
+	changed();
 }
 
 void NodeBox::flip(EAxis axis)
@@ -500,5 +670,5 @@ void NodeBox::flip(EAxis axis)
 		one.Z = two.Z;
 		two.Z = tmp;
 	}
-	rebuild_needed = true;
+	changed();
 }
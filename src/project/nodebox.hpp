@@ -5,25 +5,39 @@
 #include "../common.hpp"
 #include "../EditorState.hpp"
 #include "media.hpp"
+#include "changes.hpp"
 
 class EditorState;
+class Node;
 class NodeBox
 {
 public:
 	NodeBox() {};
 
 	NodeBox(const std::string & name, const vector3df & one, const vector3df & two) :
-		name(name), one(one), two(two), model(NULL), rebuild_needed(true)
+		name(name), one(one), two(two), model(NULL), parent(NULL),
+		revision(newRevision()), mesh_revision(0)
 	{}
 
 	void removeMesh(IVideoDriver *driver);
+	void getMemoryUsage(MemoryUsage &usage) const;
+
+	// Call after changing one, two or name directly.
+	// The transformations below call it themselves.
+	void changed();
+	Revision getRevision() const { return revision; }
+
+	// How many meshes beginMesh() has started, for profiling
+	static unsigned int getMeshesBuilt() { return meshes_built; }
 
 	irr::core::vector3df one;
 	irr::core::vector3df two;
-	bool rebuild_needed;
 	std::string name;
 	irr::scene::IMeshSceneNode* model;
 
+	// The node the box belongs to, set by Node::addNodeBox()
+	Node *parent;
+
 	irr::core::vector3df GetCenter()
 	{
 		return vector3df(
@@ -52,9 +66,67 @@ public:
 
 	// Create the mesh for the nodebox, store is in this->model.
 	//
-	// Only runs if rebuild_needed is true.
+	// Only runs if there is no mesh, or if the box, its node or one of
+	// the images has changed since the mesh was made.
 	void buildMesh(EditorState* editor, vector3di nd_position,
 			IrrlichtDevice* device, Media::Image* images[6], bool force = false);
+
+	// buildMesh() in three stages, so that the geometry and shaded images
+	// can be made on other threads.
+	class MeshData
+	{
+	public:
+		MeshData();
+		~MeshData();
+
+		Media::Image *sources[6];
+		IImage *images[6];
+		IImage *shaded[6];
+		f32 shades[6];
+		vector3di nd_position;
+		SMesh *mesh;
+	};
+
+	// Main thread. Returns false if no rebuild is needed.
+	bool beginMesh(MeshData &data, EditorState* editor, vector3di nd_position,
+			IVideoDriver* driver, Media::Image* images[6], bool force = false);
+
+	// Any thread. Doesn't touch the box or the driver state.
+	void prepareMesh(MeshData &data, IVideoDriver* driver) const;
+
+	// Main thread. Creates the textures and the scene node.
+	void finishMesh(MeshData &data, IrrlichtDevice* device);
+
+	// Uploads the textures of the faces showing image again, after it has
+	// been replaced, leaving the geometry as it is. Returns false if the
+	// mesh is out of date for some other reason, and needs rebuilding.
+	bool updateTextures(IVideoDriver* driver, Media::Image* images[6],
+			Media::Image* image, const f32 shades[6]);
+private:
+	Revision revision;
+
+	// The newest revision of the mesh's inputs when it was made
+	Revision mesh_revision;
+
+	static unsigned int meshes_built;
 };
 
+// The brightness of each face under the lighting setting
+void getFaceShades(const std::string &lighting, f32 shades[6]);
+
+// Create a 32 bit image with the colour channels multiplied by amt.
+IImage* shade(IVideoDriver* driver, IImage* image, f32 amt);
+
+// Create a texture from image, with the colour channels multiplied by amt.
+ITexture* darken(IVideoDriver* driver, IImage* image, f32 amt, const char *name);
+
+// Create a texture for small images drawn without filtering: no mipmaps,
+// no copy kept in memory, and 32 bit images uploaded without converting.
+ITexture* addPixelArtTexture(IVideoDriver* driver, const char *name, IImage* image);
+
+// Copy image into texture, with the colour channels multiplied by amt,
+// updating the texture in place. Returns false if the texture is a
+// different size or format, and has to be made again.
+bool updatePixelArtTexture(ITexture* texture, IImage* image, f32 amt);
+
 #endif
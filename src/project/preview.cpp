@@ -0,0 +1,281 @@
+#include "preview.hpp"
+#include <math.h>
+#include <string.h>
+#include "node.hpp"
+#include "nodebox.hpp"
+
+// Pictures are drawn in tiles of this many pixels square
+#define PREVIEW_TILE 64
+
+// The view, in node coordinates. Screen x goes right, screen y up, and
+// depth towards the viewer, who looks from above the front right corner.
+static const vector3df view_right(0.70710678f, 0.f, 0.70710678f);
+static const vector3df view_up(-0.40824829f, 0.81649658f, 0.40824829f);
+static const vector3df view_depth(0.57735027f, 0.57735027f, -0.57735027f);
+
+// A full node is 2 * 0.8165 tall on the screen
+#define PREVIEW_NODE_HEIGHT 1.63299316f
+
+PreviewRenderer::PreviewRenderer(EditorState *state):
+	state(state)
+{
+	getFaceShades(state->settings->get("lighting"), shades);
+}
+
+PreviewRenderer::~PreviewRenderer()
+{
+	for (std::map<std::pair<Media::Image*, int>, Texture*>::const_iterator it = textures.begin();
+			it != textures.end();
+			++it)
+		delete it->second;
+
+	for (std::vector<Job*>::const_iterator it = jobs.begin();
+			it != jobs.end();
+			++it) {
+		if ((*it)->image)
+			(*it)->image->drop();
+		delete *it;
+	}
+}
+
+const PreviewRenderer::Texture *PreviewRenderer::getTexture(Media::Image *image, ECUBE_SIDE face)
+{
+	IVideoDriver *driver = state->device->getVideoDriver();
+	static Media::Image *def = new Media::Image("default", driver->createImageFromFile("media/texture_box.png"));
+	if (!image || !image->get())
+		image = def;
+
+	std::pair<Media::Image*, int> key(image, face);
+	std::map<std::pair<Media::Image*, int>, Texture*>::const_iterator it = textures.find(key);
+	if (it != textures.end())
+		return it->second;
+
+	Texture *texture = new Texture();
+	textures[key] = texture;
+
+	IImage *data = image->get();
+	if (!data) {
+		texture->width = 1;
+		texture->height = 1;
+		texture->pixels.push_back(0);
+		return texture;
+	}
+
+	// Same rounding as shade()
+	u8 table[256];
+	for (u32 i = 0; i < 256; i++)
+		table[i] = (u8)(u32)(shades[face] * i + 0.5f);
+
+	dimension2du dim = data->getDimension();
+	texture->width = dim.Width;
+	texture->height = dim.Height;
+	texture->pixels.resize(dim.Width * dim.Height);
+	for (u32 y = 0; y < dim.Height; y++) {
+		for (u32 x = 0; x < dim.Width; x++) {
+			u32 c = data->getPixel(x, y).color;
+			texture->pixels[y * dim.Width + x] = (c & 0xff000000) |
+					((u32)table[(c >> 16) & 0xff] << 16) |
+					((u32)table[(c >> 8) & 0xff] << 8) |
+					(u32)table[c & 0xff];
+		}
+	}
+	return texture;
+}
+
+// Where a point in the node is drawn, in pixels
+static vector2df project(const vector3df &point, f32 scale, f32 centre)
+{
+	return vector2df(centre + scale * point.dotProduct(view_right),
+			centre - scale * point.dotProduct(view_up));
+}
+
+void PreviewRenderer::add(Node *node, u32 size)
+{
+	Job *job = new Job();
+	job->size = size;
+	job->image = NULL;
+	jobs.push_back(job);
+
+	f32 scale = size / PREVIEW_NODE_HEIGHT;
+	f32 centre = size / 2.f;
+
+	// Only these faces can be seen from the view
+	static const ECUBE_SIDE sides[3] = {ECS_TOP, ECS_FRONT, ECS_RIGHT};
+	const Texture *side_textures[3];
+	for (int i = 0; i < 3; i++)
+		side_textures[i] = getTexture(node->getTexture(sides[i]), sides[i]);
+
+	for (std::vector<NodeBox*>::const_iterator it = node->boxes.begin();
+			it != node->boxes.end();
+			++it) {
+		vector3df one = (*it)->one;
+		vector3df two = (*it)->two;
+		vector3df low(std::min(one.X, two.X), std::min(one.Y, two.Y), std::min(one.Z, two.Z));
+		vector3df high(std::max(one.X, two.X), std::max(one.Y, two.Y), std::max(one.Z, two.Z));
+		vector3df size3 = high - low;
+
+		for (int i = 0; i < 3; i++) {
+			// A corner and the face's edges, with the texture coordinates
+			// at the corner and along each edge, as made by prepareMesh()
+			vector3df corner, edge_a, edge_b;
+			vector2df uv, uv_a, uv_b;
+			switch (sides[i]) {
+			case ECS_TOP:
+				corner = vector3df(low.X, high.Y, low.Z);
+				edge_a = vector3df(size3.X, 0, 0);
+				edge_b = vector3df(0, 0, size3.Z);
+				uv = vector2df(corner.X + 0.5f, 0.5f - corner.Z);
+				uv_a = vector2df(size3.X, 0);
+				uv_b = vector2df(0, -size3.Z);
+				break;
+			case ECS_FRONT:
+				corner = low;
+				edge_a = vector3df(size3.X, 0, 0);
+				edge_b = vector3df(0, size3.Y, 0);
+				uv = vector2df(corner.X + 0.5f, 0.5f - corner.Y);
+				uv_a = vector2df(size3.X, 0);
+				uv_b = vector2df(0, -size3.Y);
+				break;
+			default: // ECS_RIGHT
+				corner = vector3df(high.X, low.Y, low.Z);
+				edge_a = vector3df(0, 0, size3.Z);
+				edge_b = vector3df(0, size3.Y, 0);
+				uv = vector2df(corner.Z + 0.5f, 0.5f - corner.Y);
+				uv_a = vector2df(size3.Z, 0);
+				uv_b = vector2df(0, -size3.Y);
+				break;
+			}
+
+			vector2df origin = project(corner, scale, centre);
+			vector2df a = project(corner + edge_a, scale, centre) - origin;
+			vector2df b = project(corner + edge_b, scale, centre) - origin;
+			f32 det = a.X * b.Y - b.X * a.Y;
+			if (fabs(det) < 1e-6f)
+				continue;
+
+			const Texture *texture = side_textures[i];
+			Face face;
+			face.x = origin.X;
+			face.y = origin.Y;
+			face.a_dx = b.Y / det;
+			face.a_dy = -b.X / det;
+			face.b_dx = -a.Y / det;
+			face.b_dy = a.X / det;
+			face.depth = corner.dotProduct(view_depth);
+			face.depth_a = edge_a.dotProduct(view_depth);
+			face.depth_b = edge_b.dotProduct(view_depth);
+			face.u = uv.X * texture->width;
+			face.u_a = uv_a.X * texture->width;
+			face.u_b = uv_b.X * texture->width;
+			face.v = uv.Y * texture->height;
+			face.v_a = uv_a.Y * texture->height;
+			face.v_b = uv_b.Y * texture->height;
+			face.pixels = &texture->pixels[0];
+			face.width = texture->width;
+			face.height = texture->height;
+
+			vector2df corners[3] = {origin + a, origin + b, origin + a + b};
+			f32 min_x = origin.X, max_x = origin.X, min_y = origin.Y, max_y = origin.Y;
+			for (int j = 0; j < 3; j++) {
+				min_x = std::min(min_x, corners[j].X);
+				max_x = std::max(max_x, corners[j].X);
+				min_y = std::min(min_y, corners[j].Y);
+				max_y = std::max(max_y, corners[j].Y);
+			}
+			face.left = std::max(0, (s32)floorf(min_x));
+			face.top = std::max(0, (s32)floorf(min_y));
+			face.right = std::min((s32)size, (s32)ceilf(max_x));
+			face.bottom = std::min((s32)size, (s32)ceilf(max_y));
+			if (face.left < face.right && face.top < face.bottom)
+				job->faces.push_back(face);
+		}
+	}
+}
+
+void PreviewRenderer::TileTask::run()
+{
+	u32 *pixels = (u32*)job->image->getData();
+	f32 *depths = &job->depth[0];
+	s32 size = job->size;
+
+	for (std::vector<Face>::const_iterator it = job->faces.begin();
+			it != job->faces.end();
+			++it) {
+		const Face &face = *it;
+		s32 x0 = std::max(left, face.left);
+		s32 x1 = std::min(right, face.right);
+		s32 y0 = std::max(top, face.top);
+		s32 y1 = std::min(bottom, face.bottom);
+
+		for (s32 y = y0; y < y1; y++) {
+			// At the centre of the first pixel
+			f32 dx = x0 + 0.5f - face.x;
+			f32 dy = y + 0.5f - face.y;
+			f32 a = face.a_dx * dx + face.a_dy * dy;
+			f32 b = face.b_dx * dx + face.b_dy * dy;
+			u32 *row = &pixels[y * size];
+			f32 *depth_row = &depths[y * size];
+			for (s32 x = x0; x < x1; x++, a += face.a_dx, b += face.b_dx) {
+				if (a < 0.f || a >= 1.f || b < 0.f || b >= 1.f)
+					continue;
+
+				f32 depth = face.depth + a * face.depth_a + b * face.depth_b;
+				if (depth <= depth_row[x])
+					continue;
+
+				s32 tx = (s32)floorf(face.u + a * face.u_a + b * face.u_b) % (s32)face.width;
+				s32 ty = (s32)floorf(face.v + a * face.v_a + b * face.v_b) % (s32)face.height;
+				if (tx < 0)
+					tx += face.width;
+				if (ty < 0)
+					ty += face.height;
+				u32 texel = face.pixels[ty * face.width + tx];
+				if ((texel >> 24) < 128)
+					continue;
+
+				row[x] = texel | 0xff000000;
+				depth_row[x] = depth;
+			}
+		}
+	}
+}
+
+void PreviewRenderer::render(std::vector<IImage*> &images)
+{
+	IVideoDriver *driver = state->device->getVideoDriver();
+	std::vector<TileTask*> tasks;
+	for (std::vector<Job*>::const_iterator it = jobs.begin();
+			it != jobs.end();
+			++it) {
+		Job *job = *it;
+		job->image = driver->createImage(ECF_A8R8G8B8, dimension2du(job->size, job->size));
+		memset(job->image->getData(), 0, job->size * job->size * 4);
+		job->depth.assign(job->size * job->size, -1e30f);
+		for (u32 y = 0; y < job->size; y += PREVIEW_TILE) {
+			for (u32 x = 0; x < job->size; x += PREVIEW_TILE) {
+				tasks.push_back(new TileTask(job, x, y,
+						std::min(x + PREVIEW_TILE, job->size),
+						std::min(y + PREVIEW_TILE, job->size)));
+			}
+		}
+	}
+
+	for (std::vector<TileTask*>::const_iterator it = tasks.begin();
+			it != tasks.end();
+			++it)
+		state->threads->add(*it);
+	state->threads->wait();
+
+	for (std::vector<TileTask*>::const_iterator it = tasks.begin();
+			it != tasks.end();
+			++it)
+		delete *it;
+
+	for (std::vector<Job*>::const_iterator it = jobs.begin();
+			it != jobs.end();
+			++it) {
+		images.push_back((*it)->image);
+		delete *it;
+	}
+	jobs.clear();
+}
@@ -0,0 +1,87 @@
+#ifndef PREVIEW_HPP_INCLUDED
+#define PREVIEW_HPP_INCLUDED
+
+#include <map>
+#include <vector>
+#include "../common.hpp"
+#include "../util/ThreadPool.hpp"
+#include "media.hpp"
+
+class EditorState;
+class Node;
+
+// Draws isometric pictures of nodes on the CPU, such as inventory images,
+// so that they can be made without a video driver that draws. The view is
+// the one Minetest uses for inventory cubes: the top, with the front on
+// the left and the right side on the right. A full node fills the
+// picture's height, so nodes drawn at the same size are to the same scale.
+//
+// Faces are shaded as the editor's meshes are, textures are sampled
+// without filtering, and texels with an alpha below half aren't drawn.
+// Pictures are split into tiles, which are drawn on the thread pool.
+class PreviewRenderer
+{
+public:
+	PreviewRenderer(EditorState *state);
+	~PreviewRenderer();
+
+	// Main thread. Takes what it needs from the node, so the node can be
+	// changed or deleted before render().
+	void add(Node *node, u32 size);
+
+	// Draws every node added since the last call, in the order they were
+	// added. The images are A8R8G8B8, and are dropped by the caller.
+	void render(std::vector<IImage*> &images);
+private:
+	// A face of a box, as it appears on the screen. a and b go from 0 to
+	// 1 along the face's two edges.
+	class Face
+	{
+	public:
+		f32 x, y;                 // Where a and b are 0, in pixels
+		f32 a_dx, a_dy, b_dx, b_dy; // Change in a and b per pixel
+		f32 depth, depth_a, depth_b;
+		f32 u, u_a, u_b, v, v_a, v_b; // Texture position, in texels
+		s32 left, top, right, bottom; // Pixels that may be covered
+		const u32 *pixels;        // A8R8G8B8, shaded
+		u32 width, height;
+	};
+
+	class Texture
+	{
+	public:
+		u32 width, height;
+		std::vector<u32> pixels;
+	};
+
+	class Job
+	{
+	public:
+		u32 size;
+		std::vector<Face> faces;
+		IImage *image;
+		std::vector<f32> depth;
+	};
+
+	class TileTask : public ThreadPool::Task
+	{
+	public:
+		TileTask(Job *job, s32 left, s32 top, s32 right, s32 bottom):
+			job(job), left(left), top(top), right(right), bottom(bottom)
+		{}
+		void run();
+	private:
+		Job *job;
+		s32 left, top, right, bottom;
+	};
+
+	// Main thread. Converted and shaded once per image and face.
+	const Texture *getTexture(Media::Image *image, ECUBE_SIDE face);
+
+	EditorState *state;
+	f32 shades[6];
+	std::map<std::pair<Media::Image*, int>, Texture*> textures;
+	std::vector<Job*> jobs;
+};
+
+#endif
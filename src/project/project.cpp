@@ -1,16 +1,25 @@
 #include "project.hpp"
 #include "node.hpp"
+#include "meshbatch.hpp"
 #include "../util/string.hpp"
+#include "../FileFormat/NBEJournal.hpp"
+#include "../FileFormat/Lua.hpp"
 
 Project::Project() :
 	name("test"),
+	journal(NULL),
+	lua_cache(NULL),
 	snode(-1),
-	_node_count(0)
+	_node_count(0),
+	revision(newRevision())
 {
+	media.changes = &changes;
 }
 
 Project::~Project()
 {
+	delete journal;
+	delete lua_cache;
 	for (std::list<Node*>::const_iterator it = nodes.begin();
 			it != nodes.end();
 			++it) {
@@ -41,6 +50,7 @@ void Project::hideAllButCurrentNode()
 			it != nodes.end();
 			++it, ++curid) {
 		if (snode == curid) {
+			(*it)->show();
 			(*it)->remesh();
 		} else {
 			(*it)->hide();
@@ -48,6 +58,15 @@ void Project::hideAllButCurrentNode()
 	}
 }
 
+void Project::showAllNodes()
+{
+	for (std::list<Node*>::const_iterator it = nodes.begin();
+			it != nodes.end();
+			++it)
+		(*it)->show();
+	remesh();
+}
+
 Node* Project::GetNode(vector3di pos) const
 {
 	for (std::list<Node*>::const_iterator it = nodes.begin();
@@ -62,13 +81,35 @@ Node* Project::GetNode(vector3di pos) const
 
 void Project::remesh()
 {
+	if (nodes.empty())
+		return;
+
+	// Build all nodes together, so the work is spread over the threads
+	MeshBatch batch(nodes.front()->getState());
 	for (std::list<Node*>::const_iterator it = nodes.begin();
 			it != nodes.end();
 			++it) {
 		if (*it) {
-			(*it)->remesh();
+			(*it)->remesh(batch);
 		}
 	}
+	batch.build();
+}
+
+void Project::updateTextures(Media::Image *image)
+{
+	if (nodes.empty())
+		return;
+
+	MeshBatch batch(nodes.front()->getState());
+	for (std::list<Node*>::const_iterator it = nodes.begin();
+			it != nodes.end();
+			++it) {
+		if (*it) {
+			(*it)->updateTextures(image, batch);
+		}
+	}
+	batch.build();
 }
 
 void Project::AddNode(EditorState* state, bool select, bool add_initial_box)
@@ -79,7 +120,7 @@ void Project::AddNode(EditorState* state, bool select, bool add_initial_box)
 	AddNode(node, select);
 }
 
-void Project::AddNode(Node* node, bool select)
+void Project::AddNode(Node* node, bool select, bool build_mesh)
 {
 	_node_count++;
 	if (node->name == "") {
@@ -87,11 +128,18 @@ void Project::AddNode(Node* node, bool select)
 	}
 	if (node->position == vector3di(0, 0, 0))
 		node->position = vector3di((_node_count - 1), 0, 0);
-	node->remesh();
+	node->project = this;
+	if (build_mesh)
+		node->remesh();
 	nodes.push_back(node);
 	if (select) {
 		snode = _node_count - 1;
 	}
+
+	revision = newRevision();
+	ChangeEvent event(ECT_NODE_ADD, revision);
+	event.node = node;
+	changes.post(event);
 }
 
 void Project::DeleteNode(int id)
@@ -105,6 +153,11 @@ void Project::DeleteNode(int id)
 			it != nodes.end();
 			++it, ++curid) {
 		if (*it && curid == id){
+			revision = newRevision();
+			ChangeEvent event(ECT_NODE_DELETE, revision);
+			event.node = *it;
+			changes.post(event);
+
 			delete *it;
 			it = nodes.erase(it);
 			return;
@@ -120,3 +173,40 @@ Node* Project::GetCurrentNode() const
 		return NULL;
 	}
 }
+
+Revision Project::getRevision() const
+{
+	Revision newest = revision;
+	if (media.getRevision() > newest)
+		newest = media.getRevision();
+	for (std::list<Node*>::const_iterator it = nodes.begin();
+			it != nodes.end();
+			++it) {
+		if (*it && (*it)->getRevision() > newest)
+			newest = (*it)->getRevision();
+	}
+	return newest;
+}
+
+MemoryUsage Project::getMemoryUsage() const
+{
+	MemoryUsage usage;
+	media.getMemoryUsage(usage);
+	for (std::list<Node*>::const_iterator it = nodes.begin();
+			it != nodes.end();
+			++it) {
+		if (*it)
+			(*it)->getMemoryUsage(usage);
+	}
+	return usage;
+}
+
+void Project::enforceMemoryBudget(IrrlichtDevice *device, size_t budget)
+{
+	if (budget == 0)
+		return;
+
+	size_t used = getMemoryUsage().total();
+	if (used > budget)
+		media.evictUnused(device, used - budget);
+}
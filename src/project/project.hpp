@@ -6,10 +6,14 @@
 #include "../common.hpp"
 #include "../EditorState.hpp"
 #include "media.hpp"
+#include "memory.hpp"
 #include "node.hpp"
+#include "changes.hpp"
 
 class Node;
 class EditorState;
+class NBEJournal;
+class LuaCache;
 
 class Project
 {
@@ -21,26 +25,50 @@ public:
 	std::string name;
 	std::string file;
 
+	// What was last saved to a journaled .nbe file, or NULL
+	NBEJournal *journal;
+
+	// What was last exported to Lua, or NULL
+	LuaCache *lua_cache;
+
+	// Changes to the project, its nodes, their boxes and the media
+	ChangeBus changes;
+
+	// The newest revision of the project, its nodes and the media
+	Revision getRevision() const;
+
 	// Media
 	Media media;
 
 	// Nodes
 	void AddNode(EditorState* state, bool select = true, bool add_initial_box = true);
-	void AddNode(Node* node, bool select = true);
+	void AddNode(Node* node, bool select = true, bool build_mesh = true);
 	void DeleteNode(int id);
 	void SelectNode(int id) { snode = id; }
 	void hideAllButCurrentNode();
-	void remesh();
+	void showAllNodes();
+	void remesh(); // Hidden nodes stay hidden
+
+	// Shows the new contents of an image that was replaced, uploading
+	// only the textures made from it where the meshes are up to date
+	void updateTextures(Media::Image *image);
 	Node* GetNode(int id) const;
 	Node* GetNode(vector3di pos) const;
 	Node* GetCurrentNode() const;
 	int GetSelectedNodeId() const { return snode; }
 	unsigned int GetNodeCount() const { return _node_count; }
 
+	// Memory management
+	MemoryUsage getMemoryUsage() const;
+
+	// Evicts unused images when over budget (in bytes, 0 for no limit)
+	void enforceMemoryBudget(IrrlichtDevice *device, size_t budget);
+
 	std::list<Node*> nodes;
 private:
 	int snode;
 	unsigned int _node_count;
+	Revision revision;
 };
 
 #endif
@@ -0,0 +1,139 @@
+#include "texturewatcher.hpp"
+#include <fstream>
+#include "../EditorState.hpp"
+#include "../util/Log.hpp"
+#include "project.hpp"
+
+void TextureWatcher::ReadTask::run()
+{
+	std::ifstream file(path.c_str(), std::ios::binary|std::ios::ate);
+	if (file) {
+		bytes.resize((size_t)file.tellg());
+		file.seekg(0, std::ios::beg);
+		if (!bytes.empty())
+			file.read(&bytes[0], bytes.size());
+		if (file && !bytes.empty()) {
+			io::IReadFile *memory = device->getFileSystem()->createMemoryReadFile(
+					&bytes[0], bytes.size(), path.c_str(), false);
+			image = device->getVideoDriver()->createImageFromFile(memory);
+			memory->drop();
+		}
+	}
+	done = true;
+}
+
+TextureWatcher::TextureWatcher(EditorState *state):
+	state(state),
+	project(NULL),
+	media_revision(0)
+{}
+
+TextureWatcher::~TextureWatcher()
+{
+	if (!tasks.empty())
+		state->threads->wait();
+	for (std::vector<ReadTask*>::const_iterator it = tasks.begin();
+			it != tasks.end();
+			++it)
+		delete *it;
+}
+
+void TextureWatcher::sync()
+{
+	if (state->project == project && (!project ||
+			project->media.getRevision() == media_revision))
+		return;
+
+	project = state->project;
+	std::set<std::string> paths;
+	if (project) {
+		media_revision = project->media.getRevision();
+		const std::vector<Media::Image*> &images = project->media.getList();
+		for (std::vector<Media::Image*>::const_iterator it = images.begin();
+				it != images.end();
+				++it) {
+			if ((*it)->origpath != "")
+				paths.insert((*it)->origpath);
+		}
+	}
+
+	// Reloading changes the revision, but not the files
+	if (paths != watcher.getFiles())
+		watcher.setFiles(paths);
+}
+
+void TextureWatcher::read(const std::string &path)
+{
+	for (std::vector<ReadTask*>::const_iterator it = tasks.begin();
+			it != tasks.end();
+			++it) {
+		if ((*it)->path == path) {
+			again.insert(path);
+			return;
+		}
+	}
+
+	ReadTask *task = new ReadTask(path, state->device);
+	tasks.push_back(task);
+
+	// Nothing would run it until something waits for the pool
+	if (state->threads->getThreadCount() == 0)
+		task->run();
+	else
+		state->threads->add(task);
+}
+
+void TextureWatcher::reload(ReadTask *task)
+{
+	if (!project)
+		return;
+
+	if (!task->image) {
+		NBE_LOG(ELV_WARNING, ELC_MEDIA, "Unable to reload " << task->path);
+		return;
+	}
+
+	// The same file may have been imported under several names
+	const std::vector<Media::Image*> &images = project->media.getList();
+	for (std::vector<Media::Image*>::const_iterator it = images.begin();
+			it != images.end();
+			++it) {
+		Media::Image *image = *it;
+		if (image->origpath != task->path)
+			continue;
+
+		task->image->grab();
+		project->media.reload(image, task->bytes, task->image, state->device);
+		project->updateTextures(image);
+		NBE_LOG(ELV_INFO, ELC_MEDIA, "Reloaded '" << image->name << "' from " << task->path);
+	}
+}
+
+void TextureWatcher::update()
+{
+	sync();
+
+	std::vector<std::string> changed;
+	watcher.poll(state->device->getTimer()->getRealTime(), changed);
+	for (std::vector<std::string>::const_iterator it = changed.begin();
+			it != changed.end();
+			++it)
+		read(*it);
+
+	for (size_t i = 0; i < tasks.size();) {
+		ReadTask *task = tasks[i];
+		if (!task->done) {
+			i++;
+			continue;
+		}
+
+		tasks.erase(tasks.begin() + i);
+		sync();
+		reload(task);
+		std::string path = task->path;
+		delete task;
+
+		if (again.erase(path) > 0)
+			read(path);
+	}
+}
@@ -0,0 +1,66 @@
+#ifndef TEXTUREWATCHER_HPP_INCLUDED
+#define TEXTUREWATCHER_HPP_INCLUDED
+
+#include <atomic>
+#include <set>
+#include <string>
+#include <vector>
+#include "../common.hpp"
+#include "../util/FileWatcher.hpp"
+#include "../util/ThreadPool.hpp"
+#include "changes.hpp"
+
+class EditorState;
+class Project;
+
+// Reloads imported images when the files they came from are saved.
+// The files are read and decoded on the thread pool, then only the
+// textures made from each image are uploaded again.
+class TextureWatcher
+{
+public:
+	TextureWatcher(EditorState *state);
+	~TextureWatcher();
+
+	// Main thread. Call every frame.
+	void update();
+private:
+	class ReadTask : public ThreadPool::Task
+	{
+	public:
+		ReadTask(const std::string &path, IrrlichtDevice *device):
+			path(path),
+			device(device),
+			image(NULL),
+			done(false)
+		{}
+
+		~ReadTask() { if (image) image->drop(); }
+
+		virtual void run();
+
+		std::string path;
+		IrrlichtDevice *device;
+		std::vector<char> bytes;
+		IImage *image; // NULL if the file couldn't be read or decoded
+		std::atomic<bool> done;
+	};
+
+	void sync();
+	void read(const std::string &path);
+	void reload(ReadTask *task);
+
+	EditorState *state;
+	FileWatcher watcher;
+
+	// What the watched files were found from
+	Project *project;
+	Revision media_revision;
+
+	std::vector<ReadTask*> tasks;
+
+	// Files that changed again while being read
+	std::set<std::string> again;
+};
+
+#endif
@@ -0,0 +1,184 @@
+#include "FileWatcher.hpp"
+#include "filesys.hpp"
+#include "Log.hpp"
+
+#ifdef __linux__
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+// Writes, and files moved or saved into place
+#define WATCH_EVENTS (IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_MOVED_TO)
+
+FileWatcher::FileWatcher(unsigned int debounce):
+	debounce(debounce)
+{
+	fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd < 0)
+		NBE_LOG(ELV_WARNING, ELC_FILES, "Unable to watch files: " << strerror(errno));
+}
+
+FileWatcher::~FileWatcher()
+{
+	if (fd >= 0)
+		close(fd);
+}
+
+void FileWatcher::setFiles(const std::set<std::string> &paths)
+{
+	for (std::map<int, std::string>::const_iterator it = dirs.begin();
+			it != dirs.end();
+			++it)
+		inotify_rm_watch(fd, it->first);
+	dirs.clear();
+	dir_files.clear();
+
+	files = paths;
+	forgetUnwatched();
+
+	if (fd < 0)
+		return;
+
+	for (std::set<std::string>::const_iterator it = files.begin();
+			it != files.end();
+			++it) {
+		std::string dir = pathWithoutFilename(*it);
+		if (dir == "")
+			dir = ".";
+
+		if (dir_files.count(dir) == 0) {
+			int wd = inotify_add_watch(fd, dir.c_str(), WATCH_EVENTS);
+			if (wd < 0) {
+				NBE_LOG(ELV_VERBOSE, ELC_FILES, "Unable to watch " << dir << ": "
+						<< strerror(errno));
+				continue;
+			}
+			dirs[wd] = dir;
+		}
+		dir_files[dir][filenameWithExt(*it)] = *it;
+	}
+}
+
+void FileWatcher::poll(unsigned int now, std::vector<std::string> &out)
+{
+	if (fd >= 0) {
+		char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+		ssize_t length;
+		while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+			for (char *ptr = buffer; ptr < buffer + length;) {
+				const struct inotify_event *event = (const struct inotify_event *)ptr;
+				ptr += sizeof(struct inotify_event) + event->len;
+
+				// Events were lost, so anything could have changed
+				if (event->mask & IN_Q_OVERFLOW) {
+					for (std::set<std::string>::const_iterator it = files.begin();
+							it != files.end();
+							++it)
+						changed(*it, now);
+					continue;
+				}
+
+				std::map<int, std::string>::const_iterator dir = dirs.find(event->wd);
+				if (dir == dirs.end() || event->len == 0)
+					continue;
+
+				const std::map<std::string, std::string> &names = dir_files[dir->second];
+				std::map<std::string, std::string>::const_iterator file = names.find(event->name);
+				if (file != names.end())
+					changed(file->second, now);
+			}
+		}
+	}
+
+	settled(now, out);
+}
+
+#else
+#include <sys/stat.h>
+
+// How often modification times are compared, in milliseconds
+#define SCAN_INTERVAL 500
+
+FileWatcher::FileWatcher(unsigned int debounce):
+	debounce(debounce),
+	last_scan(0)
+{}
+
+FileWatcher::~FileWatcher()
+{}
+
+FileWatcher::Stamp FileWatcher::getStamp(const std::string &path)
+{
+	Stamp stamp;
+	struct stat info;
+	if (stat(path.c_str(), &info) == 0) {
+		stamp.mtime = (long long)info.st_mtime;
+		stamp.size = (long long)info.st_size;
+	}
+	return stamp;
+}
+
+void FileWatcher::setFiles(const std::set<std::string> &paths)
+{
+	std::map<std::string, Stamp> old;
+	old.swap(stamps);
+
+	files = paths;
+	for (std::set<std::string>::const_iterator it = files.begin();
+			it != files.end();
+			++it) {
+		std::map<std::string, Stamp>::const_iterator found = old.find(*it);
+		stamps[*it] = (found != old.end()) ? found->second : getStamp(*it);
+	}
+	forgetUnwatched();
+}
+
+void FileWatcher::poll(unsigned int now, std::vector<std::string> &out)
+{
+	if (now - last_scan >= SCAN_INTERVAL) {
+		last_scan = now;
+		for (std::map<std::string, Stamp>::iterator it = stamps.begin();
+				it != stamps.end();
+				++it) {
+			Stamp stamp = getStamp(it->first);
+			if (stamp != it->second) {
+				it->second = stamp;
+				changed(it->first, now);
+			}
+		}
+	}
+
+	settled(now, out);
+}
+
+#endif
+
+void FileWatcher::changed(const std::string &path, unsigned int now)
+{
+	pending[path] = now;
+}
+
+void FileWatcher::forgetUnwatched()
+{
+	for (std::map<std::string, unsigned int>::iterator it = pending.begin();
+			it != pending.end();) {
+		if (files.count(it->first) == 0)
+			pending.erase(it++);
+		else
+			++it;
+	}
+}
+
+void FileWatcher::settled(unsigned int now, std::vector<std::string> &out)
+{
+	for (std::map<std::string, unsigned int>::iterator it = pending.begin();
+			it != pending.end();) {
+		if (now - it->second >= debounce) {
+			out.push_back(it->first);
+			pending.erase(it++);
+		} else {
+			++it;
+		}
+	}
+}
@@ -0,0 +1,67 @@
+#ifndef FILEWATCHER_HPP_INCLUDED
+#define FILEWATCHER_HPP_INCLUDED
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Notices when files are written or replaced. Uses inotify on Linux, and
+// compares modification times every so often elsewhere.
+//
+// A file is only reported once it has stopped changing for the debounce
+// time, so that a program saving it in several writes is seen once, and
+// the file isn't read half written.
+class FileWatcher
+{
+public:
+	FileWatcher(unsigned int debounce = 150);
+	~FileWatcher();
+
+	// Replaces the files watched. They don't need to exist yet.
+	void setFiles(const std::set<std::string> &paths);
+	const std::set<std::string> &getFiles() const { return files; }
+
+	// Adds the files that have changed and settled to out, as given to
+	// setFiles(). `now` is a time in milliseconds, which only has to
+	// count up.
+	void poll(unsigned int now, std::vector<std::string> &out);
+private:
+	void changed(const std::string &path, unsigned int now);
+	void forgetUnwatched();
+	void settled(unsigned int now, std::vector<std::string> &out);
+
+	unsigned int debounce;
+	std::set<std::string> files;
+
+	// When each file that has changed last changed
+	std::map<std::string, unsigned int> pending;
+
+#ifdef __linux__
+	int fd;
+
+	// Watched directory by watch descriptor, and the files in each by name
+	std::map<int, std::string> dirs;
+	std::map<std::string, std::map<std::string, std::string> > dir_files;
+#else
+	class Stamp
+	{
+	public:
+		Stamp(): mtime(0), size(0) {}
+		bool operator!=(const Stamp &other) const
+		{
+			return mtime != other.mtime || size != other.size;
+		}
+
+		long long mtime;
+		long long size;
+	};
+
+	static Stamp getStamp(const std::string &path);
+
+	std::map<std::string, Stamp> stamps;
+	unsigned int last_scan;
+#endif
+};
+
+#endif
@@ -0,0 +1,187 @@
+#include "Log.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+// Slots in the ring buffer, a power of two
+#define LOG_SLOTS 256
+
+// Longer messages are cut short
+#define LOG_TEXT 500
+
+// How often the thread looks for new messages, in milliseconds. Writers
+// don't wake it, so that logging never makes a system call.
+#define LOG_INTERVAL 20
+
+std::atomic<int> Log::levels[ELC_COUNT] = {
+	{ELV_INFO}, {ELV_INFO}, {ELV_INFO}, {ELV_INFO}
+};
+
+// A slot is free for the writer at position p when its sequence is p, and
+// holds a message for the reader when it is p + 1.
+struct LogSlot
+{
+	std::atomic<unsigned int> sequence;
+	unsigned short size;
+	char text[LOG_TEXT];
+};
+
+static LogSlot slots[LOG_SLOTS];
+static std::atomic<unsigned int> head(0);
+static unsigned int tail = 0; // Only used by the thread
+static std::atomic<unsigned int> dropped(0);
+static std::atomic<bool> running(false);
+
+// Never destroyed, so that exiting without stop() doesn't abort
+static std::thread *thread = NULL;
+static std::mutex stop_mutex;
+static std::condition_variable stop_wake;
+
+static void writeOut(const char *text, size_t size)
+{
+	fwrite(text, 1, size, stderr);
+	fflush(stderr);
+}
+
+// Takes every waiting message, and writes them all at once
+static void drain()
+{
+	std::string out;
+	for (;;) {
+		LogSlot &slot = slots[tail & (LOG_SLOTS - 1)];
+		if (slot.sequence.load(std::memory_order_acquire) != tail + 1)
+			break;
+		out.append(slot.text, slot.size);
+		out += '\n';
+		slot.sequence.store(tail + LOG_SLOTS, std::memory_order_release);
+		tail++;
+	}
+
+	static unsigned int reported = 0;
+	unsigned int lost = dropped.load(std::memory_order_relaxed);
+	if (lost != reported) {
+		char note[64];
+		snprintf(note, sizeof(note), "(%u log messages dropped)\n", lost - reported);
+		out += note;
+		reported = lost;
+	}
+
+	if (!out.empty())
+		writeOut(out.c_str(), out.size());
+}
+
+static void run()
+{
+	while (running) {
+		drain();
+		std::unique_lock<std::mutex> lock(stop_mutex);
+		if (running)
+			stop_wake.wait_for(lock, std::chrono::milliseconds(LOG_INTERVAL));
+	}
+	drain();
+}
+
+void Log::setLevel(ELogLevel level)
+{
+	for (int i = 0; i < ELC_COUNT; i++)
+		levels[i] = level;
+}
+
+void Log::setLevel(ELogCategory category, ELogLevel level)
+{
+	levels[category] = level;
+}
+
+bool Log::levelFromString(const std::string &name, ELogLevel &level)
+{
+	static const char *names[] = {"verbose", "info", "warning", "error", "none"};
+	for (int i = 0; i <= ELV_NONE; i++) {
+		if (name == names[i]) {
+			level = (ELogLevel)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Log::categoryFromString(const std::string &name, ELogCategory &category)
+{
+	static const char *names[] = {"general", "files", "media", "irrlicht"};
+	for (int i = 0; i < ELC_COUNT; i++) {
+		if (name == names[i]) {
+			category = (ELogCategory)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+void Log::write(ELogLevel level, ELogCategory category, const std::string &message)
+{
+	if (!isEnabled(level, category))
+		return;
+
+	size_t size = message.size() < LOG_TEXT ? message.size() : LOG_TEXT;
+	if (!running.load(std::memory_order_acquire)) {
+		std::string line = message.substr(0, size) + "\n";
+		writeOut(line.c_str(), line.size());
+		return;
+	}
+
+	// Claim a slot, as in Dmitry Vyukov's bounded queue
+	unsigned int pos = head.load(std::memory_order_relaxed);
+	LogSlot *slot;
+	for (;;) {
+		slot = &slots[pos & (LOG_SLOTS - 1)];
+		int diff = (int)(slot->sequence.load(std::memory_order_acquire) - pos);
+		if (diff == 0) {
+			if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		} else if (diff < 0) {
+			dropped++;
+			return;
+		} else {
+			pos = head.load(std::memory_order_relaxed);
+		}
+	}
+
+	memcpy(slot->text, message.data(), size);
+	slot->size = size;
+	slot->sequence.store(pos + 1, std::memory_order_release);
+}
+
+void Log::start()
+{
+	if (running)
+		return;
+
+	for (unsigned int i = 0; i < LOG_SLOTS; i++)
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+	head = 0;
+	tail = 0;
+	running = true;
+	thread = new std::thread(run);
+}
+
+void Log::stop()
+{
+	if (!running)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(stop_mutex);
+		running = false;
+	}
+	stop_wake.notify_one();
+	thread->join();
+	delete thread;
+	thread = NULL;
+}
+
+unsigned int Log::getDropped()
+{
+	return dropped;
+}
@@ -0,0 +1,75 @@
+#ifndef LOG_HPP_INCLUDED
+#define LOG_HPP_INCLUDED
+
+#include <atomic>
+#include <sstream>
+#include <string>
+
+enum ELogLevel
+{
+	ELV_VERBOSE = 0, // Every file, image and temporary directory
+	ELV_INFO,
+	ELV_WARNING,
+	ELV_ERROR,
+	ELV_NONE         // Only used to turn logging off
+};
+
+enum ELogCategory
+{
+	ELC_GENERAL = 0,
+	ELC_FILES,       // Reading and writing projects and files
+	ELC_MEDIA,       // Images
+	ELC_IRRLICHT,    // Irrlicht's own log
+	ELC_COUNT
+};
+
+// Messages are put in a ring buffer, without taking a lock, and written
+// to stderr by a thread of their own, so that logging never waits for the
+// terminal. If the buffer is full, messages are dropped and counted.
+//
+// Until start() is called, and after stop(), messages are written
+// straight away on the calling thread.
+class Log
+{
+public:
+	static bool isEnabled(ELogLevel level, ELogCategory category)
+	{
+		return (int)level >= levels[category].load(std::memory_order_relaxed);
+	}
+
+	// Sets the lowest level that is written, for every category or for one
+	static void setLevel(ELogLevel level);
+	static void setLevel(ELogCategory category, ELogLevel level);
+
+	// "verbose", "info", "warning", "error" or "none". Returns false for
+	// anything else.
+	static bool levelFromString(const std::string &name, ELogLevel &level);
+
+	// "general", "files", "media" or "irrlicht"
+	static bool categoryFromString(const std::string &name, ELogCategory &category);
+
+	// Thread safe. Use NBE_LOG, so that the message is only formatted
+	// when it is going to be written.
+	static void write(ELogLevel level, ELogCategory category, const std::string &message);
+
+	// Starts and stops the thread that writes messages. stop() writes
+	// everything still in the buffer first.
+	static void start();
+	static void stop();
+
+	// Messages lost because the buffer was full
+	static unsigned int getDropped();
+private:
+	static std::atomic<int> levels[ELC_COUNT];
+};
+
+#define NBE_LOG(level, category, message) \
+	do { \
+		if (Log::isEnabled(level, category)) { \
+			std::ostringstream log_stream; \
+			log_stream << message; \
+			Log::write(level, category, log_stream.str()); \
+		} \
+	} while (0)
+
+#endif
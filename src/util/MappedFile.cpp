@@ -0,0 +1,40 @@
+#include "MappedFile.hpp"
+#include <fstream>
+
+MappedFile::MappedFile():
+	mapped(NULL)
+{}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const std::string &path)
+{
+	close();
+	mapped = irr::io::createMappedReadFile(path.c_str());
+	if (mapped)
+		return true;
+
+	std::ifstream file(path.c_str(), std::ios::binary|std::ios::ate);
+	if (!file)
+		return false;
+	buffer.resize((size_t)file.tellg());
+	file.seekg(0, std::ios::beg);
+	if (!buffer.empty())
+		file.read(&buffer[0], buffer.size());
+	if (!file) {
+		buffer.clear();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (mapped)
+		mapped->drop();
+	mapped = NULL;
+	buffer.clear();
+}
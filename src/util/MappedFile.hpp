@@ -0,0 +1,42 @@
+#ifndef MAPPEDFILE_HPP_INCLUDED
+#define MAPPEDFILE_HPP_INCLUDED
+
+#include <string>
+#include <vector>
+#include <IMemoryReadFile.h>
+
+// A whole file to read in place. It is mapped into memory with Irrbloss's
+// createMappedReadFile() where it can be, so reading it costs no copies,
+// and read into a buffer otherwise.
+//
+// A mapped file that another program truncates faults when it is read, so
+// only use this for files the editor owns, such as .nbe files and their
+// project.txt, and only keep one open while reading it. Textures the user
+// may be editing are read through a buffer instead.
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	// Returns false if the file couldn't be opened or read
+	bool open(const std::string &path);
+	void close();
+
+	const char *data() const {
+		if (mapped)
+			return (const char *)mapped->getBuffer();
+		return buffer.empty() ? NULL : &buffer[0];
+	}
+	size_t size() const { return mapped ? (size_t)mapped->getSize() : buffer.size(); }
+private:
+	MappedFile(const MappedFile &);
+	MappedFile &operator=(const MappedFile &);
+
+	irr::io::IMemoryReadFile *mapped;
+
+	// Empty files, and files that can't be mapped
+	std::vector<char> buffer;
+};
+
+#endif
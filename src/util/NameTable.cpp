@@ -0,0 +1,69 @@
+#include "NameTable.hpp"
+
+// FNV-1a
+unsigned int NameTable::hash(const char *str, size_t size)
+{
+	unsigned int h = 2166136261u;
+	for (size_t i = 0; i < size; i++) {
+		h ^= (unsigned char)str[i];
+		h *= 16777619u;
+	}
+	return h;
+}
+
+size_t NameTable::findSlot(const char *str, size_t size, unsigned int h) const
+{
+	// The table size is a power of two, and never more than half full
+	size_t mask = slots.size() - 1;
+	for (size_t i = h & mask; ; i = (i + 1) & mask) {
+		NameId id = slots[i];
+		if (id == NAME_NONE)
+			return i;
+		if (hashes[id] == h && names[id].size() == size &&
+				memcmp(names[id].data(), str, size) == 0)
+			return i;
+	}
+}
+
+void NameTable::grow()
+{
+	slots.assign(slots.empty() ? 16 : slots.size() * 2, NAME_NONE);
+	size_t mask = slots.size() - 1;
+	for (NameId id = 0; id < names.size(); id++) {
+		size_t i = hashes[id] & mask;
+		while (slots[i] != NAME_NONE)
+			i = (i + 1) & mask;
+		slots[i] = id;
+	}
+}
+
+NameId NameTable::add(const char *str, size_t size)
+{
+	if ((names.size() + 1) * 2 > slots.size())
+		grow();
+
+	unsigned int h = hash(str, size);
+	size_t slot = findSlot(str, size, h);
+	if (slots[slot] != NAME_NONE)
+		return slots[slot];
+
+	NameId id = names.size();
+	names.push_back(std::string(str, size));
+	hashes.push_back(h);
+	slots[slot] = id;
+	return id;
+}
+
+NameId NameTable::find(const char *str, size_t size) const
+{
+	if (slots.empty())
+		return NAME_NONE;
+	return slots[findSlot(str, size, hash(str, size))];
+}
+
+void NameTable::clear()
+{
+	names.clear();
+	hashes.clear();
+	slots.clear();
+}
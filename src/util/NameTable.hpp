@@ -0,0 +1,44 @@
+#ifndef NAMETABLE_HPP_INCLUDED
+#define NAMETABLE_HPP_INCLUDED
+
+#include <string>
+#include <vector>
+#include <string.h>
+
+typedef unsigned int NameId;
+#define NAME_NONE 0xFFFFFFFF
+
+// Gives each distinct string a small id, counting up from 0 in the order
+// they are added, so that the ids can index a vector.
+//
+// The strings are found through an open addressing hash table, and find()
+// takes a pointer and a length, so looking up a name in the middle of a
+// buffer needs no std::string and never adds anything.
+class NameTable
+{
+public:
+	// Returns the id of the string, adding it if it isn't there yet
+	NameId add(const char *str, size_t size);
+	NameId add(const std::string &str) { return add(str.data(), str.size()); }
+
+	// Returns the id of the string, or NAME_NONE
+	NameId find(const char *str, size_t size) const;
+	NameId find(const char *str) const { return find(str, strlen(str)); }
+	NameId find(const std::string &str) const { return find(str.data(), str.size()); }
+
+	const std::string &get(NameId id) const { return names[id]; }
+	size_t size() const { return names.size(); }
+	void clear();
+private:
+	static unsigned int hash(const char *str, size_t size);
+
+	// The slot holding the string, or the empty slot where it would go
+	size_t findSlot(const char *str, size_t size, unsigned int h) const;
+	void grow();
+
+	std::vector<std::string> names;
+	std::vector<unsigned int> hashes; // Of each name, by id
+	std::vector<NameId> slots;        // NAME_NONE when empty
+};
+
+#endif
@@ -0,0 +1,192 @@
+#include "Process.hpp"
+#include "Log.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+
+Process::Process():
+	handle(NULL),
+	exit_code(0)
+{}
+
+Process::~Process()
+{
+	if (handle)
+		CloseHandle(handle);
+}
+
+// Quotes an argument as CommandLineToArgvW expects
+static void appendArgument(std::string &cmd, const std::string &arg)
+{
+	if (!cmd.empty())
+		cmd += ' ';
+	if (!arg.empty() && arg.find_first_of(" \t\"") == std::string::npos) {
+		cmd += arg;
+		return;
+	}
+
+	cmd += '"';
+	size_t backslashes = 0;
+	for (size_t i = 0; i < arg.size(); i++) {
+		if (arg[i] == '\\') {
+			backslashes++;
+		} else if (arg[i] == '"') {
+			cmd.append(backslashes * 2 + 1, '\\');
+			cmd += '"';
+			backslashes = 0;
+			continue;
+		} else {
+			backslashes = 0;
+		}
+		cmd += arg[i];
+	}
+	cmd.append(backslashes, '\\');
+	cmd += '"';
+}
+
+bool Process::start(const std::string &exe, const std::vector<std::string> &args,
+		const std::string &dir)
+{
+	if (isRunning())
+		return false;
+
+	std::string cmd;
+	appendArgument(cmd, exe);
+	for (std::vector<std::string>::const_iterator it = args.begin();
+			it != args.end();
+			++it)
+		appendArgument(cmd, *it);
+
+	STARTUPINFOA startup;
+	ZeroMemory(&startup, sizeof(startup));
+	startup.cb = sizeof(startup);
+	PROCESS_INFORMATION info;
+	std::vector<char> cmd_line(cmd.begin(), cmd.end());
+	cmd_line.push_back('\0');
+	if (!CreateProcessA(exe.c_str(), &cmd_line[0], NULL, NULL, FALSE, 0, NULL,
+			dir.c_str(), &startup, &info)) {
+		NBE_LOG(ELV_ERROR, ELC_GENERAL, "Unable to run " << exe << " (error " << GetLastError() << ")");
+		return false;
+	}
+	CloseHandle(info.hThread);
+	if (handle)
+		CloseHandle(handle);
+	handle = info.hProcess;
+	exit_code = 0;
+	return true;
+}
+
+bool Process::isRunning()
+{
+	if (!handle)
+		return false;
+	if (WaitForSingleObject(handle, 0) == WAIT_TIMEOUT)
+		return true;
+
+	DWORD code;
+	exit_code = GetExitCodeProcess(handle, &code) ? (int)code : -1;
+	CloseHandle(handle);
+	handle = NULL;
+	return false;
+}
+
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+Process::Process():
+	pid(0),
+	exit_code(0)
+{}
+
+Process::~Process()
+{}
+
+bool Process::start(const std::string &exe, const std::vector<std::string> &args,
+		const std::string &dir)
+{
+	if (isRunning())
+		return false;
+
+	// Everything the child needs is made before forking, as the other
+	// threads' locks may be held when it starts. That includes the full
+	// path, as the child changes directory before running exe.
+	std::string path = exe;
+	char cwd[PATH_MAX];
+	if (path != "" && path[0] != '/' && getcwd(cwd, sizeof(cwd)))
+		path = std::string(cwd) + "/" + path;
+
+	std::vector<char*> argv;
+	argv.push_back(const_cast<char*>(exe.c_str()));
+	for (std::vector<std::string>::const_iterator it = args.begin();
+			it != args.end();
+			++it)
+		argv.push_back(const_cast<char*>(it->c_str()));
+	argv.push_back(NULL);
+
+	// Closed by a successful exec, otherwise the child writes errno to it
+	int status_pipe[2];
+	if (pipe(status_pipe) != 0) {
+		NBE_LOG(ELV_ERROR, ELC_GENERAL, "Unable to run " << exe << ": " << strerror(errno));
+		return false;
+	}
+	fcntl(status_pipe[1], F_SETFD, FD_CLOEXEC);
+
+	pid_t child = fork();
+	if (child == 0) {
+		close(status_pipe[0]);
+		if (dir == "" || chdir(dir.c_str()) == 0)
+			execv(path.c_str(), &argv[0]);
+		int error = errno;
+		ssize_t unused = write(status_pipe[1], &error, sizeof(error));
+		(void)unused;
+		_exit(127);
+	}
+	close(status_pipe[1]);
+	if (child < 0) {
+		NBE_LOG(ELV_ERROR, ELC_GENERAL, "Unable to run " << exe << ": " << strerror(errno));
+		close(status_pipe[0]);
+		return false;
+	}
+
+	int error = 0;
+	ssize_t got;
+	do {
+		got = read(status_pipe[0], &error, sizeof(error));
+	} while (got < 0 && errno == EINTR);
+	close(status_pipe[0]);
+	if (got == sizeof(error)) {
+		NBE_LOG(ELV_ERROR, ELC_GENERAL, "Unable to run " << exe << " in " << dir
+				<< ": " << strerror(error));
+		waitpid(child, NULL, 0);
+		return false;
+	}
+
+	pid = child;
+	exit_code = 0;
+	return true;
+}
+
+bool Process::isRunning()
+{
+	if (pid <= 0)
+		return false;
+
+	int status;
+	pid_t res = waitpid(pid, &status, WNOHANG);
+	if (res == 0)
+		return true;
+
+	if (res == pid && WIFEXITED(status))
+		exit_code = WEXITSTATUS(status);
+	else
+		exit_code = -1;
+	pid = 0;
+	return false;
+}
+
+#endif
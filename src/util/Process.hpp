@@ -0,0 +1,37 @@
+#ifndef PROCESS_HPP_INCLUDED
+#define PROCESS_HPP_INCLUDED
+
+#include <string>
+#include <vector>
+
+// A child process, started without waiting for it to finish. It has its
+// own working directory, so the editor's is left alone.
+class Process
+{
+public:
+	Process();
+
+	// Doesn't stop the process, which carries on after the editor exits
+	~Process();
+
+	// Starts exe with args in the directory dir. A relative exe is found
+	// from the editor's working directory, not dir. Returns false if the
+	// program couldn't be run, or if one is still running.
+	bool start(const std::string &exe, const std::vector<std::string> &args,
+			const std::string &dir);
+
+	// Checks whether the process is still running, without waiting
+	bool isRunning();
+
+	// Once it has exited. -1 if it was killed.
+	int getExitCode() const { return exit_code; }
+private:
+#ifdef _WIN32
+	void *handle;
+#else
+	int pid;
+#endif
+	int exit_code;
+};
+
+#endif
@@ -1,43 +1,53 @@
 #include "SimpleFileCombiner.hpp"
 #include <iostream>
+#include <string.h>
+#include "Log.hpp"
+#include "MappedFile.hpp"
 #include <fstream>
 #include <sstream>
 
+// Read through a buffer rather than mapped, as the file may be one that
+// another program rewrites, which would fault a mapping it truncated
 std::vector<char> ReadAllBytes(char const* filename)
 {
 	std::ifstream ifs(filename, std::ios::binary|std::ios::ate);
 
 	if (!ifs) {
-		std::cerr << "Error! Unable to open file '" << filename << "' in SimpleFileCombiner/ReadAllBytes" << std::endl;
+		NBE_LOG(ELV_ERROR, ELC_FILES, "Error! Unable to open file '" << filename << "' in SimpleFileCombiner/ReadAllBytes");
 		return std::vector<char>(0);
 	}
 
-	std::ifstream::pos_type pos = ifs.tellg();
-
-	std::vector<char> result(pos);
-
+	std::vector<char> result((size_t)ifs.tellg());
 	ifs.seekg(0, std::ios::beg);
-	ifs.read(&result[0], pos);
-
+	if (!result.empty())
+		ifs.read(&result[0], result.size());
+	result.resize((size_t)ifs.gcount());
 	return result;
 }
 
 bool SimpleFileCombiner::write(std::string filename) {
+	// The number of files is stored in one byte
+	if (files.size() > 255) {
+		NBE_LOG(ELV_ERROR, ELC_FILES, "Error! Unable to write more than 255 files in SimpleFileCombiner");
+		errcode = EERR_IO;
+		return false;
+	}
+
 	std::ofstream output(filename.c_str(), std::ios::binary|std::ios::out);
 	if (!output) {
 		errcode = EERR_IO;
 		return false;
 	}
 	output.write("NBEFP", 5);
-	output << (char)files.size();
+	output << (unsigned char)files.size();
 	unsigned int start = files.size() * sizeofdef + 6;
 	for (std::list<SimpleFileCombiner::File>::const_iterator it = files.begin();
 			it != files.end();
 			++it) {
-		SimpleFileCombiner::File file = *it;
+		const SimpleFileCombiner::File &file = *it;
 		std::string name = file.name;
 		unsigned int size = file.bytes.size();
-		std::cerr << "(SFC) Writing " << name.c_str() << ": " << start << " (" << size << ")" << std::endl;
+		NBE_LOG(ELV_VERBOSE, ELC_FILES, "(SFC) Writing " << name << ": " << start << " (" << size << ")");
 		while (name.size() < 50) {
 			name += " ";
 		}
@@ -50,66 +60,90 @@ bool SimpleFileCombiner::write(std::string filename) {
 	for (std::list<SimpleFileCombiner::File>::const_iterator it = files.begin();
 			it != files.end();
 			++it) {
-		SimpleFileCombiner::File file = *it;
-		output.write(&file.bytes[0], file.bytes.size());
+		const SimpleFileCombiner::File &file = *it;
+		if (!file.bytes.empty())
+			output.write(&file.bytes[0], file.bytes.size());
 	}
 	output.close();
 	return true;
 }
 bool SimpleFileCombiner::add(const char* readfrom, std::string file)
 {
-	files.push_back(File(file, ReadAllBytes(readfrom)));
+	files.push_back(File(file, std::vector<char>()));
+	files.back().bytes = ReadAllBytes(readfrom);
+	return true;
+}
+size_t SimpleFileCombiner::getSize() const
+{
+	size_t size = files.size() * sizeofdef + 6;
+	for (std::list<SimpleFileCombiner::File>::const_iterator it = files.begin();
+			it != files.end();
+			++it) {
+		size += it->bytes.size();
+	}
+	return size;
+}
+bool SimpleFileCombiner::add(std::string file, const std::vector<char> &bytes)
+{
+	files.push_back(File(file, std::vector<char>()));
+	files.back().bytes = bytes;
 	return true;
 }
 std::list<std::string> SimpleFileCombiner::read(const char* file, std::string dir)
 {
-	// Start reading
-	std::ifstream ifs(file, std::ios::binary|std::ios::ate);
-	if (!ifs) {
+	// The entries are copied straight out of the mapped file
+	MappedFile input;
+	if (!input.open(file)) {
 		errcode = EERR_IO;
 		return std::list<std::string>();
 	}
+	const char *in = input.data();
+	size_t in_size = input.size();
 
-	std::string start(5, '\0');
-	ifs.seekg(0, std::ios::beg);
-	ifs.read(static_cast<char*>(static_cast<void*>(&start[0])), 5);
-	if (start != "NBEFP") {
+	if (in_size < 6 || memcmp(in, "NBEFP", 5) != 0) {
 		errcode = EERR_WRONG_FILE;
 		return std::list<std::string>();
 	}
 
 	// Read header
-	char amount = 0;
-	ifs.seekg(5, std::ios::beg);
-	ifs.read(&amount, 1);
+	unsigned char amount = (unsigned char)in[5];
 	std::list<std::string> result;
+	data_end = amount * sizeofdef + 6;
+	if (data_end > in_size) {
+		errcode = EERR_WRONG_FILE;
+		return std::list<std::string>();
+	}
 
 	// Loop through files
 	for (int f = 0; f < (int)amount; f++) {
-		std::string name(50, '\0');
-		ifs.seekg(f * sizeofdef + 6, std::ios::beg);
-		ifs.read(static_cast<char*>(static_cast<void*>(&name[0])), 50);
-		name = trim(name);
+		const char *def = in + f * sizeofdef + 6;
+		std::string name = trim(std::string(def, 50));
 		result.push_back(name);
 
-		// Get start location
+		// Get start location and size
 		unsigned int start = 0;
-		ifs.seekg(f * sizeofdef + 56, std::ios::beg);
-		ifs.read(static_cast<char*>(static_cast<void*>(&start)), sizeof(unsigned int));
-
-		// Get size
 		unsigned int size = 0;
-		ifs.seekg(f * sizeofdef + 60, std::ios::beg);
-		ifs.read(static_cast<char*>(static_cast<void*>(&size)), sizeof(unsigned int));
-		std::cerr << "(SFC) Reading " << name.c_str() << ": " << start << " (" << size << ")" << std::endl;
+		memcpy(&start, def + 50, sizeof(unsigned int));
+		memcpy(&size, def + 54, sizeof(unsigned int));
+		NBE_LOG(ELV_VERBOSE, ELC_FILES, "(SFC) Reading " << name << ": " << start << " (" << size << ")");
+
+		// Entries cut short by the end of the file are read as far as they go
+		if (start > in_size)
+			start = size = 0;
+		else if (size > in_size - start)
+			size = in_size - start;
 
-		// Read and save data
-		std::string data(size, '\0');
-		ifs.seekg(start, std::ios::beg);
-		ifs.read(static_cast<char*>(static_cast<void*>(&data[0])), size);
-		std::ofstream output((dir + "/" + name).c_str(), std::ios::binary|std::ios::out);
-		output.write(static_cast<char*>(static_cast<void*>(&data[0])), size);
-		output.close();
+		// Save data, keeping a copy in files
+		if (!dir.empty()) {
+			std::ofstream output((dir + "/" + name).c_str(), std::ios::binary|std::ios::out);
+			if (size > 0)
+				output.write(in + start, size);
+			output.close();
+		}
+		files.push_back(File(name, std::vector<char>()));
+		files.back().bytes.assign(in + start, in + start + size);
+		if (start + size > data_end)
+			data_end = start + size;
 	}
 	return result;
 }
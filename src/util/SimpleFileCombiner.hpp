@@ -18,7 +18,8 @@ public:
 	};
 
 	SimpleFileCombiner():
-		errcode(EERR_NONE)
+		errcode(EERR_NONE),
+		data_end(0)
 	{}
 
 	static const unsigned int sizeofdef = 50 + 2 * sizeof(unsigned int);
@@ -34,8 +35,20 @@ public:
 	std::list<SimpleFileCombiner::File> files;
 	bool write(std::string filename);
 	bool add(const char* readfrom, std::string file);
+	bool add(std::string file, const std::vector<char> &bytes);
+
+	// Reads the files into `files`, also extracting them to dir
+	// unless it is empty
 	std::list<std::string> read(const char* file, std::string dir);
+
+	// Size of the file write() creates
+	size_t getSize() const;
+
 	SimpleFileCombiner::Errors errcode;
+
+	// Set by read() to the end of the last file's data, anything after
+	// it isn't part of the combined files
+	size_t data_end;
 };
 
 #endif
@@ -0,0 +1,120 @@
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(unsigned int count):
+	next_queue(0),
+	queued(0),
+	pending(0),
+	stopping(false)
+{
+	if (count == 0) {
+		count = std::thread::hardware_concurrency();
+		if (count > 0)
+			count--;
+	}
+
+	// The last queue is for tasks added while no worker is free
+	for (unsigned int i = 0; i < count + 1; i++)
+		queues.push_back(new Queue());
+	for (unsigned int i = 0; i < count; i++)
+		threads.push_back(std::thread(&ThreadPool::work, this, i));
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::vector<std::thread>::iterator it = threads.begin();
+			it != threads.end();
+			++it) {
+		it->join();
+	}
+	for (std::vector<Queue*>::iterator it = queues.begin();
+			it != queues.end();
+			++it) {
+		delete *it;
+	}
+}
+
+void ThreadPool::add(Task *task)
+{
+	pending++;
+	Queue *queue = queues[next_queue++ % queues.size()];
+	{
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		queue->tasks.push_back(task);
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queued++;
+	}
+	wake.notify_one();
+}
+
+void ThreadPool::wait()
+{
+	unsigned int own = queues.size() - 1;
+	while (pending > 0) {
+		Task *task = take(own);
+		if (task) {
+			finish(task);
+			continue;
+		}
+
+		// Everything left is running on the workers
+		std::unique_lock<std::mutex> lock(mutex);
+		while (pending > 0 && queued == 0)
+			done.wait(lock);
+	}
+}
+
+ThreadPool::Task *ThreadPool::take(unsigned int queue)
+{
+	// Newest task from our own queue, then the oldest from the others
+	for (unsigned int i = 0; i < queues.size(); i++) {
+		Queue *q = queues[(queue + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(q->mutex);
+		if (q->tasks.empty())
+			continue;
+
+		Task *task;
+		if (i == 0) {
+			task = q->tasks.back();
+			q->tasks.pop_back();
+		} else {
+			task = q->tasks.front();
+			q->tasks.pop_front();
+		}
+		queued--;
+		return task;
+	}
+	return NULL;
+}
+
+void ThreadPool::finish(Task *task)
+{
+	task->run();
+	if (--pending == 0) {
+		std::lock_guard<std::mutex> lock(mutex);
+		done.notify_all();
+	}
+}
+
+void ThreadPool::work(unsigned int queue)
+{
+	while (true) {
+		Task *task = take(queue);
+		if (task) {
+			finish(task);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		while (!stopping && queued == 0)
+			wake.wait(lock);
+		if (stopping)
+			return;
+	}
+}
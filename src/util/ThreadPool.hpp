@@ -0,0 +1,60 @@
+#ifndef THREADPOOL_HPP_INCLUDED
+#define THREADPOOL_HPP_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs tasks on a fixed set of worker threads.
+// Each worker has its own queue, and takes tasks from the others when
+// its own queue is empty.
+class ThreadPool
+{
+public:
+	class Task
+	{
+	public:
+		virtual ~Task() {}
+		virtual void run() = 0;
+	};
+
+	// Uses one thread less than the number of cores if threads is 0, as the
+	// thread calling wait() helps as well.
+	ThreadPool(unsigned int threads = 0);
+	~ThreadPool();
+
+	// The task is not owned by the pool, and must be kept alive until
+	// wait() returns.
+	void add(Task *task);
+
+	// Runs tasks on the calling thread until all added tasks are done.
+	void wait();
+
+	unsigned int getThreadCount() const { return threads.size(); }
+private:
+	class Queue
+	{
+	public:
+		std::mutex mutex;
+		std::deque<Task*> tasks;
+	};
+
+	Task *take(unsigned int queue);
+	void finish(Task *task);
+	void work(unsigned int queue);
+
+	std::vector<std::thread> threads;
+	std::vector<Queue*> queues;
+	unsigned int next_queue;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	std::atomic<unsigned int> queued;
+	std::atomic<unsigned int> pending;
+	bool stopping;
+};
+
+#endif
@@ -1,7 +1,13 @@
 #include "filesys.hpp"
 #include <iostream>
+#include <fstream>
 #include "string.hpp"
+#include "Log.hpp"
 #include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
 
 std::string cleanDirectoryPath(std::string &path)
 {
@@ -27,19 +33,46 @@ std::string getSaveLoadDirectory(std::string save_dir_setting, bool editor_is_in
 	return cleanDirectoryPath(dir);
 }
 
+static std::string tmp_directory_override;
+
+void setTmpDirectory(const std::string &dir)
+{
+	tmp_directory_override = dir;
+}
+
 std::string getTmpDirectory(bool editor_is_installed)
 {
+	if (tmp_directory_override != "")
+		return tmp_directory_override;
+
 #ifndef _WIN32
 	if (editor_is_installed) {
 		std::string res = std::string(getenv("HOME")) + "/.nbetmp/";
-		std::cerr << "Tmpdir requested. Gave " << res.c_str() << std::endl;
+		NBE_LOG(ELV_VERBOSE, ELC_FILES, "Tmpdir requested. Gave " << res);
 		return res;
 	}
 #endif
-	std::cerr << "Tmpdir requested. Gave .tmp/" << std::endl;
+	NBE_LOG(ELV_VERBOSE, ELC_FILES, "Tmpdir requested. Gave .tmp/");
 	return ".tmp/";
 }
 
+std::string getSystemTmpDirectory()
+{
+#ifdef _WIN32
+	char path[MAX_PATH + 1];
+	DWORD len = GetTempPathA(sizeof(path), path);
+	if (len > 0 && len < sizeof(path))
+		return path;
+	return ".\\";
+#else
+	const char *dir = getenv("TMPDIR");
+	if (!dir || dir[0] == '\0')
+		dir = "/tmp";
+	std::string res(dir);
+	return cleanDirectoryPath(res);
+#endif
+}
+
 // This code was nicked from Minetest, subject to LGPLv2
 // See http://minetest.net
 #ifdef _WIN32
@@ -124,7 +157,7 @@ std::vector<std::string> filesInDirectory(std::string path)
 		path = ".";
 	DIR *dirp = opendir(path.c_str());
 	if (!dirp) {
-		std::cerr << "Failed to open directory" << std::endl;
+		NBE_LOG(ELV_WARNING, ELC_FILES, "Failed to open directory '" << path << "'");
 		return std::vector<std::string>();
 	}
 	while (dirent *dp = readdir(dirp)) {
@@ -173,3 +206,27 @@ std::string pathWithoutFilename(std::string path)
 
 	return str_replace(str_replace(path.substr(0, pos), '\\', DIR_DELIM), '/', DIR_DELIM);
 }
+
+size_t FileSize(const std::string &path)
+{
+	std::ifstream file(path.c_str(), std::ios::binary|std::ios::ate);
+	if (!file)
+		return 0;
+	return (size_t)file.tellg();
+}
+
+bool syncFile(const std::string &path, const char *data, size_t size)
+{
+	if (FileSize(path) == size) {
+		std::ifstream file(path.c_str(), std::ios::binary);
+		std::vector<char> old(size);
+		if (size == 0 || (file.read(&old[0], size) && memcmp(&old[0], data, size) == 0))
+			return true;
+	}
+
+	std::ofstream file(path.c_str(), std::ios::binary|std::ios::out|std::ios::trunc);
+	if (!file)
+		return false;
+	file.write(data, size);
+	return file.good();
+}
@@ -15,9 +15,23 @@ std::string cleanDirectoryPath(std::string &path);
 
 std::string getTmpDirectory(bool editor_is_installed);
 
+// Makes getTmpDirectory() return dir instead, for tools that shouldn't
+// write into the working directory. An empty dir restores the default.
+void setTmpDirectory(const std::string &dir);
+
+// The system's directory for temporary files, ending in a delimiter
+std::string getSystemTmpDirectory();
+
 bool FileExists(const char* path);
 bool DirExists(const char* path);
 
+// 0 if the file can't be opened
+size_t FileSize(const std::string &path);
+
+// Writes data to path, unless the file already holds exactly that.
+// Returns false if it couldn't be written.
+bool syncFile(const std::string &path, const char *data, size_t size);
+
 bool CreateDir(std::string path);
 
 std::vector<std::string> filesInDirectory(std::string path);
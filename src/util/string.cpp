@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cctype>
+#include <charconv>
 #include "string.hpp"
 
 std::string trim(const std::string & str)
@@ -33,3 +34,11 @@ std::string str_replace(const std::string & str, char f, char r)
 	std::replace(s.begin(), s.end(), f, r);
 	return s;
 }
+
+
+void append_float(std::string & out, float num)
+{
+	char buf[32];
+	std::to_chars_result res = std::to_chars(buf, buf + sizeof(buf), num);
+	out.append(buf, res.ptr - buf);
+}
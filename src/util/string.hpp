@@ -9,6 +9,9 @@ extern std::string str_to_lower(const std::string & str);
 extern std::wstring narrow_to_wide(const std::string & input);
 extern std::string str_replace(const std::string & str, char f, char r);
 
+// Appends the shortest text that reads back as exactly the same float
+extern void append_float(std::string & out, float num);
+
 
 template<class T>
 const std::string num_to_str(T num)